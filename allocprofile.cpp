@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <vector>
+#include <dlfcn.h>
+#include "allocprofile.hpp"
+#include "objectmodel.hpp"
+#include "inlines.hpp"
+
+namespace sanya {
+
+__thread intptr_t AllocationProfile::countdown_s = INTPTR_MAX;
+
+namespace {
+
+struct Site {
+    Site()
+        : samples(0),
+          survived(0),
+          died(0) { }
+
+    uint64_t samples;
+    uint64_t survived;  // At least one collection
+    uint64_t died;      // Before the first one
+};
+
+// Where the sampled object was allocated, its type is filled in later.
+struct SiteKey {
+    std::string procedure;
+    void *caller;
+    int type;
+
+    bool operator<(const SiteKey &o) const {
+        if (procedure != o.procedure) {
+            return procedure < o.procedure;
+        }
+        if (caller != o.caller) {
+            return caller < o.caller;
+        }
+        return type < o.type;
+    }
+};
+
+// A sampled object, until the collection after its allocation.
+struct Pending {
+    RawObject *object;
+    SiteKey key;
+    uint64_t weight;    // In samples
+};
+
+// Whether the calling thread is the one that is sampled.
+__thread bool sampled_thread_s = false;
+
+size_t sample_bytes_s = 0;
+AllocationProfile::SiteFunction site_function_s = NULL;
+std::vector<Pending> pending_s;
+std::map<SiteKey, Site> sites_s;
+uint64_t collections_s = 0;
+
+const char *TypeName(int type) {
+    switch (type) {
+        case RawObject::kSymbolType:            return "symbol";
+        case RawObject::kPairType:              return "pair";
+        case RawObject::kVectorType:            return "vector";
+        case RawObject::kGrowableVectorType:    return "growable-vector";
+        case RawObject::kDictType:              return "dict";
+        case RawObject::kCellType:              return "cell";
+        case RawObject::kProcedureType:         return "procedure";
+        case RawObject::kClosureType:           return "closure";
+        case RawObject::kNativeType:            return "native";
+        case RawObject::kFlonumType:            return "flonum";
+        case RawObject::kStringType:            return "string";
+        case RawObject::kContinuationType:      return "continuation";
+        case RawObject::kPortType:              return "port";
+        default:                                return "?";
+    }
+}
+
+// As the executable and an offset, for addr2line -f -i -e. The names of
+// the functions are not looked up here, most of them aren't exported.
+std::string CallerName(void *caller) {
+    char text[512];
+    Dl_info info;
+    if (!dladdr(caller, &info) || !info.dli_fname) {
+        snprintf(text, sizeof(text), "%p", caller);
+        return text;
+    }
+    const char *file = strrchr(info.dli_fname, '/');
+    snprintf(text, sizeof(text), "%s+%#lx", file ? file + 1 : info.dli_fname,
+             (unsigned long)((char *)caller - (char *)info.dli_fbase));
+    return text;
+}
+
+// The type of the object is read from where it was allocated, which is
+// still there until the old semispace is cleared.
+void Resolve(const Pending &pending, bool *survived) {
+    SiteKey key = pending.key;
+    key.type = pending.object->object_type();
+    Site &site = sites_s[key];
+    site.samples += pending.weight;
+    if (survived) {
+        (*survived ? site.survived : site.died) += pending.weight;
+    }
+}
+
+}  // namespace
+
+void AllocationProfile::Start(size_t sample_bytes) {
+    sampled_thread_s = true;
+    sample_bytes_s = std::max(sample_bytes, (size_t)1);
+    countdown_s = sample_bytes_s;
+}
+
+void AllocationProfile::Stop() {
+    countdown_s = INTPTR_MAX;
+}
+
+void AllocationProfile::set_site_function(SiteFunction site_function) {
+    site_function_s = site_function;
+}
+
+__attribute__((noinline))
+void AllocationProfile::Sample(RawObject *o) {
+    Pending pending;
+    pending.object = o;
+    pending.key.caller = __builtin_return_address(0);
+    pending.key.type = 0;
+    pending.weight = 0;
+    if (!site_function_s || !site_function_s(&pending.key.procedure)) {
+        pending.key.procedure = "";
+    }
+    // Large objects may stand for more than one sample.
+    while (countdown_s < 0) {
+        countdown_s += sample_bytes_s;
+        ++pending.weight;
+    }
+    pending_s.push_back(pending);
+}
+
+void AllocationProfile::AfterCollection() {
+    if (!sampled_thread_s ||
+            (countdown_s == INTPTR_MAX && pending_s.empty())) {
+        return;
+    }
+    ++collections_s;
+    for (size_t i = 0; i < pending_s.size(); ++i) {
+        RawHeapObject *object = (RawHeapObject *)pending_s[i].object;
+        // Copied objects have their forwarding pointer in self_.
+        bool survived = object->self_ != object;
+        Resolve(pending_s[i], &survived);
+    }
+    pending_s.clear();
+}
+
+void AllocationProfile::Dump(FILE *stream) {
+    // Objects that were allocated after the last collection don't count
+    // towards the survival rates.
+    for (size_t i = 0; i < pending_s.size(); ++i) {
+        Resolve(pending_s[i], NULL);
+    }
+    pending_s.clear();
+
+    std::vector<std::pair<uint64_t, const std::pair<const SiteKey, Site> *> >
+        order;
+    uint64_t total = 0;
+    std::map<SiteKey, Site>::const_iterator it;
+    for (it = sites_s.begin(); it != sites_s.end(); ++it) {
+        order.push_back(std::make_pair(it->second.samples, &*it));
+        total += it->second.samples;
+    }
+    std::sort(order.rbegin(), order.rend());
+
+    fprintf(stream, ";; 1 sample per %zu bytes, %llu samples, "
+            "%llu collections\n", sample_bytes_s, (unsigned long long)total,
+            (unsigned long long)collections_s);
+    fprintf(stream, ";; %12s %6s %9s  %-16s %s\n", "bytes", "%", "survived",
+            "type", "procedure <- allocated in");
+    for (size_t i = 0; i < order.size(); ++i) {
+        const SiteKey &key = order[i].second->first;
+        const Site &site = order[i].second->second;
+        char survived[16] = "-";
+        if (site.survived + site.died) {
+            snprintf(survived, sizeof(survived), "%.1f%%",
+                     100.0 * site.survived / (site.survived + site.died));
+        }
+        fprintf(stream, "%15llu %6.2f %9s  %-16s %s <- %s\n",
+                (unsigned long long)(site.samples * sample_bytes_s),
+                100.0 * site.samples / total, survived, TypeName(key.type),
+                key.procedure.empty() ? "(C++)" : key.procedure.c_str(),
+                CallerName(key.caller).c_str());
+    }
+}
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
@@ -0,0 +1,65 @@
+#ifndef ALLOCPROFILE_HPP
+#define ALLOCPROFILE_HPP
+/**
+ * @file allocprofile.hpp
+ * @brief Tells which allocation sites create the garbage.
+ */
+
+#include <cstdio>
+#include <stdint.h>
+#include <string>
+
+namespace sanya {
+
+class RawObject;
+
+/**
+ * @class AllocationProfile
+ * @brief Samples one allocation every sample_bytes bytes allocated.
+ *
+ * A sample is attributed to the Scheme procedure that was running (see
+ * set_site_function), the C++ code that allocated and the type of the
+ * object. The type is only known once the constructor has run, so it's
+ * read at the next collection, which also tells whether the object
+ * survived. Dump reports the estimated bytes and the survival rate of
+ * every site.
+ */
+class AllocationProfile {
+public:
+    /**
+     * @brief Tells the procedure that is running, returns false outside
+     * of Scheme code.
+     */
+    typedef bool (*SiteFunction)(std::string *site);
+
+    /**
+     * @brief Bytes until the next sample, INTPTR_MAX when stopped. Only
+     * the thread that called Start, and so its isolate, is sampled.
+     */
+    static __thread intptr_t countdown_s;
+
+    static void Start(size_t sample_bytes);
+    static void Stop();
+
+    static void set_site_function(SiteFunction site_function);
+
+    /**
+     * @brief Called by RawObject::operator new once countdown_s goes
+     * below zero. Doesn't allocate on the heap.
+     */
+    static void Sample(RawObject *o);
+
+    /**
+     * @brief Called by the heap when the live objects have been copied,
+     * and before the old semispace is cleared.
+     */
+    static void AfterCollection();
+
+    static void Dump(FILE *stream);
+};
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
+
+#endif /* ALLOCPROFILE_HPP */
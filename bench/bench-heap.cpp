@@ -0,0 +1,110 @@
+#include "bench.hpp"
+#include "heap.hpp"
+#include "isolate.hpp"
+#include "objectmodel.hpp"
+#include "oldspace.hpp"
+#include "inlines.hpp"
+
+using namespace sanya;
+using sanya::bench::State;
+
+namespace {
+
+// The live sets are kept within the default heap.
+const intptr_t kMaxLiveObjects = 8 << 10;
+
+void BM_HeapAlloc(State &state) {
+    // Raw chunks that are never rooted, so collections copy nothing.
+    size_t size = state.range(0);
+    Heap &heap = Heap::Get();
+    while (state.KeepRunning()) {
+        heap.Alloc(size);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_HeapAlloc)->Arg(16)->Arg(64)->Arg(256)->Arg(4096);
+
+void BM_PairWrap(State &state) {
+    Handle car = RawFixnum::Wrap(1);
+    while (state.KeepRunning()) {
+        RawPair::Wrap(car, car);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PairWrap);
+
+RawObject *MakeList(intptr_t length) {
+    Handle list = RawNil::Wrap();
+    Handle item = RawFixnum::Wrap(0);
+    for (intptr_t i = 0; i < length; ++i) {
+        list = RawPair::Wrap(item, list);
+    }
+    return list.raw();
+}
+
+RawObject *MakeVector(intptr_t length) {
+    Handle vec = RawVector::Wrap(length, RawNil::Wrap());
+    Handle item = RawFixnum::Wrap(0);
+    for (intptr_t i = 0; i < length; ++i) {
+        RawPair *pair = RawPair::Wrap(item, item);
+        vec.AsVector().At(i) = pair;
+    }
+    return vec.raw();
+}
+
+RawObject *MakeTree(intptr_t depth) {
+    if (depth == 0) {
+        return RawFixnum::Wrap(0);
+    }
+    Handle left = MakeTree(depth - 1);
+    Handle right = MakeTree(depth - 1);
+    return RawPair::Wrap(left, right);
+}
+
+// Every iteration is one collection of the same live set.
+void CollectLoop(State &state, const Handle &live, intptr_t objects) {
+    Heap &heap = Heap::Get();
+    heap.TriggerCollection();
+    while (state.KeepRunning()) {
+        heap.TriggerCollection();
+    }
+    state.SetItemsProcessed(state.iterations() * objects);
+    state.SetCounter("live_bytes", heap.usage());
+}
+
+void BM_CollectList(State &state) {
+    Handle live = MakeList(state.range(0));
+    CollectLoop(state, live, state.range(0));
+}
+BENCHMARK(BM_CollectList)->Range(8, kMaxLiveObjects);
+
+void BM_CollectVector(State &state) {
+    Handle live = MakeVector(state.range(0));
+    CollectLoop(state, live, state.range(0) + 1);
+}
+BENCHMARK(BM_CollectVector)->Range(8, kMaxLiveObjects);
+
+void BM_CollectTree(State &state) {
+    Handle live = MakeTree(state.range(0));
+    CollectLoop(state, live, ((intptr_t)1 << state.range(0)) - 1);
+}
+BENCHMARK(BM_CollectTree)->Arg(3)->Arg(6)->Arg(9)->Arg(12);
+
+// The same live sets once they are promoted into an old space, which
+// leaves the roots to be scanned, and the slices of the cycles if any.
+void BM_CollectTreeOldSpace(State &state) {
+    Isolate isolate(Heap::kDefaultSize);
+    Isolate::Scope scope(&isolate);
+    Heap &heap = Heap::Get();
+    heap.EnableOldSpace(16 * Heap::MB);
+    Handle live = MakeTree(state.range(0));
+    heap.TriggerCollection();
+    CollectLoop(state, live, ((intptr_t)1 << state.range(0)) - 1);
+    state.SetCounter("old_bytes", heap.old_space()->usage());
+}
+BENCHMARK(BM_CollectTreeOldSpace)->Arg(3)->Arg(6)->Arg(9)->Arg(12);
+
+}  // namespace
+
+// vim: set ts=4 sw=4 sts=4:
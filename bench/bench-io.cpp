@@ -0,0 +1,74 @@
+#include <cstdio>
+#include "bench.hpp"
+#include "isolate.hpp"
+#include "vm-compiler.hpp"
+#include "vm-interp.hpp"
+#include "vm-prelude.hpp"
+#include "sparse/parse_api.h"
+#include "inlines.hpp"
+
+using namespace sanya;
+using sanya::bench::State;
+
+namespace {
+
+const intptr_t kRoundTrips = 100;
+
+// range(0) connections over loopback, each a task on either side, with
+// kRoundTrips lines echoed on each.
+void BM_EchoRoundTrip(State &state) {
+    char program[2048];
+    snprintf(program, sizeof(program),
+        "(define clients %ld)"
+        "(define done 0)"
+        "(define listener (tcp-listen 47231))"
+        "(define (serve conn)"
+        "  (lambda ()"
+        "    (let loop ()"
+        "      (let ((line (read-line conn)))"
+        "        (if (eof-object? line)"
+        "            (close-port conn)"
+        "            (begin (write-string line conn)"
+        "                   (write-string \"\\n\" conn)"
+        "                   (flush-output-port conn)"
+        "                   (loop)))))))"
+        "(spawn (lambda ()"
+        "  (let loop ((i 0))"
+        "    (if (< i clients)"
+        "        (begin (spawn (serve (tcp-accept listener)))"
+        "               (loop (+ i 1)))))))"
+        "(define (client)"
+        "  (let ((conn (tcp-connect \"127.0.0.1\" 47231)))"
+        "    (let loop ((i 0))"
+        "      (if (< i %ld)"
+        "          (begin (write-string \"ping\\n\" conn)"
+        "                 (flush-output-port conn)"
+        "                 (read-line conn)"
+        "                 (loop (+ i 1)))))"
+        "    (close-port conn)"
+        "    (set! done (+ done 1))))"
+        "(let loop ((i 0))"
+        "  (if (< i clients) (begin (spawn client) (loop (+ i 1)))))"
+        "(let wait () (if (< done clients) (begin (yield) (wait))))"
+        "(close-port listener)",
+        (long)state.range(0), (long)kRoundTrips);
+
+    Isolate isolate(16 * Heap::MB);
+    Isolate::Scope scope(&isolate);
+    vm_prelude::Install();
+    {
+        vm_interp::Interp interp;
+        Handle expr = sparse_do_string(program);
+        Handle closure = vm_compiler::Compile(expr);
+        while (state.KeepRunning()) {
+            interp.Run(closure);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) *
+                            kRoundTrips);
+}
+BENCHMARK(BM_EchoRoundTrip)->Arg(1)->Arg(16)->Arg(256);
+
+}  // namespace
+
+// vim: set ts=4 sw=4 sts=4:
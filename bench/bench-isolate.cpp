@@ -0,0 +1,131 @@
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <pthread.h>
+#include "bench.hpp"
+#include "channel.hpp"
+#include "isolate.hpp"
+#include "sharedspace.hpp"
+#include "vm-compiler.hpp"
+#include "vm-interp.hpp"
+#include "vm-prelude.hpp"
+#include "sparse/parse_api.h"
+#include "inlines.hpp"
+
+using namespace sanya;
+using sanya::bench::State;
+
+namespace {
+
+const char *kProgram =
+    "(define (fib n) (if (< n 2) n (+ (fib (- n 1)) (fib (- n 2)))))"
+    "(fib 20)";
+
+// A whole interpreter: a new isolate with the prelude, running kProgram.
+void *RunIsolate(void *) {
+    Isolate isolate(Heap::kDefaultSize);
+    Isolate::Scope scope(&isolate);
+    vm_prelude::Install();
+    {
+        vm_interp::Interp interp;
+        Handle expr = sparse_do_string(kProgram);
+        Handle closure = vm_compiler::Compile(expr);
+        interp.Run(closure);
+    }
+    return NULL;
+}
+
+// With range(0) threads, the time stays the same as long as there are
+// enough cores.
+void BM_IsolatesParallel(State &state) {
+    std::vector<pthread_t> threads(state.range(0));
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < threads.size(); ++i) {
+            pthread_create(&threads[i], NULL, RunIsolate, NULL);
+        }
+        for (size_t i = 0; i < threads.size(); ++i) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * threads.size());
+}
+BENCHMARK(BM_IsolatesParallel)->Arg(1)->Arg(2)->Arg(4);
+
+// A list of (symbol "string" flonum fixnum), with 64 characters in each
+// string.
+RawObject *MakeRecords(intptr_t count, bool shared) {
+    Handle records = RawNil::Wrap();
+    for (intptr_t i = 0; i < count; ++i) {
+        char text[65];
+        snprintf(text, sizeof(text), "%-64ld", (long)i);
+        Handle str = RawString::Wrap(text, 64);
+        if (shared) {
+            str = SharedSpace::Share(str);
+        }
+        Handle record = RawPair::Wrap(RawFixnum::Wrap(i), RawNil::Wrap());
+        record = RawPair::Wrap(RawFlonum::Wrap(i + 0.5), record);
+        record = RawPair::Wrap(str, record);
+        Handle symbol = ObjSpace::Get().InternSymbol("record");
+        record = RawPair::Wrap(symbol, record);
+        records = RawPair::Wrap(record, records);
+    }
+    return records.raw();
+}
+
+// From one isolate to another through a channel, on the same thread.
+void ChannelTransfer(State &state, bool shared) {
+    Isolate sender(Heap::kDefaultSize);
+    Isolate receiver(Heap::kDefaultSize);
+    Channel channel;
+    size_t bytes = 0;
+    {
+        Isolate::Scope scope(&sender);
+        Handle records = MakeRecords(state.range(0), shared);
+        while (state.KeepRunning()) {
+            channel.Send(records);
+            Isolate::Scope scope(&receiver);
+            channel.Receive();
+        }
+        Message *message = Message::Write(records.raw());
+        bytes = message->size();
+        delete message;
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetCounter("copied_bytes", bytes);
+}
+
+void BM_ChannelTransfer(State &state) {
+    ChannelTransfer(state, false);
+}
+BENCHMARK(BM_ChannelTransfer)->Arg(16)->Arg(256)->Arg(1024);
+
+void BM_ChannelTransferShared(State &state) {
+    ChannelTransfer(state, true);
+}
+BENCHMARK(BM_ChannelTransferShared)->Arg(16)->Arg(256)->Arg(1024);
+
+// The same as text, written by one isolate and read by the other.
+void BM_TextTransfer(State &state) {
+    Isolate sender(Heap::kDefaultSize);
+    Isolate receiver(Heap::kDefaultSize);
+    {
+        Isolate::Scope scope(&sender);
+        Handle records = MakeRecords(state.range(0), false);
+        while (state.KeepRunning()) {
+            char *text = NULL;
+            size_t length = 0;
+            FILE *stream = open_memstream(&text, &length);
+            records.raw()->Write(stream);
+            fclose(stream);
+            Isolate::Scope scope(&receiver);
+            sparse_do_string(text);
+            free(text);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TextTransfer)->Arg(16)->Arg(256)->Arg(1024);
+
+}  // namespace
+
+// vim: set ts=4 sw=4 sts=4:
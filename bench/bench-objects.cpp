@@ -0,0 +1,126 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "bench.hpp"
+#include "objectmodel.hpp"
+#include "objspace.hpp"
+#include "inlines.hpp"
+
+using namespace sanya;
+using sanya::bench::State;
+
+namespace {
+
+std::vector<std::string> MakeNames(const char *prefix, intptr_t count) {
+    std::vector<std::string> names;
+    for (intptr_t i = 0; i < count; ++i) {
+        char name[64];
+        snprintf(name, sizeof(name), "%s-%ld", prefix, (long)i);
+        names.push_back(name);
+    }
+    return names;
+}
+
+// Symbols that are not interned, so the benchmarks don't share them.
+std::vector<Handle> MakeSymbols(const char *prefix, intptr_t count) {
+    std::vector<std::string> names = MakeNames(prefix, count);
+    std::vector<Handle> symbols;
+    for (intptr_t i = 0; i < count; ++i) {
+        symbols.push_back(RawSymbol::Wrap(names[i].c_str()));
+    }
+    return symbols;
+}
+
+RawDict *MakeDict(const std::vector<Handle> &keys) {
+    Handle dict = RawDict::Wrap();
+    for (size_t i = 0; i < keys.size(); ++i) {
+        dict.AsDict().LookupSymbol(keys[i], RawDict::kCreateOnAbsent);
+    }
+    return &dict.AsDict();
+}
+
+void BM_DictLookupHit(State &state) {
+    std::vector<Handle> keys = MakeSymbols("hit", state.range(0));
+    Handle dict = MakeDict(keys);
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        dict.AsDict().LookupSymbol(keys[i], RawDict::kLookupDefault);
+        i = i + 1 == keys.size() ? 0 : i + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DictLookupHit)->Range(8, 4 << 10);
+
+void BM_DictLookupMiss(State &state) {
+    std::vector<Handle> keys = MakeSymbols("hit", state.range(0));
+    std::vector<Handle> misses = MakeSymbols("miss", state.range(0));
+    Handle dict = MakeDict(keys);
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        dict.AsDict().LookupSymbol(misses[i], RawDict::kLookupDefault);
+        i = i + 1 == misses.size() ? 0 : i + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DictLookupMiss)->Range(8, 4 << 10);
+
+void BM_DictInsert(State &state) {
+    // Every iteration fills a new dict, resizes included.
+    std::vector<Handle> keys = MakeSymbols("insert", state.range(0));
+    Handle dict = RawNil::Wrap();
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        dict = RawDict::Wrap();
+        state.ResumeTiming();
+        for (size_t i = 0; i < keys.size(); ++i) {
+            dict.AsDict().LookupSymbol(keys[i], RawDict::kCreateOnAbsent);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_DictInsert)->Range(8, 4 << 10);
+
+void BM_InternSymbol(State &state) {
+    // Symbols that are already interned, which is the common case.
+    std::vector<std::string> names = MakeNames("intern", state.range(0));
+    for (size_t i = 0; i < names.size(); ++i) {
+        ObjSpace::Get().InternSymbol(names[i].c_str());
+    }
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        ObjSpace::Get().InternSymbol(names[i].c_str(), names[i].size());
+        i = i + 1 == names.size() ? 0 : i + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_InternSymbol)->Range(8, 4 << 10);
+
+void BM_HandleCreateDestroy(State &state) {
+    Handle outer = RawNil::Wrap();
+    while (state.KeepRunning()) {
+        Handle inner = outer;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HandleCreateDestroy);
+
+void BM_GrowableVectorAppend(State &state) {
+    // Every iteration appends to a new vector, resizes included.
+    Handle item = RawFixnum::Wrap(0);
+    Handle vec = RawNil::Wrap();
+    intptr_t length = state.range(0);
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        vec = RawGrowableVector::Wrap();
+        state.ResumeTiming();
+        for (intptr_t i = 0; i < length; ++i) {
+            vec.AsGrowableVector().Append(item);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * length);
+}
+BENCHMARK(BM_GrowableVectorAppend)->Range(8, 4 << 10);
+
+}  // namespace
+
+// vim: set ts=4 sw=4 sts=4:
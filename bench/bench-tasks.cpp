@@ -0,0 +1,79 @@
+#include <cstdio>
+#include "bench.hpp"
+#include "isolate.hpp"
+#include "vm-compiler.hpp"
+#include "vm-interp.hpp"
+#include "vm-prelude.hpp"
+#include "sparse/parse_api.h"
+#include "inlines.hpp"
+
+using namespace sanya;
+using sanya::bench::State;
+
+namespace {
+
+const intptr_t kYields = 10;
+
+// range(0) tasks that yield kYields times each, with the one that spawns
+// them waiting for them to be done.
+void BM_TaskSwitch(State &state) {
+    char program[1024];
+    snprintf(program, sizeof(program),
+        "(define done 0)"
+        "(define (task)"
+        "  (let loop ((i 0))"
+        "    (if (< i %ld) (begin (yield) (loop (+ i 1)))"
+        "        (set! done (+ done 1)))))"
+        "(let loop ((i 0))"
+        "  (if (< i %ld) (begin (spawn task) (loop (+ i 1)))))"
+        "(let wait () (if (< done %ld) (begin (yield) (wait))))",
+        (long)kYields, (long)state.range(0), (long)state.range(0));
+
+    Isolate isolate(64 * Heap::MB);
+    Isolate::Scope scope(&isolate);
+    vm_prelude::Install();
+    {
+        vm_interp::Interp interp;
+        Handle expr = sparse_do_string(program);
+        Handle closure = vm_compiler::Compile(expr);
+        while (state.KeepRunning()) {
+            interp.Run(closure);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * kYields);
+}
+BENCHMARK(BM_TaskSwitch)->Arg(1)->Arg(100)->Arg(10000);
+
+// Escaping from a loop through call/cc.
+void BM_CallCCEscape(State &state) {
+    const char *program =
+        "(define (find-first pred lst)"
+        "  (call/cc (lambda (return)"
+        "    (let loop ((l lst))"
+        "      (if (null? l) #f"
+        "          (begin (if (pred (car l)) (return (car l)))"
+        "                 (loop (cdr l))))))))"
+        "(define lst (list 1 2 3 4 5 6 7 8))"
+        "(let loop ((i 0))"
+        "  (if (< i 1000)"
+        "      (begin (find-first (lambda (x) (> x 4)) lst)"
+        "             (loop (+ i 1)))))";
+
+    Isolate isolate(Heap::kDefaultSize);
+    Isolate::Scope scope(&isolate);
+    vm_prelude::Install();
+    {
+        vm_interp::Interp interp;
+        Handle expr = sparse_do_string(program);
+        Handle closure = vm_compiler::Compile(expr);
+        while (state.KeepRunning()) {
+            interp.Run(closure);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 1000);
+}
+BENCHMARK(BM_CallCCEscape);
+
+}  // namespace
+
+// vim: set ts=4 sw=4 sts=4:
@@ -0,0 +1,320 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <regex.h>
+#include <unistd.h>
+#include "bench.hpp"
+
+namespace sanya {
+
+namespace bench {
+
+namespace {
+
+const size_t kMaxIterations = 1000000000;
+
+double Now(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+std::vector<Benchmark *> &Registry() {
+    static std::vector<Benchmark *> benchmarks;
+    return benchmarks;
+}
+
+struct Options {
+    Options()
+        : filter("."),
+          json(false),
+          min_time(0.5),
+          out(NULL) { }
+
+    const char *filter;
+    bool json;
+    double min_time;    // In seconds
+    const char *out;
+};
+
+struct Result {
+    std::string name;
+    size_t iterations;
+    double real_time;   // Per iteration, in ns
+    double cpu_time;
+    double items_per_second;
+    double bytes_per_second;
+    std::vector<std::pair<std::string, double> > counters;
+};
+
+bool ParseFlag(const char *arg, const char *name, const char **value) {
+    size_t length = strlen(name);
+    if (strncmp(arg, name, length) != 0 || arg[length] != '=') {
+        return false;
+    }
+    *value = arg + length + 1;
+    return true;
+}
+
+bool ParseOptions(int argc, const char *argv[], Options *options) {
+    for (int i = 1; i < argc; ++i) {
+        const char *value;
+        if (ParseFlag(argv[i], "--benchmark_filter", &value)) {
+            options->filter = value;
+        }
+        else if (ParseFlag(argv[i], "--benchmark_format", &value)) {
+            if (strcmp(value, "json") != 0 && strcmp(value, "console") != 0) {
+                fprintf(stderr, "unknown format: %s\n", value);
+                return false;
+            }
+            options->json = strcmp(value, "json") == 0;
+        }
+        else if (ParseFlag(argv[i], "--benchmark_min_time", &value)) {
+            options->min_time = atof(value);
+        }
+        else if (ParseFlag(argv[i], "--benchmark_out", &value)) {
+            options->out = value;
+        }
+        else {
+            fprintf(stderr, "usage: %s [--benchmark_filter=<regex>] "
+                    "[--benchmark_format=console|json] "
+                    "[--benchmark_min_time=<seconds>] "
+                    "[--benchmark_out=<file.json>]\n", argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Like Google Benchmark, the iterations grow until the run takes
+// min_time.
+Result Run(Benchmark *benchmark, intptr_t arg, bool has_arg,
+           double min_time) {
+    size_t iterations = 1;
+    while (true) {
+        State state(iterations, arg);
+        benchmark->function()(state);
+        double elapsed = state.real_time();
+        if (elapsed >= min_time || iterations >= kMaxIterations) {
+            Result result;
+            char suffix[32] = "";
+            if (has_arg) {
+                snprintf(suffix, sizeof(suffix), "/%ld", (long)arg);
+            }
+            result.name = benchmark->name() + suffix;
+            result.iterations = iterations;
+            result.real_time = state.real_time() * 1e9 / iterations;
+            result.cpu_time = state.cpu_time() * 1e9 / iterations;
+            result.items_per_second = state.cpu_time() > 0 ?
+                state.items() / state.cpu_time() : 0;
+            result.bytes_per_second = state.cpu_time() > 0 ?
+                state.bytes() / state.cpu_time() : 0;
+            result.counters = state.counters();
+            return result;
+        }
+        double multiplier = elapsed > 0 ? min_time * 1.4 / elapsed : 10;
+        multiplier = std::min(std::max(multiplier, 2.0), 10.0);
+        iterations = std::min((size_t)(iterations * multiplier),
+                              kMaxIterations);
+    }
+}
+
+void PrintConsole(FILE *stream, const Result &result) {
+    fprintf(stream, "%-36s %12.1f ns %12.1f ns %12zu",
+            result.name.c_str(), result.real_time, result.cpu_time,
+            result.iterations);
+    if (result.items_per_second > 0) {
+        fprintf(stream, " items/s=%.4g", result.items_per_second);
+    }
+    if (result.bytes_per_second > 0) {
+        fprintf(stream, " bytes/s=%.4g", result.bytes_per_second);
+    }
+    for (size_t i = 0; i < result.counters.size(); ++i) {
+        fprintf(stream, " %s=%.4g", result.counters[i].first.c_str(),
+                result.counters[i].second);
+    }
+    fprintf(stream, "\n");
+}
+
+void PrintJson(FILE *stream, const char *executable,
+               const std::vector<Result> &results) {
+    char host[256] = "";
+    gethostname(host, sizeof(host) - 1);
+    char date[64] = "";
+    time_t now = time(NULL);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", localtime(&now));
+
+    // Benchmark names have no characters that need escaping.
+    fprintf(stream, "{\n");
+    fprintf(stream, "  \"context\": {\n");
+    fprintf(stream, "    \"date\": \"%s\",\n", date);
+    fprintf(stream, "    \"host_name\": \"%s\",\n", host);
+    fprintf(stream, "    \"executable\": \"%s\",\n", executable);
+    fprintf(stream, "    \"num_cpus\": %ld,\n", sysconf(_SC_NPROCESSORS_ONLN));
+    fprintf(stream, "    \"library_build_type\": \"release\"\n");
+    fprintf(stream, "  },\n");
+    fprintf(stream, "  \"benchmarks\": [");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result &result = results[i];
+        fprintf(stream, "%s\n    {\n", i ? "," : "");
+        fprintf(stream, "      \"name\": \"%s\",\n", result.name.c_str());
+        fprintf(stream, "      \"run_name\": \"%s\",\n", result.name.c_str());
+        fprintf(stream, "      \"run_type\": \"iteration\",\n");
+        fprintf(stream, "      \"iterations\": %zu,\n", result.iterations);
+        fprintf(stream, "      \"real_time\": %.6g,\n", result.real_time);
+        fprintf(stream, "      \"cpu_time\": %.6g,\n", result.cpu_time);
+        if (result.items_per_second > 0) {
+            fprintf(stream, "      \"items_per_second\": %.6g,\n",
+                    result.items_per_second);
+        }
+        if (result.bytes_per_second > 0) {
+            fprintf(stream, "      \"bytes_per_second\": %.6g,\n",
+                    result.bytes_per_second);
+        }
+        for (size_t j = 0; j < result.counters.size(); ++j) {
+            fprintf(stream, "      \"%s\": %.6g,\n",
+                    result.counters[j].first.c_str(),
+                    result.counters[j].second);
+        }
+        fprintf(stream, "      \"time_unit\": \"ns\"\n");
+        fprintf(stream, "    }");
+    }
+    fprintf(stream, "\n  ]\n}\n");
+}
+
+}  // namespace
+
+State::State(size_t max_iterations, intptr_t arg)
+    : iterations_left_(max_iterations),
+      max_iterations_(max_iterations),
+      arg_(arg),
+      started_(false),
+      real_start_(0),
+      cpu_start_(0),
+      real_time_(0),
+      cpu_time_(0),
+      items_(0),
+      bytes_(0) { }
+
+bool State::KeepRunning() {
+    if (!started_) {
+        started_ = true;
+        ResumeTiming();
+    }
+    if (iterations_left_ == 0) {
+        PauseTiming();
+        return false;
+    }
+    --iterations_left_;
+    return true;
+}
+
+void State::PauseTiming() {
+    real_time_ += Now(CLOCK_MONOTONIC) - real_start_;
+    cpu_time_ += Now(CLOCK_PROCESS_CPUTIME_ID) - cpu_start_;
+}
+
+void State::ResumeTiming() {
+    real_start_ = Now(CLOCK_MONOTONIC);
+    cpu_start_ = Now(CLOCK_PROCESS_CPUTIME_ID);
+}
+
+void State::SetCounter(const std::string &name, double value) {
+    for (size_t i = 0; i < counters_.size(); ++i) {
+        if (counters_[i].first == name) {
+            counters_[i].second = value;
+            return;
+        }
+    }
+    counters_.push_back(std::make_pair(name, value));
+}
+
+Benchmark::Benchmark(const char *name, Function fn)
+    : name_(name),
+      fn_(fn) { }
+
+Benchmark *Benchmark::Arg(intptr_t arg) {
+    args_.push_back(arg);
+    return this;
+}
+
+Benchmark *Benchmark::Range(intptr_t lo, intptr_t hi) {
+    args_.push_back(lo);
+    for (intptr_t arg = 8; arg < hi; arg *= 8) {
+        if (arg > lo) {
+            args_.push_back(arg);
+        }
+    }
+    if (hi != lo) {
+        args_.push_back(hi);
+    }
+    return this;
+}
+
+Benchmark *Register(const char *name, Function fn) {
+    Registry().push_back(new Benchmark(name, fn));
+    return Registry().back();
+}
+
+int RunAll(int argc, const char *argv[]) {
+    Options options;
+    if (!ParseOptions(argc, argv, &options)) {
+        return 1;
+    }
+    regex_t filter;
+    if (regcomp(&filter, options.filter, REG_EXTENDED | REG_NOSUB) != 0) {
+        fprintf(stderr, "bad filter: %s\n", options.filter);
+        return 1;
+    }
+
+    FILE *console = options.json ? stderr : stdout;
+    std::vector<Result> results;
+    const std::vector<Benchmark *> &benchmarks = Registry();
+    for (size_t i = 0; i < benchmarks.size(); ++i) {
+        Benchmark *benchmark = benchmarks[i];
+        std::vector<intptr_t> args = benchmark->args();
+        bool has_args = !args.empty();
+        if (!has_args) {
+            args.push_back(0);
+        }
+        for (size_t j = 0; j < args.size(); ++j) {
+            char name[256];
+            snprintf(name, sizeof(name), has_args ? "%s/%ld" : "%s",
+                     benchmark->name().c_str(), (long)args[j]);
+            if (regexec(&filter, name, 0, NULL, 0) != 0) {
+                continue;
+            }
+            results.push_back(Run(benchmark, args[j], has_args,
+                                  options.min_time));
+            PrintConsole(console, results.back());
+            fflush(console);
+        }
+    }
+    regfree(&filter);
+
+    if (options.json) {
+        PrintJson(stdout, argv[0], results);
+    }
+    if (options.out) {
+        FILE *out = fopen(options.out, "w");
+        if (!out) {
+            perror(options.out);
+            return 1;
+        }
+        PrintJson(out, argv[0], results);
+        fclose(out);
+    }
+    return 0;
+}
+
+}  // namespace bench
+
+}  // namespace sanya
+
+int main(int argc, const char *argv[]) {
+    return sanya::bench::RunAll(argc, argv);
+}
+
+// vim: set ts=4 sw=4 sts=4:
@@ -0,0 +1,111 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+/**
+ * @file bench.hpp
+ * @brief A small harness in the style of Google Benchmark, so that the
+ * results can be tracked with the same tools.
+ *
+ * A benchmark is a function that runs its body while state.KeepRunning()
+ * is true. It's registered with BENCHMARK(fn), optionally followed by
+ * ->Arg(n) or ->Range(lo, hi), and runs once for each argument.
+ */
+
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sanya {
+
+namespace bench {
+
+class State {
+public:
+    State(size_t max_iterations, intptr_t arg);
+
+    /** @brief The timer starts on the first call and stops on the last. */
+    bool KeepRunning();
+
+    /** @brief The argument this run was registered with. */
+    intptr_t range(int i = 0) const { return arg_; }
+    size_t iterations() const { return max_iterations_; }
+
+    /** @brief Setup inside the loop doesn't count when paused. */
+    void PauseTiming();
+    void ResumeTiming();
+
+    void SetItemsProcessed(int64_t items) { items_ = items; }
+    void SetBytesProcessed(int64_t bytes) { bytes_ = bytes; }
+
+    /** @brief Reported as is, e.g. the size of the live set. */
+    void SetCounter(const std::string &name, double value);
+
+    double real_time() const { return real_time_; }
+    double cpu_time() const { return cpu_time_; }
+    int64_t items() const { return items_; }
+    int64_t bytes() const { return bytes_; }
+    const std::vector<std::pair<std::string, double> > &counters() const {
+        return counters_;
+    }
+
+private:
+    size_t iterations_left_;
+    size_t max_iterations_;
+    intptr_t arg_;
+    bool started_;
+
+    // In seconds.
+    double real_start_;
+    double cpu_start_;
+    double real_time_;
+    double cpu_time_;
+
+    int64_t items_;
+    int64_t bytes_;
+    std::vector<std::pair<std::string, double> > counters_;
+};
+
+typedef void (*Function)(State &);
+
+class Benchmark {
+public:
+    Benchmark(const char *name, Function fn);
+
+    Benchmark *Arg(intptr_t arg);
+
+    /** @brief lo, hi and the powers of 8 in between. */
+    Benchmark *Range(intptr_t lo, intptr_t hi);
+
+    const std::string &name() const { return name_; }
+    Function function() const { return fn_; }
+    const std::vector<intptr_t> &args() const { return args_; }
+
+private:
+    std::string name_;
+    Function fn_;
+    std::vector<intptr_t> args_;
+};
+
+/** @brief Registers the benchmark, it's run by RunAll. */
+Benchmark *Register(const char *name, Function fn);
+
+/**
+ * @brief Parse the --benchmark_* flags and run the benchmarks that
+ * match. Returns the exit status.
+ */
+int RunAll(int argc, const char *argv[]);
+
+}  // namespace bench
+
+}  // namespace sanya
+
+#define BENCHMARK_CONCAT_(a, b) a ## b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_(a, b)
+
+#define BENCHMARK(fn) \
+    static sanya::bench::Benchmark *BENCHMARK_CONCAT(bench_, __LINE__) = \
+        sanya::bench::Register(#fn, fn)
+
+// vim: set ts=4 sw=4 sts=4:
+
+#endif /* BENCH_HPP */
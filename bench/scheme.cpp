@@ -0,0 +1,337 @@
+/**
+ * @file scheme.cpp
+ * @brief Runs the Scheme programs in bench/scheme/ and compares them
+ * against a baseline.
+ *
+ * Every run is a fresh process, forked before anything is allocated,
+ * that goes through the same read, compile and run steps as main-c (the
+ * .scmc images are not used, so reading is measured too). The wall time,
+ * the peak RSS and the number of collections are recorded.
+ *
+ * With --save-baseline=FILE the results are written out, and with
+ * --baseline=FILE any of them that got worse by more than --threshold
+ * percent fails the run, with a nonzero exit status.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "heap.hpp"
+#include "objectmodel.hpp"
+#include "vm-compiler.hpp"
+#include "vm-interp.hpp"
+#include "vm-prelude.hpp"
+#include "sparse/parse_api.h"
+#include "inlines.hpp"
+
+using namespace sanya;
+
+namespace {
+
+const char *kCorpusDir = "bench/scheme";
+
+struct Options {
+    Options()
+        : runs(5),
+          threshold(10),
+          baseline(NULL),
+          save_baseline(NULL) { }
+
+    int runs;
+    double threshold;       // In percent
+    const char *baseline;
+    const char *save_baseline;
+    std::vector<std::string> files;
+};
+
+struct Measurement {
+    Measurement()
+        : ok(false),
+          wall_ms(0),
+          min_ms(0),
+          peak_rss_kb(0),
+          collections(0) { }
+
+    bool ok;
+    double wall_ms;         // The median of the runs
+    double min_ms;
+    long peak_rss_kb;
+    long collections;
+};
+
+double Now() {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1e3 + tv.tv_usec * 1e-3;
+}
+
+std::string BaseName(const std::string &path) {
+    size_t slash = path.rfind('/');
+    std::string name = slash == std::string::npos ? path
+                                                  : path.substr(slash + 1);
+    size_t dot = name.rfind('.');
+    return dot == std::string::npos ? name : name.substr(0, dot);
+}
+
+bool ParseFlag(const char *arg, const char *name, const char **value) {
+    size_t length = strlen(name);
+    if (strncmp(arg, name, length) != 0 || arg[length] != '=') {
+        return false;
+    }
+    *value = arg + length + 1;
+    return true;
+}
+
+bool ParseOptions(int argc, const char *argv[], Options *options) {
+    for (int i = 1; i < argc; ++i) {
+        const char *value;
+        if (ParseFlag(argv[i], "--runs", &value) && atoi(value) > 0) {
+            options->runs = atoi(value);
+        }
+        else if (ParseFlag(argv[i], "--threshold", &value)) {
+            options->threshold = atof(value);
+        }
+        else if (ParseFlag(argv[i], "--baseline", &value)) {
+            options->baseline = value;
+        }
+        else if (ParseFlag(argv[i], "--save-baseline", &value)) {
+            options->save_baseline = value;
+        }
+        else if (argv[i][0] != '-') {
+            options->files.push_back(argv[i]);
+        }
+        else {
+            fprintf(stderr, "usage: %s [--runs=N] [--threshold=PERCENT] "
+                    "[--baseline=FILE] [--save-baseline=FILE] "
+                    "[FILE.scm...]\n", argv[0]);
+            return false;
+        }
+    }
+
+    if (options->files.empty()) {
+        DIR *dir = opendir(kCorpusDir);
+        if (!dir) {
+            perror(kCorpusDir);
+            return false;
+        }
+        while (struct dirent *entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name.size() > 4 &&
+                    name.compare(name.size() - 4, 4, ".scm") == 0) {
+                options->files.push_back(std::string(kCorpusDir) + "/" +
+                                         name);
+            }
+        }
+        closedir(dir);
+        std::sort(options->files.begin(), options->files.end());
+    }
+    return true;
+}
+
+// In the child: the same steps as main-c, then the number of collections
+// goes back through fd.
+void RunChild(const char *path, int fd) {
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (null_fd >= 0) {
+        dup2(null_fd, STDOUT_FILENO);
+        close(null_fd);
+    }
+
+    vm_prelude::Install();
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        perror(path);
+        _exit(1);
+    }
+    Handle expr = sparse_do_file(fp);
+    fclose(fp);
+    if (!expr.raw()) {
+        _exit(1);
+    }
+    Handle closure = vm_compiler::Compile(expr);
+    vm_interp::Interp interp;
+    interp.Run(closure);
+    fflush(stdout);
+
+    long collections = Heap::Get().collections();
+    if (write(fd, &collections, sizeof(collections)) !=
+            sizeof(collections)) {
+        _exit(1);
+    }
+    _exit(0);
+}
+
+bool RunOnce(const char *path, double *wall_ms, long *peak_rss_kb,
+             long *collections) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        perror("pipe");
+        return false;
+    }
+    double start = Now();
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return false;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        RunChild(path, fds[1]);
+    }
+    close(fds[1]);
+
+    int status;
+    struct rusage usage;
+    ssize_t got = read(fds[0], collections, sizeof(*collections));
+    close(fds[0]);
+    while (wait4(pid, &status, 0, &usage) < 0 && errno == EINTR) {
+    }
+    *wall_ms = Now() - start;
+    *peak_rss_kb = usage.ru_maxrss;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0 &&
+        got == sizeof(*collections);
+}
+
+Measurement Measure(const char *path, int runs) {
+    Measurement result;
+    std::vector<double> times;
+    for (int i = 0; i < runs; ++i) {
+        double wall_ms;
+        long peak_rss_kb;
+        long collections;
+        if (!RunOnce(path, &wall_ms, &peak_rss_kb, &collections)) {
+            return result;
+        }
+        times.push_back(wall_ms);
+        result.peak_rss_kb = std::max(result.peak_rss_kb, peak_rss_kb);
+        result.collections = collections;
+    }
+    std::sort(times.begin(), times.end());
+    result.ok = true;
+    result.wall_ms = times[times.size() / 2];
+    result.min_ms = times[0];
+    return result;
+}
+
+// One line per benchmark: name wall_ms peak_rss_kb collections.
+bool LoadBaseline(const char *path,
+                  std::map<std::string, Measurement> *baseline) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        perror(path);
+        return false;
+    }
+    char line[512];
+    while (fgets(line, sizeof(line), fp)) {
+        char name[256];
+        Measurement m;
+        if (line[0] == '#' ||
+                sscanf(line, "%255s %lf %ld %ld", name, &m.wall_ms,
+                       &m.peak_rss_kb, &m.collections) != 4) {
+            continue;
+        }
+        m.ok = true;
+        (*baseline)[name] = m;
+    }
+    fclose(fp);
+    return true;
+}
+
+bool SaveBaseline(const char *path, const std::vector<std::string> &names,
+                  const std::vector<Measurement> &results) {
+    FILE *fp = fopen(path, "w");
+    if (!fp) {
+        perror(path);
+        return false;
+    }
+    fprintf(fp, "# name wall_ms peak_rss_kb collections\n");
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (results[i].ok) {
+            fprintf(fp, "%s %.3f %ld %ld\n", names[i].c_str(),
+                    results[i].wall_ms, results[i].peak_rss_kb,
+                    results[i].collections);
+        }
+    }
+    fclose(fp);
+    return true;
+}
+
+bool WithinThreshold(double value, double base, double threshold) {
+    return value <= base * (1 + threshold / 100);
+}
+
+}  // namespace
+
+int main(int argc, const char *argv[]) {
+    Options options;
+    if (!ParseOptions(argc, argv, &options)) {
+        return 2;
+    }
+    std::map<std::string, Measurement> baseline;
+    if (options.baseline && !LoadBaseline(options.baseline, &baseline)) {
+        return 2;
+    }
+
+    printf("%-12s %10s %10s %10s %8s %10s %8s  %s\n", "benchmark",
+           "median ms", "min ms", "rss KB", "gcs", "base ms", "change",
+           "result");
+    bool passed = true;
+    std::vector<std::string> names;
+    std::vector<Measurement> results;
+    for (size_t i = 0; i < options.files.size(); ++i) {
+        std::string name = BaseName(options.files[i]);
+        Measurement m = Measure(options.files[i].c_str(), options.runs);
+        names.push_back(name);
+        results.push_back(m);
+        if (!m.ok) {
+            printf("%-12s %s\n", name.c_str(), "FAILED to run");
+            passed = false;
+            continue;
+        }
+
+        printf("%-12s %10.2f %10.2f %10ld %8ld", name.c_str(), m.wall_ms,
+               m.min_ms, m.peak_rss_kb, m.collections);
+        std::map<std::string, Measurement>::iterator base =
+            baseline.find(name);
+        if (base == baseline.end()) {
+            printf(" %10s %8s  %s\n", "-", "-", options.baseline ? "new" : "");
+            continue;
+        }
+        const Measurement &b = base->second;
+        std::string why;
+        if (!WithinThreshold(m.wall_ms, b.wall_ms, options.threshold)) {
+            why += " time";
+        }
+        if (!WithinThreshold(m.peak_rss_kb, b.peak_rss_kb,
+                             options.threshold)) {
+            why += " rss";
+        }
+        if (!WithinThreshold(m.collections, b.collections,
+                             options.threshold)) {
+            why += " gcs";
+        }
+        printf(" %10.2f %+7.1f%%  %s%s\n", b.wall_ms,
+               (m.wall_ms / b.wall_ms - 1) * 100,
+               why.empty() ? "ok" : "REGRESSED:", why.c_str());
+        passed &= why.empty();
+    }
+
+    if (options.save_baseline &&
+            !SaveBaseline(options.save_baseline, names, results)) {
+        return 2;
+    }
+    return passed ? 0 : 1;
+}
+
+// vim: set ts=4 sw=4 sts=4:
@@ -0,0 +1,40 @@
+; Destructive list operations: set-car!, set-cdr! and a live set that
+; survives collections.
+(define (make-list1 n fill)
+  (let loop ((i 0) (l '()))
+    (if (= i n) l (loop (+ i 1) (cons fill l)))))
+
+(define (list-tail1 l k)
+  (if (= k 0) l (list-tail1 (cdr l) (- k 1))))
+
+(define (make-rows n m)
+  (let loop ((i 0) (rows '()))
+    (if (= i n) rows (loop (+ i 1) (cons (make-list1 m i) rows)))))
+
+; Splices the tail of every row onto the front of the next one.
+(define (shuffle! rows)
+  (let loop ((l rows))
+    (if (and (pair? l) (pair? (cdr l)))
+        (let* ((row (car l))
+               (next (car (cdr l)))
+               (k (quotient (length row) 2))
+               (tail (list-tail1 row k)))
+          (if (pair? tail)
+              (begin
+                (set-car! (cdr l) (cons (car tail) next))
+                (set-car! tail (length next))))
+          (loop (cdr l)))))
+  rows)
+
+(define (repeat n rows)
+  (if (= n 0)
+      rows
+      (begin
+        (shuffle! rows)
+        (repeat (- n 1) (if (= (remainder n 50) 0)
+                            (make-rows 40 40)
+                            rows)))))
+
+(define result (repeat 2000 (make-rows 40 40)))
+(display (length (car result)))
+(newline)
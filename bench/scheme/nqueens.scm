@@ -0,0 +1,33 @@
+; Counts the solutions of the n queens problem: short-lived lists.
+(define (iota1 n)
+  (let loop ((i n) (l '()))
+    (if (= i 0) l (loop (- i 1) (cons i l)))))
+
+(define (my-try x y z)
+  (if (null? x)
+      (if (null? y) 1 0)
+      (+ (if (ok? (car x) 1 z)
+             (my-try (append2 (cdr x) y) '() (cons (car x) z))
+             0)
+         (my-try (cdr x) (cons (car x) y) z))))
+
+(define (append2 a b)
+  (if (null? a) b (cons (car a) (append2 (cdr a) b))))
+
+(define (ok? row dist placed)
+  (if (null? placed)
+      #t
+      (and (not (= (car placed) (+ row dist)))
+           (not (= (car placed) (- row dist)))
+           (ok? row (+ dist 1) (cdr placed)))))
+
+(define (queens n)
+  (my-try (iota1 n) '() '()))
+
+(define (repeat n)
+  (if (= n 1)
+      (queens 8)
+      (begin (queens 8) (repeat (- n 1)))))
+
+(display (repeat 10))
+(newline)
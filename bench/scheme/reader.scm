@@ -0,0 +1,610 @@
+; Reader and compiler load: a large source of literals and small
+; definitions, of which only a little is run.
+(define (sum-numbers d acc)
+  (cond ((pair? d) (sum-numbers (cdr d) (sum-numbers (car d) acc)))
+        ((string? d) (+ acc (string-length d)))
+        ((or (null? d) (symbol? d) (eq? d #t) (eq? d #f)) acc)
+        (else (+ acc d))))
+
+(define (f0 delta alpha)
+  (if (< delta alpha) (* delta 35) (* alpha 31)))
+(define d0 '(77392 ("beta alpha" 517.616 733.665 (#t (iota delta) -5896 (91294 -770 phi upsilon -87988)) (("iota pi" zeta) 686.273 (546.746))) "xi iota" (beta -17306 -44693 (("xi pi" 252.762 upsilon) #f 521.505 -71257 811.696) 864) "sigma iota" (((delta 464.3 sigma 1 #t))) 552.976 ((-70675 (899.580 91865 99387) 131.675 #f #t) ((pi "delta theta" alpha 602.225) -39985) -13381 285.685 2) (((72748 "omicron pi" 76518 -84111) delta) 549.459 285.473 16164 (#t ("rho eta" -56842) "iota pi" #t 991.59)) (beta "sigma sigma" #t 77002 (3 (9 eta theta 687.660 gamma) #t 518.271))))
+
+(define (f1 epsilon nu)
+  (if (< epsilon nu) (+ epsilon 31) (+ nu 47)))
+(define d1 '("tau kappa" (4 270.118 (phi eta (beta "iota beta" 652.268) "tau omicron" (558.36)) ((nu -6203 682.105 6) (902.422 omicron) (281 "theta eta") (228.24 "mu iota" nu "tau mu") (zeta)) (#f (#f 260.45 36293) (372.441 phi 88679 4 "kappa tau"))) "xi zeta" (-20342 "upsilon phi" (523.484 (sigma #t) (825.203 -35816) (19384 3 "xi theta" 96860 11449))) #t ("sigma tau") ((#t (860.652 7 "gamma kappa" mu) (392.710) 65.424 #f) "xi upsilon" ((-7789 "omicron tau" #t omicron "mu xi")) (("upsilon upsilon" 68492 "zeta beta" eta xi) "iota gamma" #f 70853)) -35177 62879 484.685))
+
+(define (f2 delta upsilon)
+  (if (< delta upsilon) (+ delta 59) (+ upsilon 89)))
+(define d2 '(zeta (((upsilon) (77.606 104.713 1 tau))) gamma alpha (pi (4 ("omicron upsilon" 850.957 "theta pi" "mu alpha" zeta) iota 4) 87.247 (("pi alpha" 414.708) #f (#f kappa 89080) 94741)) 196.221 (((theta) alpha (45059 653.889) (#f) zeta) ((5043 #t #t 46295) (3 "kappa upsilon" upsilon #t gamma) 565.76) "pi phi") -39320 pi 946.270))
+
+(define (f3 upsilon eta)
+  (if (< upsilon eta) (- upsilon 14) (- eta 69)))
+(define d3 '(930.272 (phi) ((xi ("gamma phi" "mu phi" -39989 #t upsilon) 481.531 (6 23210 mu)) ("kappa xi" (-17552 5952 72401 "omicron beta" phi)) ((949.294 "delta alpha") (318.564 "gamma theta" 20965 510.955 #f) (#f 8 -27584 "mu sigma") -25856) (("tau rho" #f eta 585.392) "beta mu" (507.987 #f "delta sigma" 89384) 76.480 ("gamma mu" #f "tau beta")) ((13763 16307 alpha) -23096)) "epsilon theta" #t 6 ((pi 21963) ("nu upsilon" "iota pi" ("delta theta" upsilon) alpha (0 theta theta 4)) (("beta upsilon") 92.931) "zeta eta") 5 zeta "kappa mu"))
+
+(define (f4 delta pi)
+  (if (< delta pi) (+ delta 18) (+ pi 96)))
+(define d4 '((("alpha iota" "nu iota" (482.25 5 66567) (-63359 -20213 -74522) #f) 6 ((#f) eta) 875.371) tau (eta (657.654 (theta) (3 336.792 #f 133.553 112.676) (602.331 beta)) "sigma delta") (sigma (0 (-84055 "omicron delta" "gamma gamma" 67.129 8) #f #t) ((440.462 "mu pi" -18068 nu "gamma gamma")) (epsilon)) ((7691 "beta kappa" (#t 867.110 #t) ("tau phi" 0 alpha mu 890.146) (-75947 385.429 378.319 #t)) (0 "omicron rho") (#f upsilon beta #t) 785.140 (30386 (3 gamma) 14352)) -17934 ("kappa delta" zeta (gamma -36217 "sigma gamma" mu 78.522) (nu (262.202 778.777) ("pi upsilon" "upsilon phi") epsilon "pi kappa") (#f -85087 gamma (#f) (#f))) (18101 gamma 40.253 (#f xi phi gamma) #f) #f 938.358))
+
+(define (f5 kappa xi)
+  (if (< kappa xi) (+ kappa 76) (+ xi 90)))
+(define d5 '(((("sigma nu" zeta rho 158.79 33087) (phi "epsilon zeta" 2 "nu theta" 4) (rho 376.694)) (xi "zeta eta" (68081 tau) (gamma pi 850.447 836.461 8762)) #t) -1719 delta (("epsilon rho" -79232) 855.153 #f) theta -37495 #t "phi tau" #t (#t ((gamma) (#t "beta xi" alpha -9613 52542)) (tau 850.797 (64.733 "beta kappa" 907.42 sigma)))))
+
+(define (f6 xi tau)
+  (if (< xi tau) (- xi 32) (- tau 4)))
+(define d6 '((71896 -3526) "pi xi" 508.708 #t (558.300) -14038 ("zeta pi" 90530 ((-80329 "nu sigma" 975.31 #t) 797.660 "upsilon beta")) ((50450 xi theta) ((#f "eta phi" "eta delta" 18500)) "gamma mu" (kappa)) ((811.142 "alpha nu" (2 -18922 "sigma omicron") (gamma #t #t 443.514 -67452) zeta) 354.970) ((#t (2 175.674 5 -78708 4) 6) ((rho "kappa pi" -58561 "pi eta" 320.882) (778.379 -16346 -29884) 99.51 "phi omicron") 833.335)))
+
+(define (f7 upsilon mu)
+  (if (< upsilon mu) (+ upsilon 97) (+ mu 20)))
+(define d7 '(#f ("sigma pi" (("phi rho") -71821) nu (49495 (1279 4 -66272) (tau 203.616 #t rho))) 620.914 phi "phi kappa" ((#f (9193 56476 #t) (#f 32.586 -49988 omicron 420.513) (85014 574.332 "sigma xi" 470.934) 5) ((tau kappa) (tau kappa #f 297.43) -9203) ((4 111.630) (3 8344) "delta epsilon") #f (774.987 beta (547.756) (427.903))) (((beta #t) (#f 871.516 828.115) "iota zeta" kappa)) ("omicron sigma" "delta zeta") (6.267 "iota mu" #f (22000 "sigma kappa")) (224.980 465.765 (7 (1 gamma) (#t)))))
+
+(define (f8 upsilon tau)
+  (if (< upsilon tau) (+ upsilon 21) (+ tau 41)))
+(define d8 '((734.597 #t #f (alpha 95508 -88128 41862 ("beta kappa"))) 784.656 ("pi xi" 2 (6) 854.3) (6 253.471 eta) ("phi alpha") -73551 ((5451) #t theta (#t 676.533 iota 2 (xi omicron xi #t epsilon))) (((eta 17908) (52.274) #t (#t kappa))) (985.759) "theta phi"))
+
+(define (f9 eta xi)
+  (if (< eta xi) (+ eta 70) (+ xi 41)))
+(define d9 '((kappa #f "mu eta" "beta upsilon") (9 (theta 511.563 ("rho pi" zeta #t))) ((75168) 8106 69.724 517.466 #f) (#t) tau ("zeta delta") (634.539 iota ("pi upsilon") 307.700 (("xi tau"))) 84246 "omicron mu" ((#f))))
+
+(define (f10 beta gamma)
+  (if (< beta gamma) (* beta 35) (* gamma 69)))
+(define d10 '((alpha) ("gamma kappa" 580.854 (809.705 (beta 858.77 #f alpha "rho theta") "omicron zeta" (#t -29753 757.398 -76009) pi) delta 441.459) (-76507 56480 (("gamma tau") (701.389 kappa) 64.171) "kappa rho" (738.640 #f alpha)) ((("phi epsilon" #f "mu kappa") (333.385 "nu delta" 606.558 0) 448.816 7254) ((732.433 17720) (8 -5752 9 -34928)) (0 (omicron -32174 8 456.383) #t)) 26555 "gamma delta" (pi ("delta pi" (beta -94080 77508 528.178) ("theta xi" 655.673 93301) ("xi alpha" 285.770) (#f))) "delta iota" (phi "upsilon delta" "phi zeta" ((320.120 -52016 523.397 588.392 "tau zeta") (322.862 -5881 "epsilon eta" 8) "omicron pi")) 48215))
+
+(define (f11 alpha theta)
+  (if (< alpha theta) (- alpha 4) (- theta 35)))
+(define d11 '(zeta ((50133 5 ("tau eta") (304.895)) (15099 (214.830) (#t 833.211 5) #f) (sigma ("beta iota") (255.149 779.863)) (omicron 66101 (nu) "mu upsilon") 91609) (("eta rho" mu 579.872 beta "alpha delta") (12145 903.665) gamma) (53.405 (84470 488.79) 531.696) 82346 10707 ("gamma delta" kappa 656.693 #t) (643.766 "phi pi") (((omicron 253.283 566.615 4 eta) 3)) -37259))
+
+(define (f12 rho xi)
+  (if (< rho xi) (+ rho 30) (+ xi 63)))
+(define d12 '((-5341) (#f 781.482) (-96385) -84149 (#f ((gamma #t "upsilon gamma" "theta beta" "delta pi")) (122.12) (sigma)) zeta delta ("iota sigma") #f beta))
+
+(define (f13 rho upsilon)
+  (if (< rho upsilon) (+ rho 47) (+ upsilon 20)))
+(define d13 '(50447 (#t) ("nu xi") (((426.937 gamma 31607 -52986)) #f) "kappa kappa" #t upsilon (upsilon ((154.6 -38922 -12178 "kappa delta" 429.503) (-88492 6)) ((2) (14028) (mu "mu mu") 76.966) #t "pi mu") #t "iota delta"))
+
+(define (f14 gamma zeta)
+  (if (< gamma zeta) (* gamma 38) (* zeta 90)))
+(define d14 '((epsilon) 991.364 77519 31.974 "tau tau" "delta epsilon" -41729 "nu gamma" ((-48161) ((delta) "beta zeta" ("rho alpha" "zeta nu" 281.286 35.628) ("omicron tau" -26659)) "eta sigma") #f))
+
+(define (f15 nu rho)
+  (if (< nu rho) (* nu 62) (* rho 44)))
+(define d15 '((zeta #t ("sigma nu" (-35026 tau) (589.866)) (180.242 (84405 #t 856.829) (502.38 616.224 "alpha mu" 825.133) 940.821) (600.721 (gamma) "upsilon delta")) epsilon (((#f #f) epsilon 84027 (#t 3 "epsilon mu" 355.327)) 85851 (eta -8124 88852) "pi omicron") ("nu tau" "upsilon theta" -91242 iota) ("zeta gamma") -11409 ((621.911) -73456 419.713 (kappa 2996 (alpha phi -93254 gamma) -19168 (gamma "zeta nu" zeta pi)) 857.275) ((tau) 3) "sigma omicron" ((3495 (9)) ("zeta zeta" ("gamma omicron" 854.609)) -77187 "tau mu")))
+
+(define (f16 iota sigma)
+  (if (< iota sigma) (- iota 1) (- sigma 89)))
+(define d16 '(((580.602) ((tau "iota xi" #f xi #t)) theta "iota nu" kappa) "delta theta" "mu iota" (("rho sigma" (67.318)) (#t 857.59 "beta nu" ("sigma xi" 78565 rho)) ((nu gamma "beta zeta" 877.226) ("sigma alpha" 24281)) ((4) ("nu pi" "kappa sigma" "upsilon delta")) tau) (26284 mu ((#t 6 738.26) ("xi xi" #t 702.547) (sigma 860.673 300.99 tau)) ((363.228 omicron nu) pi) (9 512.122 ("beta epsilon" 350.419 "epsilon mu" 797.82) 320.649)) "iota eta" ((-66078 ("xi alpha" 748.382 sigma 64282)) ((545 zeta -21829) (#f 350.923 168.970 "alpha theta"))) 216.751 #t -1646))
+
+(define (f17 iota tau)
+  (if (< iota tau) (* iota 6) (* tau 76)))
+(define d17 '(((9255)) 43466 210.711 (73665) 9 34108 (30479) 796.269 ("kappa zeta" "eta rho") -96658))
+
+(define (f18 gamma delta)
+  (if (< gamma delta) (* gamma 85) (* delta 63)))
+(define d18 '(34140 -32920 ((-73836 (mu) -75097) (679.662) pi ((zeta) "pi iota" (115.135 -58216 7 625.388))) (494.942 "pi beta" alpha ((978.685 8 13468 493.354 "epsilon tau") (517.869 "zeta gamma" theta beta #f) (#t) ("alpha delta" 46048 58388 sigma) (beta "mu tau" 7 "delta delta")) (kappa delta)) 504.143 (#t "eta pi" ((66000) ("pi upsilon" 986.510 45024 7 708.592)) 106.396) (((280.407 pi 422.616 4) tau (nu 727.665) (delta 7) (#f #t 75703 zeta)) (81035 (-5974 61509) (#t beta "omicron mu" -96602 635.889)) ((#t 301.459 -50986) (12330 epsilon alpha 40.157 0) (#f sigma 533.69) (#t 679.339)) eta (#t (#t xi 1155 alpha) (#f 328.526 -56119) (-44745 885.701 -46109 "gamma epsilon" beta) -53341)) (932.264 "xi omicron" "delta tau" 1 (#f)) (((24253 139.764 4 alpha) (-98682 "tau tau" eta eta #t) #t) 0 #f) (#f 102.291 ("mu phi" (#f 4.320 729.757 nu rho)))))
+
+(define (f19 pi phi)
+  (if (< pi phi) (- pi 99) (- phi 39)))
+(define d19 '(-53923 (((90690 32953) (#t #f 374.401 #t #f))) 73717 2 183.579 ((("theta gamma") 43.684 xi "beta beta") (4 #t "nu upsilon")) ("theta sigma") rho (450.169 #t 370.616 ((26226 "eta upsilon" "alpha theta" #t)) 0) 264.944))
+
+(define (f20 zeta sigma)
+  (if (< zeta sigma) (- zeta 76) (- sigma 72)))
+(define d20 '((("rho zeta" "phi epsilon") ((pi -39756 111.16 #t 487.923) (#t)) 923.617) 77880 (82882 960.821 "nu upsilon" (260.488 (#f) 51515 #f (-59426 #f "upsilon nu")) ((#t #f 5 875.884) (102.219 tau) (-76122) ("gamma gamma" gamma "xi phi" phi))) 655.506 870.672 (57159 629.173 (-58727 xi "xi upsilon") 93180 (#f)) theta ("upsilon alpha" "sigma delta") (34555 (("xi upsilon" 775.347 "pi upsilon" "delta iota" 693.718) omicron (theta "mu gamma" 487.321 #t 510.754) 893.271 854.255) (-68575 (#f rho #f #f) #t) "rho tau" xi) (83040 alpha)))
+
+(define (f21 alpha eta)
+  (if (< alpha eta) (- alpha 74) (- eta 12)))
+(define d21 '(#t 275.482 ("omicron eta" nu (2 (568.442) (484.825 "rho epsilon"))) (rho #t 61.220 ((iota) #f "delta nu" (#t nu 7 -105 "epsilon zeta")) (#f (theta) iota)) ("nu upsilon" "omicron zeta" -67222 (("delta delta") "tau beta" "sigma gamma")) #t (755.290 134.539 (mu) ((#t 2 6 #f 824.91) omicron alpha 352.293)) 80294 ("kappa phi" 43710 "tau omicron" 732.754) (10687 ((kappa #f -52184 66957 "iota phi") alpha #t ("alpha theta" 29388 "kappa rho") (-13428 57.272 42394 917.861)) "alpha delta" ("theta beta" 36613))))
+
+(define (f22 eta rho)
+  (if (< eta rho) (- eta 87) (- rho 39)))
+(define d22 '((((rho 369.908 996.115 "mu alpha" upsilon)) 9.992) "phi epsilon" -34799 79816 (718.549) (tau ((80682 256.920 "tau kappa" "eta upsilon") mu (#t 460.302 #f))) 6 62459 (72566 ("tau epsilon" (delta -88525 182.894) 27236 49687) ((#t #t 671.503 22698 -5386) (61725 92492 gamma #t) (538.672 571.767 67411 "omicron delta" 563.411) 546.614) mu (("mu phi" #f nu "xi alpha") (#f 219.876 tau) #t)) "nu epsilon"))
+
+(define (f23 epsilon iota)
+  (if (< epsilon iota) (- epsilon 74) (- iota 31)))
+(define d23 '(gamma (((1 91572 "gamma beta" nu)) (-40568 ("beta kappa" tau sigma 51.689 "pi phi") (xi) gamma) 43694 4471 780.138) 499.404 ((-30203 (#t "nu nu" phi) (phi "phi epsilon" 204.701) -70543 (889.852 -10014)) ("alpha mu")) #t tau 711.715 ((61.290 #t -82542 nu ("theta xi")) -17306 #t 7) (#f) 18.355))
+
+(define (f24 nu phi)
+  (if (< nu phi) (* nu 38) (* phi 30)))
+(define d24 '((64047 "alpha tau" ("epsilon gamma" (#f 436.993 #f 668.141 883.141)) #f ((gamma -51731 744.30 "omicron kappa" epsilon) (99871))) (#t (("epsilon sigma" "nu zeta" "rho epsilon") 33.418) ((775.209 "phi rho" "theta omicron" 59365)) ((9 36485 "beta theta" "beta tau") -50232 "kappa kappa" "kappa phi") (("gamma sigma" #t pi "upsilon eta") (735.750) 85133 gamma "sigma phi")) (((166.889 9990 "kappa zeta")) 983.207 alpha "tau alpha") (#f 57605 ((#t 71252 874.33) (-87147 165.688 9 "upsilon nu" -21542)) "gamma omicron") (124.711) (3 -71348 ((#f iota #t "sigma rho") 904.624 eta 21866 (818.630))) (tau (706.288 -19320) #t mu) #t (rho (("tau mu" "beta sigma" tau 591.701))) gamma))
+
+(define (f25 epsilon iota)
+  (if (< epsilon iota) (+ epsilon 43) (+ iota 48)))
+(define d25 '(((97011 beta 30299 (eta 114.383 935.94)) 26527) ("sigma kappa" ((#t) (#t 80106 -12631 -72973))) alpha ((293.283 "delta iota") delta 8) 5 965.721 (-18375 (-65902 -72232 11795) 9 ((730.776 #f 83133) "kappa pi" 147.881 ("zeta mu" pi 24606)) "pi zeta") phi (-14576 ((#t #f eta #f tau)) ((#t) (16710 "gamma phi" #f -76268)) 908.594 ((xi "eta eta"))) (omicron ((#t -3211 -99779 delta -38333) 6 "xi xi") 678.177)))
+
+(define (f26 rho epsilon)
+  (if (< rho epsilon) (+ rho 71) (+ epsilon 49)))
+(define d26 '(((137.11 -62253) (("pi phi" #f) #f 434.619 "theta sigma") #f) 48937 delta (#f) #t 79325 (-9942 22911 "upsilon mu" kappa 4) ("upsilon zeta" (("gamma epsilon" iota iota 94361 931.605) (267.801 "zeta sigma" gamma #f) (676.450 215.591 beta -86232)) "rho kappa") #f (543.891 pi sigma (#f))))
+
+(define (f27 phi iota)
+  (if (< phi iota) (- phi 34) (- iota 34)))
+(define d27 '(((751.688 (320.560 -82187) 37694 "nu theta") (62371 3 (#f)) ((259.301 67452) omicron (-27311 "xi mu" iota) 28901 (660.503 #t))) ((-81542 (30469 -90082 epsilon) (#f 41591 "rho delta" mu))) (-4225 gamma (("eta kappa" 65312) ("eta epsilon" 88675 500.398 #f) "alpha beta") beta) 826.669 ((#t 500.669 #t (-19434 19586) (-70069 #t "mu xi" #t 782.46)) (epsilon (#f #t) #t) "gamma alpha" 85267) ("epsilon eta" sigma 960.178) (((nu) #t 1 #t)) 283.54 701.864 (686.944 kappa mu (40865 27155 -38318 ("eta mu" -14507 755.422 "theta gamma" "beta omicron")))))
+
+(define (f28 epsilon eta)
+  (if (< epsilon eta) (* epsilon 58) (* eta 22)))
+(define d28 '(468.737 iota 32.708 ("pi omicron" theta (2 (#t "iota alpha") ("upsilon theta" 2) (23378 #f "delta pi" 46404) (367.302 -95825 zeta #t))) ((pi (893) (omicron 8 62648) (beta)) pi (1 (theta "upsilon eta") (sigma beta)) pi) #f ((("gamma gamma") 295.981 (82735) 895.209) -23148 #f "alpha kappa" -39097) (((#f #f theta) beta pi (#t 165.243 upsilon nu 0)) epsilon 2 6053 ((#f rho 2) (91795 -63452 -19239 #f))) beta (((41141 34162 "mu phi") (xi)) "nu xi")))
+
+(define (f29 nu alpha)
+  (if (< nu alpha) (- nu 44) (- alpha 44)))
+(define d29 '("tau gamma" "omicron pi" "omicron epsilon" (310.486 ((#t) omicron "upsilon epsilon" "kappa tau" upsilon) #t -59624 "delta kappa") "theta alpha" rho (((rho -2168 #f -61692 365.167) omicron (sigma 34707 783.96))) (kappa delta) epsilon #f))
+
+(define (f30 rho omicron)
+  (if (< rho omicron) (- rho 20) (- omicron 13)))
+(define d30 '(#t (((9404 -69444 25702 epsilon #f) alpha (704.232) 133.80 -79623) "omicron beta" 72959 22967 beta) 97800 57756 189.686 -61844 ((#t -74021 (987.288)) 0 942.516) (#f (xi) #f delta) #f (("delta xi") 4 ("kappa omicron" 24695 ("delta xi" -68748 "upsilon delta") (346.205 "delta theta")))))
+
+(define (f31 omicron rho)
+  (if (< omicron rho) (- omicron 97) (- rho 91)))
+(define d31 '(("nu rho" (("delta delta" "theta epsilon" -82115 -53052 epsilon) #t ("eta kappa" "sigma iota" #t 12828 566) "pi pi") 570.675 ((319.732 49121) (#f 518.57 "upsilon xi" kappa 54786) nu) (xi nu 73340 663.319 (-11502))) #t "upsilon sigma" ("upsilon alpha" (("delta eta" #t omicron) 40465 beta #t) ((iota #f 70796 #f eta))) phi #t (("iota tau" (36909 "epsilon theta" omicron 66180) "iota kappa" (415.244 28.251 pi) "omicron beta") epsilon tau 89392 -85497) (gamma) ((241.114) ((#f -37590 mu "theta omicron" -54085) pi #f -17035 "theta iota") (kappa 0) (("kappa nu" 40223))) ("iota kappa" 304.215 (("beta iota" "rho omicron" omicron) (sigma)) "phi tau")))
+
+(define (f32 mu pi)
+  (if (< mu pi) (* mu 3) (* pi 97)))
+(define d32 '(645.454 (643.312 -70948) 2 (266.177 ((zeta "upsilon theta") 46415 ("eta iota" 50.410)) (-3552 #t ("rho delta" 195.968 kappa "epsilon omicron") (eta "epsilon alpha" theta 378.596 "gamma alpha") xi)) ((46014 theta phi (-98595 #f epsilon 0 515.504) (sigma delta 511.892 nu)) ((sigma 323.754 569.873) (55.235 "iota zeta" "delta rho" tau) "delta epsilon") -46593 ((#t 37891 426.942 "delta mu" 3329) -15187)) 20647 (phi ((upsilon 68727 94982 #t 245.988) (166.397 epsilon "omicron kappa" #f) ("pi xi" #f "nu phi")) "gamma beta" "theta epsilon") (("omicron gamma" (700.924 535.437 44439 34588) "omicron delta" #f 31974) "zeta zeta" (mu) ((mu 216.189 4 #t) -54981 (#f 5 "kappa gamma" -49983) 82460) (665.247)) #t "epsilon rho"))
+
+(define (f33 omicron alpha)
+  (if (< omicron alpha) (+ omicron 21) (+ alpha 19)))
+(define d33 '((("upsilon theta" #t 65258 ("upsilon phi" beta "sigma upsilon" "theta beta")) "upsilon mu" ((29705 pi -57708 480.352) 3 ("epsilon kappa" "omicron nu" 636.212)) 74864) 204.160 ((570.48 (zeta #t 61890) #f nu)) (873.706 (("pi delta") (47448 -56210 932.370 pi "delta epsilon") (-47076 "alpha theta" "mu kappa") -30266 "nu theta") #t "omicron omicron" (("epsilon alpha" #t "zeta omicron") 73061 (65572 #f) 4 (sigma 717.413 908.557))) (((gamma xi 532.553 34131) (23.28 #f omicron 91885 iota) (17633 18789 824.763)) ((358.306 2 107.335 842.797 -61582) (11381 "eta pi" 6 "iota upsilon") "pi rho" (517.130 "epsilon sigma" 82051 "beta zeta") (57705 -68316 beta)) -2623 kappa -62548) #t (("alpha delta" -88287) 4 xi) #t "pi pi" gamma))
+
+(define (f34 phi omicron)
+  (if (< phi omicron) (- phi 29) (- omicron 50)))
+(define d34 '(75752 (((tau #t #t #f -68469) (-27921 849.722 #t #f "alpha mu")) "alpha sigma" gamma) 42024 187.261 ("zeta beta" (-21875 epsilon iota)) -86401 #t #t pi ("theta alpha")))
+
+(define (f35 iota tau)
+  (if (< iota tau) (* iota 86) (* tau 12)))
+(define d35 '(#f (#t 800.251 "tau pi" "phi kappa") ("iota phi" "nu eta") (756.546 (-63392 (625.516 mu "iota theta") ("phi mu" 661.944 "alpha alpha")) ((1 0 -7465 "phi nu") -67294 455.9 98815) eta 4) "nu beta" #t "delta iota" (675.756 ((-66595) 3 (81662 4 "alpha omicron") (omicron) (#f 89063 omicron alpha)) gamma (("gamma theta" kappa))) -92694 55328))
+
+(define (f36 mu iota)
+  (if (< mu iota) (+ mu 13) (+ iota 60)))
+(define d36 '(beta (((63931 -77578 -1069 -66568 "beta kappa")) (46606 "xi delta" (#t "omicron phi" alpha upsilon) -96779) ((652.521 "rho phi")) 140.816 319.598) kappa ((#f 35706) (#t 999.205) (("pi phi" #f "mu zeta") 30005) 67448 477.638) "mu xi" 845.6 -6183 -62671 646.599 (-47802 224.906 347.867)))
+
+(define (f37 tau theta)
+  (if (< tau theta) (+ tau 25) (+ theta 2)))
+(define d37 '(delta 388.670 (312.467) zeta ((813.194) "nu mu" ((#t 65008 871.520 "eta gamma" #t) #f) 329.729 "rho rho") "upsilon beta" 462.883 313.435 (iota ((theta "sigma phi" "pi omicron") "mu iota") 452.239 -5866 ((-27537 -68913 43137 691.337 eta) (#t nu) (#f 886.407 485.239 7))) ((("eta pi" #f 312.965 "nu mu") "xi tau" 0) (upsilon (#f "gamma tau" "delta mu" "kappa gamma" #t)) (203.71 (298.675 "beta nu" 334.880 "zeta delta") "rho gamma" 133.891 "rho zeta"))))
+
+(define (f38 phi upsilon)
+  (if (< phi upsilon) (- phi 75) (- upsilon 25)))
+(define d38 '("iota eta" 456.65 ((#f 93276 "nu kappa" 425.255 #f) 715.582 -37166 (4 ("tau delta" 98022)) omicron) eta "alpha gamma" ("eta xi" delta ("rho pi" 3) (zeta 59118)) delta "zeta gamma" ((221.731 #f)) ((pi) -87243 ((93.16 -11627 -42180) (741.171)) #f 639.212)))
+
+(define (f39 tau xi)
+  (if (< tau xi) (- tau 15) (- xi 29)))
+(define d39 '(mu "mu alpha" "theta gamma" ((420.308 (86785 #f 5 340.179) ("gamma mu" #f 515.601)) (#f) "theta phi") 383.510 384.209 (((epsilon 36543 "kappa alpha" mu) 0 ("sigma mu" -83062) (66295) (606.562 241.519)) "kappa zeta") (#f "eta iota") (xi "pi omicron" "epsilon rho" "omicron gamma") ((("kappa pi" #f) 732.480) 4.13 ("xi nu" upsilon -67369))))
+
+(define (f40 xi upsilon)
+  (if (< xi upsilon) (+ xi 24) (+ upsilon 97)))
+(define d40 '(nu "nu beta" ((alpha ("epsilon iota" #t)) 68924 (1 ("iota kappa" 6 "gamma delta" epsilon) 952.766 alpha) (82535 "kappa omicron" zeta (#f 190.205))) 828.777 "pi phi" 81.300 -27449 53523 "delta alpha" 74410))
+
+(define (f41 upsilon beta)
+  (if (< upsilon beta) (+ upsilon 27) (+ beta 66)))
+(define d41 '((((#f mu xi -6670) ("epsilon alpha") (377.462 "sigma omicron" 67267 alpha 92888)) "theta phi" #f "delta xi") 729.146 (("gamma kappa" ("zeta pi" "tau theta" 771.966 -72352 -57996) (theta "delta epsilon" "gamma mu") (1 "tau omicron" 265.118 -76633 3) (xi -18526 #f nu 532.679)) (41110 (theta "epsilon phi" 56992)) #f (506.298 (epsilon 868.750 717.753 877.499) (22.561 "rho nu" "gamma sigma") (717.876 -65686 0) 591.140) "kappa epsilon") 752.666 1 ("zeta beta" "zeta beta") 5 642.739 -68857 "kappa phi"))
+
+(define (f42 zeta xi)
+  (if (< zeta xi) (* zeta 85) (* xi 84)))
+(define d42 '("xi iota" (-69427 "sigma theta" #f 55419) "omicron kappa" (#f) (#f) 8 (((#t) (588.211 47455 -77820))) (#f (36168) (("mu sigma" phi 704.101 -37846) 306.876 (605.367 #t)) xi (-33369 (65037 731.381))) ((("xi alpha" 79.276 79301) -13661 (epsilon 280.10 387.974) -53934) upsilon (upsilon (-87427 "zeta nu" 8 "rho upsilon" 80003) 673.129 #t) (("pi zeta" pi) omicron 312.650) (gamma (-56717) (#t))) ((8 61555) 87212 #t ((690.952) (76.375 #t "zeta nu" theta -23962) iota #t (21387 "beta nu" "mu kappa" -8323 411.363)))))
+
+(define (f43 alpha delta)
+  (if (< alpha delta) (- alpha 62) (- delta 25)))
+(define d43 '(#f "alpha epsilon" ("nu kappa" 549.831 "pi zeta") "alpha nu" (beta "mu beta") 971.490 ("tau rho" ("sigma xi" -94456) sigma) 53.694 ((kappa) "theta phi" #t -30918) ((83800 (#t "beta iota" 436.18 -86643 4) ("rho beta" -20233) iota) (-52355 73127 (phi 258.971) kappa))))
+
+(define (f44 delta phi)
+  (if (< delta phi) (* delta 1) (* phi 87)))
+(define d44 '((upsilon theta) (((#t 197.721)) -80371) ("eta tau" ("tau iota") ((14327 "sigma sigma" 613.280) (0 "rho tau") (6) (188.3 606.713 7 #f) (#t #f 964.904)) 276.894 ((70038 #f) 4)) #f (((40873 1 "iota phi") (eta "epsilon pi" "nu epsilon" 30013))) 835.883 7 alpha 837.403 (11776 "delta sigma")))
+
+(define (f45 epsilon alpha)
+  (if (< epsilon alpha) (* epsilon 12) (* alpha 48)))
+(define d45 '(-96448 (-29836) #t (gamma) "upsilon pi" (249.57 tau -73048) 34097 (24.232 361.671 "delta rho" -41143) nu delta))
+
+(define (f46 nu gamma)
+  (if (< nu gamma) (+ nu 77) (+ gamma 19)))
+(define d46 '(5 "epsilon kappa" (-28935 ((796.671) 399.457 (51478 epsilon 186.785 rho)) "phi mu") 392.428 #f 393.85 (719.89 -46712 ("epsilon delta") nu) (855.873 (57.764 386.750 "nu beta" (#t 80.250 #t "epsilon sigma" rho))) pi (61.902)))
+
+(define (f47 beta zeta)
+  (if (< beta zeta) (* beta 20) (* zeta 1)))
+(define d47 '("pi tau" ((433.953 36708 760.216 -42615 #t) ("xi zeta" omicron -72633 #t) 554.109) #f 653.951 gamma ("beta beta" alpha (("nu epsilon" -13147 1 24.601 "upsilon beta") 698.474 88340) 826.697 ((#f 347.297 "beta xi" #t #t) (tau 30786))) zeta (#f 727.790) "iota pi" ((kappa #f #f "sigma pi" 62690) ((#t xi)))))
+
+(define (f48 zeta upsilon)
+  (if (< zeta upsilon) (- zeta 9) (- upsilon 28)))
+(define d48 '("gamma nu" #t 4056 (-16826 #t) ("beta tau" "epsilon eta" 57568 (("eta beta" 98866 iota))) (xi) "omicron sigma" zeta ((zeta "rho rho" 988.713 #t)) (#t alpha "epsilon rho" ((18111 649.460 #t 430.713)) 615.386)))
+
+(define (f49 eta nu)
+  (if (< eta nu) (+ eta 24) (+ nu 86)))
+(define d49 '((alpha) sigma ((nu (delta "omicron nu" 2 omicron) (-77031 -76502 #t #t #t) ("tau xi" "delta nu" "omicron xi" theta))) iota "theta alpha" (-59794 ((982.585 569.996 #t #t "zeta xi") (101.727 1 "iota tau" eta 14667) #t (49892 464.649 zeta 304.198 743.798) (-27920 642.23 #t #t)) zeta "nu eta") "alpha omicron" -44873 (((675.580 -69275) (9 #t 40497) #t (-14138)) 90773 ("eta gamma" #f) ("eta iota" xi #t ("omicron phi" phi "omicron eta" gamma))) 34049))
+
+(define (f50 iota upsilon)
+  (if (< iota upsilon) (- iota 37) (- upsilon 77)))
+(define d50 '((-69946 omicron (672.380 delta 87905) "upsilon mu" (phi 105.574 1 ("mu mu" 29481 omicron "zeta phi") "theta upsilon")) 68733 (("beta tau" (-81794) "kappa iota" xi) rho ("rho delta" (48.845 -15365 "theta zeta" tau -31925) (gamma) #f) ((771.598) (36777 7 mu "theta gamma")) gamma) 675.662 (((479.838)) "delta mu") 8 (((938.372) "phi sigma") "eta gamma" 702.314) ((95304 20808) 24843 (44258 "eta epsilon" "sigma mu" nu) "omicron eta" "zeta phi") 7 69435))
+
+(define (f51 theta delta)
+  (if (< theta delta) (+ theta 14) (+ delta 6)))
+(define d51 '((39495 903.635 (-42358 (804.208 phi -75295) 7 174.322) ("epsilon alpha" (997.270 695.778 #f "theta rho")) 48705) ((793.96 pi tau "iota nu" kappa) ((sigma -61229 675.145 -35941 "nu eta") ("delta iota" 7) mu "iota kappa" 8) #f) ((30790 (535.989 #f) -22740) -43030 #t 12806 -86919) kappa ((86960 442.599 ("nu theta" "omicron xi" -31513) (6 2 epsilon 308.312 7) "delta epsilon") sigma ("pi omicron" (#f 629.928 594.524 8) ("epsilon xi")) ((-77808 -12580 upsilon beta 8) (#t 308.643) 27128 (-59887 36268)) 106.485) #f -21377 839.240 (7 (-51554 174.523 ("kappa kappa" #f "xi delta" "epsilon alpha" 47904) #t) (epsilon "iota alpha" (#f 6 360.671) (285.803 xi "xi rho") (#f upsilon)) ((92119 74394 "mu theta" 107.921) ("gamma beta" -90192 15744 #t) "xi epsilon") (("kappa theta" 444.833) 88.596 -46644 914.5 "upsilon tau")) (#t ((#t "omicron xi" #t delta 52.615) -41275 (xi -58618 40095) (#f 1 alpha "iota eta" -63487) beta) 47811)))
+
+(define (f52 phi beta)
+  (if (< phi beta) (- phi 9) (- beta 53)))
+(define d52 '(((277.740 30179 omicron 21.953 547.622) (("epsilon omicron")) ("delta phi" (omicron 237.94 422.765) (88698 -79917 "zeta kappa" phi 299.132) (-79978 #f theta nu) (539.914 #t "phi rho")) 933.140 (#t 36.240 (30785 iota gamma #f) "xi pi" 388.188)) (beta alpha ((#t #f -71372) (#f #f "pi theta") -26417) (789.555 #t (phi upsilon zeta)) 15319) -5963 #f -27532 (15458 iota (150.892 (-51699)) ((62.974) (77835 tau #f) #t 208.333) ("kappa epsilon" #f (phi beta 933.605) #f)) 9 387.850 (-79734 (("tau delta" 0 #f 856.589 336.248) (delta "omicron nu" #t))) (((947.550 "upsilon epsilon") (-78634 2 921.184) ("iota tau") (890.34 80891 -65298 #f)) "tau theta" (upsilon) ((pi)))))
+
+(define (f53 omicron pi)
+  (if (< omicron pi) (* omicron 55) (* pi 37)))
+(define d53 '((((55596 "xi mu" #f -39114 beta) ("kappa mu" 976.146 440.531 #t 121.294) "theta zeta" phi (98.211 #t)) ((6.500 -3128 6 850.464 87760))) ("rho iota") 285.749 (((iota 1 13607) #t) ((#t)) ("zeta rho" 650.896 #t)) "tau phi" 39.428 (3 #f (("phi nu" delta omicron theta) (delta) "epsilon rho") ((sigma "beta tau") ("xi pi" beta 347.651) (586.896 798.640 #f) 0) "gamma mu") (35960 #t ((932.382 566.750) -90544 ("rho beta" alpha 34.278 "xi epsilon" gamma) #t) #t #t) ((-20793 102.270 (omicron "tau iota" #t "xi nu" 18559) 4162) (1 829.645 (885.964) 85.144) "sigma upsilon") ((epsilon #f (7 329.472 8)))))
+
+(define (f54 gamma delta)
+  (if (< gamma delta) (- gamma 89) (- delta 9)))
+(define d54 '(-57509 -56433 -89761 (#t (-22209 iota 5 (822.628 sigma) (epsilon "alpha mu" 481.68 -18253)) ((-83981 #t #f 281.291 "upsilon kappa") "iota tau") 79.606) 286.182 -66786 ((#f ("eta zeta" 221.93 #t -15239 -64093) "omicron rho" #t) ((5 #t epsilon #f) (6 -4138 omicron) #f -48663) #t (iota 59062 rho) iota) ((("tau delta" 60673 722.753 84.429) (-17625) #t (zeta)) (("omicron beta" 2 454.45) 705.517 -18431 delta 1) (-52159) (-55610 ("gamma theta" 765.773)) (zeta #f 279.904)) iota (upsilon 7 (#t 719.444))))
+
+(define (f55 nu kappa)
+  (if (< nu kappa) (+ nu 43) (+ kappa 89)))
+(define d55 '(((264.223 -69776 486.143) nu ((alpha "mu mu" -50950) (#t 7 "xi rho") (#f beta 781.957) ("iota upsilon" -57002 phi 3 679.341) (epsilon)) ("alpha epsilon" 308.314 878.208 157.701) (352.102 "eta rho" (1600 409.791 omicron #f))) #t ((0 (141.511 309.445 "zeta omicron" xi) ("zeta zeta" #f delta "alpha zeta")) #f) ("omicron beta") delta ("mu tau" (("gamma epsilon" #t #f beta)) "pi nu" #f) alpha 300.365 "mu kappa" (39268 (#t (nu 3 #t beta)) 116 -11455 (-51784 (13622 584.267 8) (-1897 778.957)))))
+
+(define (f56 omicron iota)
+  (if (< omicron iota) (* omicron 88) (* iota 99)))
+(define d56 '(0 694.291 "eta alpha" ("phi mu" 18.726) 60271 7 5 #f pi "eta tau"))
+
+(define (f57 zeta xi)
+  (if (< zeta xi) (- zeta 51) (- xi 4)))
+(define d57 '((((#f pi -59132) (#f 96971) (384.943 "phi delta" 216.113 885.162 "tau omicron") 428.922) ((sigma) "theta xi" "kappa pi") 409.295 pi ("omicron omicron")) 62234 9 (((582.640 -2930 6) 870.935 theta 330.135) -45735 (#t (58336 250.473 -98196 "sigma rho") (tau) 8) "beta kappa" (#f)) (upsilon) ((epsilon (-13486 20125 "theta iota" "mu pi") (99576 #t upsilon kappa 581.649))) "kappa epsilon" (xi 28.871) epsilon (#f 995.352 (("rho zeta" "zeta rho" 75307) (229.153 70392 "pi upsilon") (3) 4462 (tau #t #t)))))
+
+(define (f58 iota zeta)
+  (if (< iota zeta) (* iota 83) (* zeta 31)))
+(define d58 '("zeta beta" (((535.310)) 249.599 (#f (15840) 102.555 (0 88738 603.825 "alpha iota" #f))) (4 #f #f) ((sigma 183.67)) ("mu tau" ((#f "delta kappa") (331.160 "zeta zeta")) (7 (theta "kappa nu" nu pi))) #f "beta omicron" 998.467 ((kappa ("mu tau"))) ((delta 333.740 #t ("theta iota" #t iota "kappa delta") -14923) ((3 335.586) tau alpha 83304))))
+
+(define (f59 mu nu)
+  (if (< mu nu) (- mu 95) (- nu 27)))
+(define d59 '("theta pi" 693.994 (("omicron xi") ((#t)) (("kappa upsilon" 92527 46352))) (1 (("iota pi" 666.338) #f "alpha xi" ("alpha alpha") "epsilon iota") ((788.841 upsilon 211.315) 39833 (#t) theta ("iota theta" 790.363)) "delta xi" 389.50) "eta eta" (((#t 28216 mu 92.818 "iota sigma")) "alpha alpha" "xi delta" gamma theta) (((mu) 181.578 #t (887.757))) ((958.531 (-57435 313.413)) ((alpha) (935.417) "phi sigma") -96084) 94.429 (((#f epsilon 5 25249 #t) 824.964 94821 "kappa phi"))))
+
+(define (f60 delta theta)
+  (if (< delta theta) (+ delta 32) (+ theta 23)))
+(define d60 '(("upsilon sigma" epsilon epsilon) (((-62526 165.406) #f (#f "phi iota") 95286)) #f ("tau pi" ((omicron #t "delta delta") (kappa 1 #t) (751.762 2))) (5 #f 650.649 ((#t "kappa xi") ("mu epsilon" alpha #t #t)) "epsilon epsilon") 782.995 (661.429 254.854) 986.971 "delta upsilon" (688.282 ((64769 676.448 41887 "epsilon gamma" iota)))))
+
+(define (f61 beta xi)
+  (if (< beta xi) (- beta 14) (- xi 80)))
+(define d61 '(2 ((91826 (890.870 "omicron beta" iota #f nu)) 86933 ((delta "tau phi") ("beta phi" 50896 369.594 #f)) ("pi upsilon")) (((24.645) ("alpha pi") (nu 283.456 pi) (214.571 5 zeta))) (8) (delta ((774.391 "nu mu" zeta))) (595.317 (#t -47934 #f tau 943.394) phi) (453.845) 2 (251.896) 148.12))
+
+(define (f62 kappa theta)
+  (if (< kappa theta) (+ kappa 78) (+ theta 61)))
+(define d62 '(((868.531 ("iota nu" omicron 327.553 329.880 814.551) (7) 3 #f) 20648 ((22.573) -8878 65.698 upsilon) 87069) (((tau mu) #t) (59801 upsilon 60917 "zeta eta" #t) "delta mu" "upsilon xi") (((zeta rho) xi) gamma 37328 0) delta #t alpha ((("zeta tau" delta)) (("zeta sigma" "alpha phi" #f -8498 #t) (627.942 "tau xi" 75297 theta)) 983.837 "beta nu" "upsilon delta") (((#f 289.328 299.966 "omicron xi" 28775) 7 "kappa beta")) -50697 ((beta -20585 tau "sigma sigma" (-43772 913.226 87179 584.655 4)) -23863 675.833)))
+
+(define (f63 mu zeta)
+  (if (< mu zeta) (- mu 29) (- zeta 47)))
+(define d63 '((613.252 ((eta omicron "omicron xi" 836.797) 0 ("epsilon theta")) -69781 "gamma zeta") 966.757 "kappa tau" #t (((130.530 "rho delta" 1728 -36627 pi) (73769 786.215 49107 349.880)) (923.659 "epsilon kappa") 188.642 "alpha pi") 616.541 146.560 (7459) 62158 (923.106 (#f) ((-94812)))))
+
+(define (f64 rho upsilon)
+  (if (< rho upsilon) (* rho 49) (* upsilon 36)))
+(define d64 '((699.502 ((465.549 147.293 986.990 zeta) 13177 ("tau theta" 860.641)) "omicron omicron" "pi xi") mu ((582.199 ("tau omicron" eta "delta tau" phi 222.345)) (("alpha eta" 279.763 656.411 154.421 888.756) "mu phi")) (77258 -77522 -13098 ((980.218 -4858 upsilon) (296.310 #t 39540 "zeta tau") (theta 931.455 -64454 "xi rho")) 53662) ((("upsilon nu" -3016 639.307 113.957) (kappa -7015) (#t eta #f 53.664) iota "mu beta") "gamma mu" ((#f "xi xi" xi #f 965.354) (iota "gamma mu" -93969 -36310 gamma))) 797.89 (((7 60580 204.940 -51353 -98994) 215.51 (#f "phi zeta" #f -79145))) 269.147 (((theta)) 4 eta theta kappa) ("nu beta")))
+
+(define (f65 phi omicron)
+  (if (< phi omicron) (+ phi 86) (+ omicron 97)))
+(define d65 '((-16534 ((49212 pi "nu rho" "mu tau" 233.601) omicron "mu xi") "pi epsilon" "omicron alpha") (409.374 154.607 ("rho epsilon" 22.509)) tau 498.621 (499.992 (("phi kappa") #t -19258) ((57054 mu 378.578 -95358 "theta eta") (rho 5) (upsilon 725.607)) ("alpha mu" 700)) (#f ("eta iota" (24189 -14223 7) mu) phi ((#t 92805) (theta "alpha kappa" 303.25 "gamma nu" 457.640)) 608.454) ((#f 330.979 -14401 ("tau alpha" xi 0))) #t ((-63324 2)) nu))
+
+(define (f66 mu gamma)
+  (if (< mu gamma) (- mu 43) (- gamma 96)))
+(define d66 '("tau beta" "epsilon tau" (99954 (69019 (490.43) 972.156)) (xi (rho "tau gamma" #t "alpha nu")) (((549.7 #f) (772.622 334.919 70514 16796 #t) 1568 (4 #f) 580.911) (-18762 881.341 "mu pi") ((4 79.631 -91822 -28112) (#t 661.195 gamma) -22021 (pi) (24912 -77431)) ((iota #t 220.66 "alpha beta" "omicron zeta") (-26384 "eta iota" eta "alpha beta" "tau rho") (56774) "tau zeta") tau) nu #f kappa "tau omicron" "gamma phi"))
+
+(define (f67 iota epsilon)
+  (if (< iota epsilon) (- iota 45) (- epsilon 82)))
+(define d67 '(#t 613.349 871.817 (("delta sigma" 1 2 rho) tau) ((omicron ("epsilon eta") ("epsilon gamma" theta eta -49929 -22462) 847.794) (10603) (#f 311.438 (0 31070 -32949 "tau delta") #f) (("gamma rho" -78252 19193 theta) (tau "eta phi" 79260 32722) #f 6) (83033)) 923.462 40.297 (991.857 "rho theta" 791.385 228.348) (((135.758) ("rho nu" "alpha sigma" tau "beta iota" "gamma gamma")) rho 928.950 (49532) 456.675) ((596.423 -39118 epsilon (33744 37511 #t 327.942)) "eta eta" (-54802 #t (25223 48414 "nu theta" "beta omicron" xi) xi))))
+
+(define (f68 pi theta)
+  (if (< pi theta) (* pi 16) (* theta 61)))
+(define d68 '(((#f ("gamma tau" 791.656 xi kappa)) (rho "upsilon tau" (#f "mu tau" -34047 kappa 320.949) (kappa sigma) ("eta phi" 821.788 703.702)) #f "upsilon sigma" theta) zeta ("rho iota" (260.620 -1287 (831.956 "pi tau" sigma 272.52) ("omicron xi" 185.125 -89244 delta)) epsilon (#t #f 225.633 (theta #f 825.989))) (-57954 #f) 865.416 "phi zeta" (-37408 (("eta theta" 7094 "epsilon xi" "alpha tau" 902.689) #f #f (720.79 "zeta xi" nu 732.297 "phi rho"))) (18553 (nu) "omicron pi" (theta) rho) 874.599 (866.37 (92.724 (#f) pi) 879.446 234.419 #t)))
+
+(define (f69 gamma beta)
+  (if (< gamma beta) (* gamma 83) (* beta 94)))
+(define d69 '(#f (617.729 -29472) ("tau nu" (251.805 784.278)) 31311 3233 22963 247.882 (("zeta delta" (-82417 0.294) "xi tau") "sigma pi" (9 (#t "epsilon beta" #f "xi xi") -17544 -43490 460.885)) ((16.922 "iota rho" "nu eta") "beta theta") (-8105)))
+
+(define (f70 pi xi)
+  (if (< pi xi) (* pi 55) (* xi 9)))
+(define d70 '((("gamma nu" sigma -61743 (33564 #t phi #f #t) (0 #t 955.844 "iota epsilon")) 95.631 "theta beta") -65151 #f (#t -57168) ((947.688) 75483 phi) (((mu 8 #t "rho iota" #f) (#f 568.228 901.979 948.100) ("omicron upsilon" -36432 "gamma mu" 14196 "epsilon omicron")) -12501 ("rho xi")) (293.249 (5 -73613) -60667 "gamma epsilon") (-65009) nu (mu)))
+
+(define (f71 delta beta)
+  (if (< delta beta) (* delta 10) (* beta 5)))
+(define d71 '((((4 60625 21198 zeta) (3 "mu zeta" "nu sigma" "omicron theta" mu) "epsilon epsilon" 54057) ("epsilon epsilon" (upsilon "omicron omicron" #f))) (("eta nu") -33893) "pi xi" (omicron ((977.256 "mu epsilon") 245.525 (427.39 mu mu) "sigma eta" sigma) "sigma upsilon") (19263 (#t 6780 ("pi phi") (460.271 -39846 #f) #t) "theta xi" -80050 (#t phi (546.677 -38440 "tau mu" 14.701))) theta (zeta) ("eta zeta" kappa ((-99128) (zeta) "mu delta" 7 #t)) -7401 558.967))
+
+(define (f72 iota alpha)
+  (if (< iota alpha) (* iota 98) (* alpha 11)))
+(define d72 '((534.834 (alpha "omicron delta")) (635.652 1 "tau pi" eta) (49668) mu -17381 (55883) 55421 "tau tau" (67268 tau (-85605 ("epsilon iota" "gamma sigma") "kappa kappa")) -25249))
+
+(define (f73 mu zeta)
+  (if (< mu zeta) (* mu 11) (* zeta 17)))
+(define d73 '(((-30742) ((#t tau) (9) #t) ("gamma mu") -64115 #t) (xi) zeta ((189.664 (23290)) 173.755 ("alpha sigma" (504.560 "eta phi" 844.540 414.997 #f) 85310 #t (epsilon 1 -39483 91693)) "epsilon eta" 50621) 734.113 (eta) 741.663 ("xi sigma" ((eta 501.500) (13585 -84379 #t epsilon) 436.787 1) theta) rho (448.926 660.497 8)))
+
+(define (f74 epsilon delta)
+  (if (< epsilon delta) (- epsilon 92) (- delta 47)))
+(define d74 '(-28747 ((#t (9 2 #t) (6 "eta zeta" omicron) upsilon) "phi upsilon" (#t) nu 545.341) "tau alpha" ((-46272 #t)) (226.755 delta 54009 upsilon (626.121 phi)) 45.487 (28332 ((#t alpha nu) (93698 0 842.160 92004 202.135)) 73450 #t 375.642) ((-58302 -55076 2 (216.74 13932 272.730 8)) ((8 "omicron zeta" "iota mu" 948.751) (xi) (1 -39776 1 #t) #t 33278) ((-11104 -31933) #t "eta epsilon" (35778 "gamma omicron") (pi mu -92838 89553 zeta))) (492.975 ((65372 0 mu 32125 iota) 2 ("sigma gamma" sigma -17657 32944 -88428) (386.353)) (4) "upsilon delta" 816.275) nu))
+
+(define (f75 beta nu)
+  (if (< beta nu) (- beta 21) (- nu 73)))
+(define d75 '(44845 (246.420 ((63682 #t beta "iota sigma" 8) zeta "rho theta" "eta sigma" (689.67 "phi kappa" 9 omicron)) -36374 (#t gamma)) 2284 "zeta nu" ((738.691) #f 75286) "kappa omicron" (#t (8) mu) (76600 (-23618)) 213.993 (4 3473 ((7) 42705))))
+
+(define (f76 beta eta)
+  (if (< beta eta) (+ beta 75) (+ eta 11)))
+(define d76 '((414.659 40.903) 89624 96619 (xi 6 ((840.27) (omicron) 857.611 -35936 ("iota kappa" 1 62806)) (epsilon (-67711) (#t #f #f 964.220 #t) mu) -75824) 82299 (6 alpha ("omicron omicron" (-69457) (-88949 36382 xi #t))) "gamma mu" (786.223 nu) "sigma tau" #f))
+
+(define (f77 rho omicron)
+  (if (< rho omicron) (* rho 82) (* omicron 18)))
+(define d77 '((((tau) #t 488.883) ((-44436 phi -73137 "alpha phi" 5) (upsilon) 87341 (412.774 9 #f) (9 "gamma sigma" 5)) #t -22823 4) ((301.799 "xi upsilon") (46252)) "delta pi" (((532.621 5 2) (alpha))) (((alpha 415.604 #f 44340 "nu omicron")) ("omicron delta" (5 -33958)) (246.601 (beta 489.770 75037) ("gamma beta" "sigma eta" 833.626 -87440)) (#t 1 "omicron zeta" (7 51.747 iota "pi pi" "zeta beta"))) (((#f 95523 "xi beta" #t) (#f 203.207 -65223) (207.353 "delta pi" 21701) 694.104) 0.388 "theta sigma" ("tau upsilon" (458.76 #f 90313 #t) "kappa sigma")) 13025 -38001 delta #t))
+
+(define (f78 pi rho)
+  (if (< pi rho) (* pi 65) (* rho 21)))
+(define d78 '((654.94) (104.643 #t ((#t 895.842 35082 omicron) 586.768 29191) ("xi delta" 5554 ("sigma epsilon" -4295 "tau epsilon" 184.229) (3116 alpha #t) (37058 74.584 #f 46152)) (9 #t -13262)) (((4 305.903 8 -25665 #f) ("gamma nu")) (("eta tau" 26.956 xi 1) (#f #f 857.854 #t)) 68638 #f (alpha ("xi phi" "upsilon beta" -55981))) 2 iota #f (#t (("theta eta" #f gamma zeta rho) xi)) #f ((#t 1) ("sigma iota" (#f iota 313.643 #t 26148) (5 -77453))) (-14739 -14340)))
+
+(define (f79 mu eta)
+  (if (< mu eta) (+ mu 27) (+ eta 93)))
+(define d79 '(#f #t ((#t) (-90775) (#t (58615 775.489 epsilon 8 xi)) 957.338) (upsilon "tau pi" 141.504 (tau (mu #t phi 81713 alpha) -89671 nu (74.981 -14547 -45384 rho 648.648))) 698.102 sigma "xi upsilon" (433.459 ((764.6 #f 37842) 724.556 (856.64) 2) phi "alpha gamma") "iota rho" #f))
+
+(define (f80 alpha tau)
+  (if (< alpha tau) (+ alpha 98) (+ tau 60)))
+(define d80 '(74366 921.358 iota (("epsilon upsilon" (33936 "xi tau" 2890) 735.450) ("eta eta" 948.578 (-14588 590.978) ("zeta delta" upsilon theta 242.918 theta)) (#f "pi rho" "kappa theta" (upsilon "phi delta" "phi upsilon" 584.178 56.339) 7)) (epsilon) ((28.831 (xi) (38.904) 7 (#f 709.757 sigma 652.547)) 96767 (kappa) "gamma upsilon" ("gamma nu" (#t 2) (-20626 sigma #t) (#t -61941 749.155 120.887) (54.117 -69609 "delta epsilon" -68292))) (sigma) (#t 441.389) 0 sigma))
+
+(define (f81 delta epsilon)
+  (if (< delta epsilon) (- delta 22) (- epsilon 12)))
+(define d81 '(46377 (alpha (("epsilon alpha" 3) (94540 -43740 #f) #t) ((434.957) tau) epsilon -32012) ("beta omicron" #f) "iota beta" #f (#f) 880.288 -10245 847.899 (beta)))
+
+(define (f82 theta beta)
+  (if (< theta beta) (+ theta 2) (+ beta 78)))
+(define d82 '("rho upsilon" (phi "upsilon nu" "zeta theta" -64124) (-71018 -68934 (27.825 (17788 28184 0 90516) (0 beta 520.43 -35381) 340.81 (#f "zeta delta" -95431))) (#f "phi iota") 123.574 687.822 ((("xi omicron" -7402 #t "alpha beta") xi) -18578) (-69466 7 beta upsilon 1) ((-16988 (#t) (#f 7 -47922)) "delta omicron" #t) "delta epsilon"))
+
+(define (f83 eta rho)
+  (if (< eta rho) (- eta 6) (- rho 62)))
+(define d83 '(theta 780.330 754.705 ((("alpha gamma") ("epsilon alpha" 35153 #t) -58488 (delta) (-38341 9 #t 16511 8)) ((43292 kappa 776.123 sigma 584.450) (41321 -31974 "rho mu") -52859) ((69856 523.912 #t) (#f "upsilon rho" -29973 theta) (52299 omicron #t) #t) "nu delta" ((58530 phi 3 #t) #t -59906 (955.364))) ((#t #f #t (xi 7 "alpha phi" -21384)) 53746) (#t ("omicron alpha")) 44.940 #t -56596 kappa))
+
+(define (f84 rho epsilon)
+  (if (< rho epsilon) (- rho 15) (- epsilon 78)))
+(define d84 '(beta (#f ((35210 phi 0 5042) #t "iota omicron" -40632) ("xi iota" 8 (6 "kappa sigma") gamma #f)) (2) ("nu theta" ((24382) -40476 (#t 420.999 102.527 nu "rho alpha") #f)) (#t "xi iota" ((-14312 zeta mu rho) (49739 mu 800.518) (877.801) "xi epsilon" (kappa "mu phi"))) (((121.179 986.780 "rho rho" 782.323)) (-53633 -75805 4 (99358 #t #f #t))) ((-28384 "iota zeta" (-56845 #t "mu theta" 6)) 5) sigma 126.687 (nu ("iota kappa" (epsilon -70797 157.957) (9 "phi gamma" "eta theta" 501.173)))))
+
+(define (f85 alpha eta)
+  (if (< alpha eta) (* alpha 68) (* eta 48)))
+(define d85 '((((59053 846.42 33.395 332.736 273.639) (alpha 34926 "pi rho") #f)) 285.260 iota 39391 5 #t #t (#t 8 6) ((906.908 (rho 857.490 "epsilon iota" -76528 8) (926.208 606.460 243.581) (#t 966.902) (0 171.149)) -96094 910.2 #f) -88123))
+
+(define (f86 alpha sigma)
+  (if (< alpha sigma) (* alpha 76) (* sigma 85)))
+(define d86 '(((-22544) "gamma kappa" 919.566 theta) (((#t "upsilon mu" -90860))) 19811 ((mu) (-13124 14271 "omicron iota" 69687 kappa) ((17183 4549)) (#t -3719 (#f "tau upsilon") (#t 6 #f "phi gamma") upsilon)) pi ("alpha phi" -77200 pi ((gamma 99505) (963.74 mu 20735 gamma 499.303) 802.76 #f #t) 166.144) (#f nu 107.843 (-16387 #t (rho 0))) "theta mu" 20417 285.867))
+
+(define (f87 rho zeta)
+  (if (< rho zeta) (* rho 20) (* zeta 71)))
+(define d87 '((27264 #t (429.74 #t -7875 (#t))) ((("gamma beta")) ((#t "gamma omicron" -98794 gamma) (5 816.581 "upsilon tau" "nu epsilon" rho)) ((#f) tau -90689 -59701) #f) 70.479 ((#f (6333 #t) (3 tau #t 391.943)) (553.48 16789 ("nu pi" gamma "zeta eta"))) ((("kappa alpha" #t -73755) #t (pi) (172.649) #t)) gamma ((upsilon -97228)) "beta gamma" eta (((#t 29056 "eta epsilon" #f 5) 682.769 ("kappa phi")) alpha)))
+
+(define (f88 eta upsilon)
+  (if (< eta upsilon) (+ eta 0) (+ upsilon 35)))
+(define d88 '(-43767 9 (4 ((2 931.382 epsilon)) "gamma beta") "upsilon upsilon" 4276 (6 beta ((733.911 583.868 #t "rho pi" 342.335) 648.356) ("mu iota") "zeta kappa") #t (((315.338 -96007) ("beta nu") #f 14.155 ("pi theta")) ((pi 8 #t) #f -39460 (816.8 468.378) 79.261)) "alpha phi" "delta gamma"))
+
+(define (f89 nu zeta)
+  (if (< nu zeta) (+ nu 91) (+ zeta 96)))
+(define d89 '((101.662 (1 (upsilon -70623 548.380 1))) (((65 85815 theta #t) "phi epsilon" #t (beta #t "zeta alpha")) 3 640.948) (60.258 rho) (((upsilon) (753.642 36.649) -27387 (133.734 epsilon) (42.920)) ("mu beta" "eta alpha")) (#f) xi ((79250 612.91)) 23122 #t (-30881 #t (#t (#f omicron "pi beta" "epsilon gamma") (-20519 kappa "omicron xi" phi) (alpha #t)) 866.172 "delta gamma")))
+
+(define (f90 kappa epsilon)
+  (if (< kappa epsilon) (- kappa 27) (- epsilon 52)))
+(define d90 '((((78042 0 #t) (741.318 72494 "iota theta" theta) (910.374 tau 266.972) 80754 85180) (-1995 ("xi upsilon" "mu pi" mu) ("nu upsilon" xi #f) (epsilon) kappa) 0) 4 zeta (upsilon pi 13.464 (upsilon (-25050 tau 811.918) "delta kappa") (18700 ("theta delta" -92139) 29940)) (((#t) (214.371 zeta #f "beta delta" 890.663)) ((227.926 "epsilon upsilon" omicron "alpha delta")) 69267) (((mu) (495.876) (327.474 122.435) theta) ((#f -47976)) "phi nu") 530.794 57530 (((phi 931.240 655.709) (3 1.294 "theta nu" 433.437) beta -87167) (398.621 32557 (-96289 405.102) 3) (("iota tau" "rho eta" epsilon 707.156) 941.729) 97756 ((2 182.751 "beta xi") #t 2134)) "theta gamma"))
+
+(define (f91 delta tau)
+  (if (< delta tau) (+ delta 34) (+ tau 50)))
+(define d91 '((6.497 ((#t -42394 410.676) xi) "nu xi" rho) iota (("iota gamma") mu) 49310 ((("tau rho" 61.488) (445.999 -81357) (-60765 585.249 "phi xi" #f) #t)) "rho rho" #t "alpha pi" (((860.652 #t 65141 kappa 9) 127.148 53640 -8485 "iota kappa") ((-99688 #f #f) 7 gamma 394.911) -32647 (361.322) (#f ("pi gamma" #t "theta mu" upsilon -53012) -57661 "omicron eta")) 80.873))
+
+(define (f92 mu kappa)
+  (if (< mu kappa) (* mu 79) (* kappa 71)))
+(define d92 '((((305.995 kappa iota phi) 9 3) ("kappa theta" (alpha #t 5) 7) ((#f 106.990 #t 117.881 25548) #t "nu mu" #t -88752)) #f -61103 ((delta) -46513) ("nu sigma" (5 (#t #t tau mu) 86.74 #f) 303.911 "zeta epsilon") 199.317 271.416 -95094 "upsilon omicron" "tau alpha"))
+
+(define (f93 beta tau)
+  (if (< beta tau) (* beta 40) (* tau 90)))
+(define d93 '(((#t ("pi kappa") eta) (beta #t #f)) zeta zeta 532.156 (-64757 #t) -39780 259.418 92430 ((("epsilon rho") (theta -54503 eta) 932.236) ((-43172 47.130 "gamma upsilon" -76180) 980.167 (beta "iota tau") 24855 (omicron #f tau "epsilon rho")) (-52846 0 (4 #t 462.587)) ((-87641))) "sigma beta"))
+
+(define (f94 theta nu)
+  (if (< theta nu) (* theta 70) (* nu 53)))
+(define d94 '((19122 (64961 (54076 4 5 29496 145.927) "iota theta" "zeta zeta") epsilon "zeta xi" ((930.199 81496 207.999 pi) (7) ("alpha zeta" phi #t))) ("rho iota" (163.970 (zeta "rho mu" 933.367)) ("nu tau")) #t ((delta "eta beta") mu ("theta pi" (846.637 43.441) iota (#t) -41533) (#t) (-53659 (800.78))) sigma (("tau omicron" "kappa alpha" 1 #t epsilon)) ("zeta upsilon") (#t ("xi kappa" (56183 222.303 60042 "epsilon zeta") 17.312 (4) -26232) ((-76395 #t "upsilon phi" 4 70836) 113.753 -42502 (723.2 eta #t 893.98) -14374) (3 (947.427 2 #t) #t)) ((3 (219.834 32555 65440 "zeta xi")) 444.565 -99785 (#t (8 zeta 1 6446 "rho xi"))) 10753))
+
+(define (f95 nu upsilon)
+  (if (< nu upsilon) (+ nu 0) (+ upsilon 81)))
+(define d95 '((theta (#f #f (3 rho 87745 718.400) "tau xi" (#t 315.631 #f 4 16480)) ((rho #f gamma #f 0) ("iota tau" #f 33446 #f)) "theta kappa" ((8 "kappa upsilon" kappa) 2 (zeta -57002 "beta xi" #t) #f nu)) 0.569 ((tau) ((45052 14.152 "nu alpha" 47.695) "xi delta" (17.933 xi 4 "tau kappa" 0) (#t) -91814) 437.381 (kappa) epsilon) (mu) (((-955 119.331 #f) ("zeta zeta" 127.623) 220.954 (-32205 "xi kappa" nu)) (98.868 (alpha -64040) eta #t (969.93 87991 945.797 "rho zeta")) tau ((tau 598.684 epsilon delta #f) 17604) beta) -4771 -32282 iota eta 304.448))
+
+(define (f96 sigma kappa)
+  (if (< sigma kappa) (+ sigma 59) (+ kappa 15)))
+(define d96 '(upsilon kappa (theta #t #f 80454 #t) 34474 2 491.556 -25226 (-17829 "kappa omicron" 948.335 ((#t "eta kappa" "rho gamma" "xi zeta" "upsilon gamma") ("epsilon upsilon" xi) (beta #t -87359 #f) 39274)) (41637 (zeta (#f 7 574.932 "mu upsilon") 2 (73.451 "tau phi" -63914 3 "gamma pi") upsilon) mu) ((535.400 (653.30)) #f (("tau gamma" upsilon 93433 #t #f)))))
+
+(define (f97 mu epsilon)
+  (if (< mu epsilon) (* mu 54) (* epsilon 54)))
+(define d97 '(((sigma 97799 (eta)) "alpha delta") 806.598 981.878 #f nu "beta upsilon" 5 ((-64446) "eta xi" sigma "xi epsilon" (sigma)) ((0 tau) "gamma nu" (88.666 "xi theta" (delta theta 0 #f "alpha zeta")) "xi omicron") 302.181))
+
+(define (f98 sigma gamma)
+  (if (< sigma gamma) (- sigma 32) (- gamma 32)))
+(define d98 '("gamma beta" (((342.548 omicron -2141) (#t) 8.270 "eta omicron") #f (#t (6 "rho xi") 0) #f (mu (851.851 #t 18885) 21.657 (-72303 beta 604.515 32974 #f) (749.239 rho delta))) 58608 -8484 "alpha zeta" "epsilon nu" 993.40 (((0 "pi epsilon") gamma)) "upsilon iota" 163.277))
+
+(define (f99 nu theta)
+  (if (< nu theta) (* nu 82) (* theta 9)))
+(define d99 '("phi kappa" 147.768 "alpha upsilon" ("iota upsilon" 181.382 "kappa epsilon" -30528 (-71720 #t)) "sigma omicron" "eta beta" 559.408 57.956 (theta) "epsilon gamma"))
+
+(define (f100 upsilon nu)
+  (if (< upsilon nu) (+ upsilon 52) (+ nu 69)))
+(define d100 '(("phi mu") 29743 upsilon (((71533) 95.111)) "upsilon beta" ((122.25 (omicron "delta upsilon" 24246) (416.55 844.230 epsilon 95.663) 350.185) #t 52919 "rho zeta") -45411 ((945.133 70798 tau) 276.970 upsilon 208) -72134 (#t)))
+
+(define (f101 zeta omicron)
+  (if (< zeta omicron) (* zeta 51) (* omicron 96)))
+(define d101 '(((6 ("beta alpha" kappa) 34000 (1 28632 #t -86801)) #f ((tau "iota pi" 32165) 587.988) iota 731.876) -56354 "epsilon alpha" alpha (-95236 "theta kappa") (1 8 (("alpha alpha") (840.240) "eta pi" (7 1765 kappa 43553 xi) -93956) (255.444 89533 (37203 gamma 5 2) (-50426 -82066 theta) "alpha pi")) 9 #f 733.54 #f))
+
+(define (f102 alpha epsilon)
+  (if (< alpha epsilon) (* alpha 98) (* epsilon 69)))
+(define d102 '((668.227 #t "epsilon beta" #f epsilon) eta 973.952 "alpha alpha" 634.96 ((("gamma zeta") (-24801 "delta beta" #t) "omicron alpha" 575.248 "gamma alpha") 205.925 "gamma nu" 71668 (("omicron mu") kappa -19926 ("theta kappa" -71932) (rho 987.749 265.240))) "gamma rho" (delta ((33532 "xi nu") (282.78 #f "sigma iota" rho)) 73641 67539 -90432) 33761 #f))
+
+(define (f103 epsilon phi)
+  (if (< epsilon phi) (+ epsilon 40) (+ phi 34)))
+(define d103 '(("xi tau" -60465 "iota phi") (upsilon ((-67567 #t 39249)) 2.877) (upsilon ((38473 6 "xi iota" -8954 -88534) 834.899 672.767 253.883 "beta kappa")) (508.145 #t (107.608 9) (beta) ("delta theta" "delta upsilon")) (65240 ((0 52524 "sigma mu") (-45990)) (2 "zeta tau" "sigma alpha") "phi beta" ("delta omicron" 1 132.915 9)) (40371 theta "tau delta") (tau) #f #t kappa))
+
+(define (f104 eta epsilon)
+  (if (< eta epsilon) (+ eta 50) (+ epsilon 23)))
+(define d104 '(2420 ((("alpha xi" gamma -35537 epsilon) 92885 "kappa epsilon" 25918) (70073 zeta) 719.766 (591.140 sigma -97322 93616 -95945)) 47.150 -1157 tau (236.683 ((-75497 -68939) ("iota epsilon" #t 565.345) -64135 17713 (239.606 7 iota)) 99865) (751.392 kappa iota "pi epsilon" 15747) "eta beta" ("iota rho" 492.680 (kappa (909.452 -20908 pi "beta zeta" iota)) (("zeta tau" beta "iota epsilon" "eta epsilon") 85180 eta (366.618 6 "phi beta" -30992))) 6))
+
+(define (f105 theta zeta)
+  (if (< theta zeta) (+ theta 88) (+ zeta 42)))
+(define d105 '((alpha (("gamma mu" "omicron iota" eta omicron) "sigma phi" (iota 53798 -36761 #t) ("epsilon pi" 61.723 493.105 21841) (28927 58.798 #f tau))) #t 11366 (191.30) (((zeta) (-84128 -81270 -43368) (456.908) (-23663 189.423 259.938) #t) (pi 937.568 980.576 "mu iota") phi (3 (776.505 -58040) (356.667) #t "omicron pi")) zeta 566.659 602.500 #t 32557))
+
+(define (f106 tau omicron)
+  (if (< tau omicron) (- tau 0) (- omicron 53)))
+(define d106 '(((0) ((190.790 kappa)) ((0 356.980 177.6) (-59640 nu))) (345.290) -40746 (#f ((301.870 606.436) #f) ((iota #f) (9 -69093 "xi eta" "kappa upsilon" 67.928) 609.793 ("mu phi") (405.457)) 102.493 "epsilon omicron") (683.873 "iota xi" 718.26) (27.4 ((epsilon 170.722 theta alpha eta) (-21485 35639)) ((pi 383.709 157.994 3) (1 -20699 "rho beta") "upsilon eta" (9 -6161)) ("tau kappa")) (5 sigma #f) (18.757 "rho epsilon" (882.798 (53512 #t alpha)) ("zeta kappa" #t (-76240 811.166 gamma) 2 58724)) ("beta epsilon" -31246 ((omicron) 25098 (629.76)) 50712) eta))
+
+(define (f107 tau zeta)
+  (if (< tau zeta) (+ tau 20) (+ zeta 38)))
+(define d107 '((#f) (38641) "beta mu" "delta omicron" ("epsilon xi") #t theta 277.433 "epsilon theta" (((#f) (732.101 kappa 470.182 "sigma nu")) "beta omicron")))
+
+(define (f108 eta iota)
+  (if (< eta iota) (* eta 37) (* iota 23)))
+(define d108 '((((delta "alpha gamma" "phi phi" 306.714) 293.573 iota (224.275))) eta "upsilon iota" -56614 tau 387.862 (("zeta eta") gamma ((mu zeta)) theta) #t ((-31358 ("delta kappa"))) #f))
+
+(define (f109 iota eta)
+  (if (< iota eta) (- iota 6) (- eta 50)))
+(define d109 '(("nu omicron") "pi epsilon" (((gamma) 9 -60901 590.863) #f "tau xi" 372.421) (-40260 ("upsilon sigma" 3902 "eta alpha" (43653 752.187 "upsilon iota" 0)) #f phi) (586.424) 713.527 ((mu (848.120 -31224 6) ("alpha omicron" 859.62 "zeta upsilon" 24404 #t) (76397 #f 428.719 791.823 19941)) (phi) "upsilon kappa" 735.712 ((980.334) #t)) #f "phi zeta" tau))
+
+(define (f110 pi eta)
+  (if (< pi eta) (+ pi 47) (+ eta 33)))
+(define d110 '((theta ((831.55 22135 8602) 1283 (-9891 #t upsilon) (#f "beta delta") #f) (-46631) 0 ("epsilon sigma")) "tau zeta" ((73149 (#f 656.662 gamma #f) ("delta zeta") (46137 860.17 19613 944.431) iota) phi 657.259) #t 92881 (eta 53502) 979.228 9.187 ((("pi alpha") theta 864.783 (theta "iota sigma" #f)) ((sigma -7653) ("theta sigma" "omicron epsilon" 236.438 "pi phi" #f) (upsilon 138.766)) zeta) ("upsilon phi" "omicron xi" "upsilon upsilon" 913.353)))
+
+(define (f111 xi upsilon)
+  (if (< xi upsilon) (* xi 84) (* upsilon 19)))
+(define d111 '(((tau ("rho pi" omicron -35235 50.535) (97.335 3 412.10) -24085 "xi epsilon") ((873.34 #t -46490)) #f #t #f) (303.930 #t 344.851 #f) 63154 ((#t (900.4 theta 17589) (6 "epsilon kappa" -18835 rho) 325.230) (#f 30076) 657.173 beta 98592) (((9 528.495 "beta eta" 829.300 iota) (-28977 16373 #t)) (("omicron mu") #f (gamma 984.673 #f xi beta))) ((nu 91081 ("iota iota"))) (theta (("alpha beta")) #t ((99528) #t 0) "xi zeta") (tau) (((401.329 gamma "kappa omicron" 887.208 omicron)) -50226 (31894 ("rho beta") #f (78126))) ((theta) 697.876 (-12107 5 819.408 -70788) ("zeta epsilon" 615.926 24793 nu) (39414 (81.454 xi) (590.278 "xi omicron" "zeta theta" #t -63859)))))
+
+(define (f112 xi gamma)
+  (if (< xi gamma) (* xi 68) (* gamma 38)))
+(define d112 '(rho ("sigma xi" 3119 "xi theta" -2754) 1 ((-97130 (-56771 654.29 23.622 705.204 "nu upsilon") #t (992.401 #f "nu rho" iota #t) #f) (-67401 (#f sigma mu "zeta zeta" epsilon) #t) "xi alpha") "delta omicron" (17347 "epsilon omicron" (361.818 (-81387 697.4 695.743) (-17154) sigma)) -2111 kappa 604.334 #t))
+
+(define (f113 xi iota)
+  (if (< xi iota) (* xi 95) (* iota 46)))
+(define d113 '(pi (((9)) xi (45156 phi #f -1892)) (((42098 68398 167.26 "rho theta") 706.723)) (215.579 (-51230 (835.404 "xi phi") ("rho theta" 229.738) epsilon) 702.186 -34107) (#t) (epsilon rho) ((("mu mu") (epsilon 16015 9)) #t "kappa theta" 188.792 (("eta eta" "sigma beta" "kappa rho" "alpha eta") (-12167))) ((gamma (beta) "iota alpha") (sigma "omicron epsilon" 12643 (723.414))) 5 ((("iota mu") (3 7 4 phi #t) (alpha #t "kappa eta" 998.604 "delta epsilon")) 9 ((-13612) (257.16 -52172 "zeta epsilon" 8 "kappa zeta") ("sigma rho" 8) 209.461 #t) #t)))
+
+(define (f114 xi sigma)
+  (if (< xi sigma) (+ xi 49) (+ sigma 89)))
+(define d114 '(714.740 xi 9 (sigma "phi iota" (#t ("delta beta" 50452 "gamma xi" -74060) mu (mu #f rho 260.481 -98205))) #f "sigma epsilon" -6307 "nu iota" 179.913 iota))
+
+(define (f115 gamma sigma)
+  (if (< gamma sigma) (* gamma 78) (* sigma 60)))
+(define d115 '((206.541) #t 856.325 ((418.198 #f 524.658 46.816)) (#t) ((0 ("phi rho")) ((epsilon -45017) 4 beta xi (0 586.257 upsilon #t)) (#f -38851 (#f #f epsilon) 47723)) (#f delta ("iota sigma") (2 6)) delta (172.994 (("phi iota" "rho kappa" 101.869))) ((3 (#f) 301.797 "nu mu") (("epsilon theta" 225.669 "phi sigma" -60285 482.695) ("mu iota") ("beta tau" "pi upsilon" gamma "omicron rho" 607.537) 8))))
+
+(define (f116 beta pi)
+  (if (< beta pi) (* beta 26) (* pi 59)))
+(define d116 '(upsilon "phi beta" (#t 3 #f) -59223 (243.607 -52708 0 (#t)) ("delta sigma" (("xi phi" -87660 224.492 #t)) #t 6 "beta theta") (pi) "sigma theta" ("alpha rho" -55224) (mu (-6290 37572 3))))
+
+(define (f117 iota phi)
+  (if (< iota phi) (- iota 5) (- phi 39)))
+(define d117 '(#t -18378 "beta delta" ((("delta mu" "tau phi") 52772 (#t iota #f "upsilon kappa")) 839.790) "kappa alpha" 960.137 ("sigma eta" ((615.931 678.449 6 727.38) -13119 (232.179 "nu gamma" tau)) "xi alpha" ("rho iota" -9462)) (gamma (#f -11744 919.169 6034) ((-40251 iota "beta upsilon")) 3 "kappa alpha") ((theta ("nu alpha")) (119.571 ("delta phi" "omicron omicron" -63418 "theta iota") -64761 (275.628 -81029) ("tau theta" "nu phi"))) ("phi gamma")))
+
+(define (f118 mu epsilon)
+  (if (< mu epsilon) (* mu 38) (* epsilon 35)))
+(define d118 '((61685) 795.878 "kappa xi" (((44070 "epsilon xi" #f "phi mu") 654.187) "xi iota" ((#t) (851.959 kappa tau) 184.546) ((979.239 iota -2013) (152.366 upsilon 7))) (-24106 kappa) "omicron omicron" 53.715 sigma 89552 ((#f) -34420 "tau omicron" -96125)))
+
+(define (f119 rho tau)
+  (if (< rho tau) (+ rho 70) (+ tau 58)))
+(define d119 '(6 "kappa epsilon" "beta omicron" ("upsilon eta") -2408 ((-86161 -51499) ((77020 172.295 -24169) ("beta delta") mu (5328 210.869 131.138 beta theta))) (48.381 -74938 ((262.547) 589.103 372.185 -43724 #f) ((zeta kappa "alpha zeta") #f 763.55 (447.768 "theta iota" #t 364.414 -12285)) ((upsilon rho "zeta nu" 0) (rho theta #t "iota xi") theta 9)) (#f ("rho upsilon" -11198) 656.468 ((iota omicron #t 8254 "tau epsilon") "upsilon theta" (8863 689.969 3193 3 -35816) 485.133)) "zeta alpha" ("rho tau" ((upsilon 125.292)) 606.786)))
+
+(define (f120 kappa pi)
+  (if (< kappa pi) (- kappa 23) (- pi 41)))
+(define d120 '(((nu (612.111 9)) (4)) (("xi kappa")) (((#t) #t "delta zeta" #t)) 581.616 #t 278.995 "omicron rho" ((-26221 8 -81347) ((tau) "alpha kappa" (-93469 zeta -60542 "omicron delta" 0) (298.147 264.513 kappa 61.214 11533))) "upsilon delta" #t))
+
+(define (f121 tau xi)
+  (if (< tau xi) (+ tau 10) (+ xi 41)))
+(define d121 '((((801.722))) alpha ((8) -68745 7) 930.496 (("rho sigma" "kappa omicron" -37389 ("kappa phi") (#t 121.356 -80042 -12047))) 7731 (("tau iota" (zeta "kappa gamma" kappa)) 85489 9 (omicron sigma (-91972 #f "eta nu" #t 459.653) ("epsilon nu" -32108 24888 -78242) delta)) (("zeta iota" #t ("omicron tau") (27365 7.483 513.737))) zeta 565.151))
+
+(define (f122 zeta phi)
+  (if (< zeta phi) (* zeta 19) (* phi 36)))
+(define d122 '(rho 538.197 9 -28456 #f (84688) 355.683 eta "epsilon zeta" (((rho 56970 #t #t)) delta (60763 805.780 71910) "tau omicron" ((87.656 #t) 774.352 0))))
+
+(define (f123 theta pi)
+  (if (< theta pi) (* theta 74) (* pi 98)))
+(define d123 '(99.227 ((841.737 #f (rho #f 42798 589.916 "phi omicron") (epsilon)) #t 1844 "theta theta" nu) -78244 454.424 428.679 ((theta ("xi phi" #f "rho zeta" 39330 246.761) zeta #t "epsilon kappa") mu "phi delta") mu #f "upsilon xi" zeta))
+
+(define (f124 nu pi)
+  (if (< nu pi) (+ nu 30) (+ pi 97)))
+(define d124 '(635.813 #f 868.84 2 -26722 619.445 #t 27237 614.142 ("pi tau")))
+
+(define (f125 zeta delta)
+  (if (< zeta delta) (- zeta 87) (- delta 30)))
+(define d125 '((486.879 (839.363) (600.160 tau) (46.428 #t (#f 58257))) 69378 #f 188.861 rho nu ("upsilon phi" (nu (84.985 "pi tau")) (pi (61202 eta) ("rho omicron"))) (zeta (50863 83577 ("gamma phi" 251.70 "rho tau" "alpha xi") (343.251 700.497 upsilon 387.838)) (("gamma gamma" 620.319 -92420) (theta 9) 719.714) 265.447) #f (((3) upsilon eta (-27966 1668) ("kappa zeta" 892.908)) 499.187)))
+
+(define (f126 iota mu)
+  (if (< iota mu) (- iota 28) (- mu 31)))
+(define d126 '(xi "phi rho" (4 285.833 (("epsilon mu") "upsilon epsilon" (#t 10546 "omicron rho" 757.327))) (263.701 (#f alpha) 299.914 #f ((382.119 beta 235.665 95.299) 792.248 710.57 ("rho xi" "alpha xi" 687.143))) (-70424 904.812 ((4)) (tau 433.869) #t) (#f 82796 -12033 ((#t omicron -70188) (gamma 383.51) (kappa)) "nu sigma") (-43184) ((-83944) theta "xi sigma" 853.338 -28058) 488.317 sigma))
+
+(define (f127 beta eta)
+  (if (< beta eta) (+ beta 79) (+ eta 81)))
+(define d127 '("sigma mu" "delta rho" (-76090 ("delta xi" (495.718 -72029 "omicron sigma" -77669 "xi pi") 3 "gamma rho" (tau 261.365 54157)) pi (theta (#f "epsilon delta" "mu tau" tau "omicron tau") 4.834 (#t "zeta rho") (261.324 beta 895.530 omicron))) 4.823 963.937 #t ((("rho pi" -68315) (epsilon "sigma xi" #t -61616 733.878))) 302.691 909.694 (((98545 "delta upsilon" "delta xi" #f) ("kappa beta" "sigma theta" alpha epsilon) epsilon (eta 3 51900 theta)) (kappa) 431.51)))
+
+(define (f128 delta mu)
+  (if (< delta mu) (- delta 81) (- mu 75)))
+(define d128 '(beta ("epsilon omicron") #t 9 pi (#t 8 "gamma phi" upsilon #f) 6 theta ((("omicron nu" #f iota 2))) 297.2))
+
+(define (f129 beta phi)
+  (if (< beta phi) (* beta 94) (* phi 86)))
+(define d129 '((-77362) "alpha mu" 46663 (507.898 747.58 ((390.612 831.13 -85094) (#t "sigma delta" tau 539.659 343.715))) (2) ((("omicron gamma" "xi zeta")) 34177 (690.650) -8567 ("iota pi" (75.848 -90475 3) (#f 7) 96.571 (683.432))) ((("omicron rho") ("xi epsilon") (418.949 8 -76989 "zeta pi" 606.162)) "omicron pi" 0 ("gamma xi" (9 #t #t))) (331.349 ("mu phi" (3 #f 86274 delta) ("mu rho") (604.980 xi)) 40085 69944 sigma) 70783 -98857))
+
+(define (f130 phi zeta)
+  (if (< phi zeta) (- phi 34) (- zeta 76)))
+(define d130 '(("tau rho" "beta theta") ((348.648) 6) zeta (#t) (417.619 66196) (-96425 ((zeta) (#f alpha rho 68296) (#f "iota beta" #t) iota) (-26420 "tau tau") (3 (tau 677.962 6) "rho eta" "kappa sigma")) 30.881 (#t (791.905 (kappa "phi mu" -6669 mu beta) ("zeta alpha" 287.176 3 "pi theta" "epsilon upsilon") alpha -83371) tau (705.713)) (((351.232 930.475 844.229 #t -70725)) upsilon 410.366) "iota epsilon"))
+
+(define (f131 tau omicron)
+  (if (< tau omicron) (* tau 48) (* omicron 23)))
+(define d131 '((37251 541.197 (gamma "beta phi" (delta))) nu ((("epsilon rho") 8981) 452.256 866.88) ("zeta omicron" -54440 (1) (54443 (85.617) (945.633 14249) (86719))) 9 936.693 (-54586 (847.794 #t) gamma (phi (78132 804.739 261.135 pi))) 620.624 kappa (((662.306 #t -90004 680.599 77787) (699.598 "phi epsilon" gamma)) (("epsilon phi" 91667 839.633 55635 "upsilon gamma") ("omicron rho" -5895 #f nu)) ((57.260) -97287 ("sigma theta" #t) (-55410 #f -37678) (#f)))))
+
+(define (f132 omicron pi)
+  (if (< omicron pi) (* omicron 44) (* pi 38)))
+(define d132 '((("tau sigma" -36146) (-87295 (287.384 #t -38391)) #f (3 ("theta omicron" 550.578 70003 "theta xi")) (("omicron rho" -93936 -32635 -86800 19734) 275.574 71497 (221.469 gamma 1 nu omicron))) ((57296 "rho gamma" "delta sigma") 866.435) xi "xi pi" -2416 469.100 7 -56518 ((("xi zeta") 744.223 -81226) ((-1803 #t #t) (-34398 "tau upsilon" #t #t) tau #f)) (((1 "beta xi") 286.65 beta 592.96 "zeta epsilon"))))
+
+(define (f133 sigma zeta)
+  (if (< sigma zeta) (- sigma 61) (- zeta 15)))
+(define d133 '(-77062 "upsilon xi" ("sigma phi" ((upsilon #t 109.502 tau omicron) 44937 (13421) 647.820 (96.417 -55918 nu)) 762.887 (phi)) "tau sigma" 3 ((2 658.843 11678 (117.398 431.943 78.481) (#t #t 615.365 sigma #f)) ((-59854 eta 148.932 delta gamma) (64980 rho)) ((723.192) -68146) (#f 740.791 (xi 58101 "phi xi") phi) 6) ((644.284 (#t) (336.666 9716 -82557 986.636) "pi alpha" 123.490) ((661.174 delta) (830.828 189.751 kappa 42679 kappa) tau) (-58754 (alpha pi) -69063)) (-11825 alpha (rho 8 (kappa 307.858) 79405 (394.880)) -92880 (#t (66244 491.391 "upsilon omicron" 583.355 #t) (3))) ((301.2 524.762 "eta eta") (975.243 "nu delta" (4 "nu kappa" 744.575 2 17903) alpha (8 #f -34795)) ((330.615 "xi mu" "delta tau" -90135) (563.520 956.281 6 "omicron pi" #f) "delta pi" ("upsilon beta") phi) -78821 817.536) "delta mu"))
+
+(define (f134 xi rho)
+  (if (< xi rho) (- xi 53) (- rho 55)))
+(define d134 '(((#t)) (iota (992.988 "upsilon sigma") mu ((#f -64424 zeta "gamma rho"))) (((-65908) 551.331 (773.385 sigma 64937 529.662)) 776.766 0 sigma 88767) ((6 #t)) (((#f 396.335 -49065 259.311) (xi 6)) (1 ("omicron gamma" 17569)) ((pi "zeta omicron" "theta xi")) beta #f) (((sigma 601.362 "pi iota") (487.398) #f) 23.981 (-19227 (-80069 "eta eta" #t) (beta) (#t mu omicron))) zeta (((-31783) #t 834.315 (-79379 8 "mu gamma")) 79004) ("iota xi" kappa "gamma sigma" (-26426 ("tau epsilon" 94084 377.413 #f #f) (91363 508.432) ("theta phi")) 936.159) -7056))
+
+(define (f135 gamma eta)
+  (if (< gamma eta) (+ gamma 68) (+ eta 49)))
+(define d135 '(rho 218.565 (#t) kappa (#f) 938.739 7 gamma "omicron kappa" (-46579 940.375 8.144 eta)))
+
+(define (f136 iota omicron)
+  (if (< iota omicron) (- iota 68) (- omicron 10)))
+(define d136 '(8 710.121 #f (#f ((nu -1227 #t 54034 #t)) 91978 983.545 xi) 720.621 (105.705 ((54043 -54548) epsilon 302.92)) ((-12880) (-83545 -50243 kappa) "tau gamma") (((4 pi "theta kappa" delta) (-62944 #f) 9307 62037 (82130))) ((#t) ((427.844) 155.703) "nu xi" "phi upsilon") (646.277 95495)))
+
+(define (f137 alpha phi)
+  (if (< alpha phi) (- alpha 72) (- phi 29)))
+(define d137 '(rho 564.642 161.149 "iota tau" "epsilon iota" (-62056 (922.734) ((85203 #t -24494 810.957 alpha) kappa ("phi mu" #f 9)) "iota eta" "mu nu") 225.527 (7 (#t "beta omicron" (-76884 569.391)) rho ((97568 -43818 337.124 sigma) (2 gamma -31944) #f) "epsilon tau") gamma (47953 129.673 (4 (#f 607.912 #t 734.549) (251.382) "sigma sigma") 4)))
+
+(define (f138 omicron rho)
+  (if (< omicron rho) (- omicron 81) (- rho 63)))
+(define d138 '(#f #f ((81.236 83.960 mu (#f "iota gamma") (sigma)) 438.454 96134) ((274.627 gamma (60268 #f -86940 359.754) 62.855) 857.38 upsilon 176.944 536.287) (#f 0) (-78292 ((201.931 -81129 theta) 383.813 ("delta nu" omicron theta "beta phi") ("epsilon rho" eta phi 57103) (omicron 822.513 -55249 mu 570.251)) (tau 395.186 965.621 "sigma iota")) "alpha pi" ((#t (nu) #f)) phi (12576 (3 ("iota pi" xi #f) kappa (653.855 "tau rho" -11845) (743.2 phi 27631 305.885 368.607)) -86643)))
+
+(define (f139 beta delta)
+  (if (< beta delta) (+ beta 42) (+ delta 82)))
+(define d139 '("theta kappa" (72821 #t pi) (-41477 "kappa delta" nu) #t 549.375 (((#f 1 -59268) (delta "zeta theta" pi 21900 "upsilon pi") ("upsilon rho") (45744 upsilon) 35843) (("beta delta" 623.844 -79597) 0 (458) upsilon) 6) (4298 (upsilon (#f 361.202)) ((sigma 28201 136.546) gamma (97468 -80494) 58230) zeta phi) "theta mu" #f ((-48616 ("theta nu") (#f #f "theta rho" gamma)))))
+
+(define (f140 epsilon sigma)
+  (if (< epsilon sigma) (* epsilon 49) (* sigma 54)))
+(define d140 '((688.131) (330.887 "gamma delta") ((("mu pi" xi 185.383 iota -71328) #t) "eta sigma" (565.845 (#f "sigma kappa" #f xi 28.968) #t) beta (554.212)) (#f) ((("omicron delta")) ((#t "gamma omicron" 30806 tau) 6) delta #t) 396.865 xi "pi kappa" #f 623.698))
+
+(define (f141 alpha xi)
+  (if (< alpha xi) (- alpha 72) (- xi 4)))
+(define d141 '(((delta (-67656 tau 406.557 "pi alpha" 120.983)) 68.612 "epsilon mu" (("upsilon alpha" #f) (#t tau #t #t "theta mu") (xi delta 752.83 -60537) (#f 7))) (#t "gamma rho") ("sigma pi" (259.931 (2802 779.649 #t "tau iota") #f "beta alpha" 317.332)) ((("theta beta" 270.594) ("iota mu" -20782 0 "eta delta") xi kappa) 19279 ((rho -72427 "upsilon rho") "nu kappa" ("epsilon sigma" "epsilon zeta" #f) alpha (4 omicron "xi upsilon" 944.886 "gamma eta")) "tau rho" "pi pi") pi 583.578 (508.479 (-85537 (-65917 "zeta zeta") (294.206) 700.964) ((258.286 "alpha xi")) ((epsilon) "tau xi" 613.312)) #t -91348 (#f theta #t)))
+
+(define (f142 iota zeta)
+  (if (< iota zeta) (- iota 44) (- zeta 39)))
+(define d142 '((("omicron kappa" (25742 "tau sigma" "tau xi") 43.234) (909.76 (62904)) ((9 "upsilon sigma" 941.906 846.816) (upsilon "zeta upsilon" "upsilon xi") 11964) 778.187 #f) gamma (mu ((-78434 "nu kappa") gamma)) 7 -85437 (895.477 -74396 "upsilon pi") 845.52 "beta rho" kappa (5 ((#f -31944 #t "gamma iota" 5) (-74925 48241 7 #f 47.122)))))
+
+(define (f143 tau epsilon)
+  (if (< tau epsilon) (* tau 92) (* epsilon 92)))
+(define d143 '(232.721 #t (((607.931 #f 12553 #t 996.19) ("kappa delta" zeta "theta upsilon" "epsilon nu")) ((307.668 "pi theta") ("rho zeta" kappa eta kappa) (618.997 rho "kappa theta" -58925) (276.950 67957 rho "beta alpha" #t) ("theta rho" zeta 128.374 944.33)) #t ((-73719 477.247 97169)) 405.318) (omicron ((940.625)) ((pi 161.589 854.812 phi "rho rho") (883.609))) 170.441 (((-88805 619.576) 84332 ("omicron gamma") ("sigma rho" mu 87275)) (("phi epsilon") ("nu iota"))) (((-27340 757.796 810.705 7 pi) #t "theta iota") 51.185) (156.300 (#f "zeta beta" beta) 4794 841.135) 27788 (("beta upsilon" (-28335 mu -79371) (gamma 522.820)) ((842.750) (theta phi 61604) ("mu nu" 2847 177.981 284.419) "delta omicron") 75990)))
+
+(define (f144 tau nu)
+  (if (< tau nu) (* tau 55) (* nu 30)))
+(define d144 '(-99797 -18038 56.321 (omicron ((709.987 0 -71347) omicron (#f) (41019 -26326 "delta xi" #t 7)) gamma omicron) ((("tau tau" "rho zeta" 25610 "zeta alpha"))) (pi 469.215 alpha 744.741 (("phi pi" 9))) (nu ("pi gamma" "iota upsilon" "xi sigma" "pi nu" #f) (omicron) #f theta) ("eta upsilon") ((omicron 245.789)) "rho theta"))
+
+(define (f145 alpha eta)
+  (if (< alpha eta) (+ alpha 48) (+ eta 63)))
+(define d145 '((859.425 tau 12.872 beta) kappa 72539 kappa (74537) (((532.522 xi 13.207 theta) -92792 -23704 629.314 ("iota delta" 9)) omicron ("eta nu" #t) 463.796 "beta alpha") 38.132 beta "pi delta" 72830))
+
+(define (f146 nu sigma)
+  (if (< nu sigma) (* nu 94) (* sigma 5)))
+(define d146 '((((-11707 "omicron beta" -52895 499.539 rho) ("eta omicron"))) 485.400 ((15.148 tau #f) -35954 (nu -71197) ((#f 3 462 pi)) ((-73279 2 "phi epsilon" "omicron tau" 296.64))) (gamma 35179) #f gamma (16636 ("beta sigma")) 50083 ((sigma 70.22 nu ("epsilon epsilon" "phi iota" "iota alpha" "iota iota"))) ((#t (#t "kappa gamma") "alpha theta" "nu theta" ("xi theta" -78711 #f omicron 329.231)) "kappa alpha" "kappa sigma" 4 8)))
+
+(define (f147 iota sigma)
+  (if (< iota sigma) (- iota 66) (- sigma 8)))
+(define d147 '(415.827 19536 ((669.492 phi 835.956 #t)) (#t) (((-6501 #f 238.681) ("mu nu" 581.111 -44658)) (98477 9 "nu eta") (("theta delta" 984.581 "epsilon iota" 951.940 5))) theta (((-36712) 810.127 ("pi beta" nu 25223 pi) (1864)) 3075) ((("kappa xi" 8 -73360) (-39504 256.677 89870)) "xi upsilon" (#f 398.54 -70880) (omicron) 53464) #f ((-39448) #t (xi (#f 75.62 sigma "theta omicron" mu)) ((#t 7652)) 37958)))
+
+(define (f148 xi kappa)
+  (if (< xi kappa) (+ xi 61) (+ kappa 49)))
+(define d148 '(848.29 "iota delta" ((phi ("iota alpha" 230.800 86913 674.183) (2 "delta zeta") #f) ((958.190 #f #t "tau omicron" -80501) 226.47 58597 ("rho gamma") (0 798.493 #t)) (16.730 ("zeta delta" "xi alpha" 331.520 #t) (#f 738.466 3) (nu 260.737 -80735 400.986) (#t)) ((-72892 4 212.31 #f) 32.760 (643.258 2) 818.113)) "sigma sigma" 651.451 "nu kappa" 188.2 -83209 ((gamma 501.627)) ((#f -95198 (62121)) 4)))
+
+(define (f149 epsilon phi)
+  (if (< epsilon phi) (- epsilon 22) (- phi 26)))
+(define d149 '((18435) 329.39 #t ((("mu eta" "upsilon epsilon" 0) "xi theta") "phi xi") ((878.1 iota 2114) "iota upsilon" 79771 mu) (28398) 594.968 528.3 (alpha 71493 ((125.337 nu 713.166 #f) #f (beta rho 960.348) (-72080 zeta))) ("zeta pi" 8 -42054)))
+
+(display (+ (sum-numbers d0 0) (sum-numbers d5 0) (sum-numbers d10 0) (sum-numbers d15 0) (sum-numbers d20 0) (sum-numbers d25 0) (sum-numbers d30 0) (sum-numbers d35 0) (sum-numbers d40 0) (sum-numbers d45 0) (sum-numbers d50 0) (sum-numbers d55 0) (sum-numbers d60 0) (sum-numbers d65 0) (sum-numbers d70 0) (sum-numbers d75 0) (sum-numbers d80 0) (sum-numbers d85 0) (sum-numbers d90 0) (sum-numbers d95 0) (sum-numbers d100 0) (sum-numbers d105 0) (sum-numbers d110 0) (sum-numbers d115 0) (sum-numbers d120 0) (sum-numbers d125 0) (sum-numbers d130 0) (sum-numbers d135 0) (sum-numbers d140 0) (sum-numbers d145 0)))
+(newline)
@@ -0,0 +1,30 @@
+; Interning: string->symbol on names built with string-append, and
+; symbol->string.
+(define names '(alpha beta gamma delta epsilon zeta eta theta iota kappa))
+
+(define (intern-all l n)
+  (if (null? l)
+      n
+      (intern-all (cdr l)
+                  (if (eq? (string->symbol (symbol->string (car l))) (car l))
+                      (+ n 1)
+                      n))))
+
+(define (suffixed l suffix acc)
+  (if (null? l)
+      acc
+      (suffixed (cdr l) suffix
+                (cons (string->symbol
+                       (string-append (symbol->string (car l)) suffix))
+                      acc))))
+
+(define (repeat n count)
+  (if (= n 0)
+      count
+      (begin
+        (suffixed names "-a" '())
+        (suffixed names "-b" '())
+        (repeat (- n 1) (intern-all names count)))))
+
+(display (repeat 20000 0))
+(newline)
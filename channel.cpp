@@ -0,0 +1,245 @@
+#include "channel.hpp"
+#include "objspace.hpp"
+#include "inlines.hpp"
+
+namespace sanya {
+
+// Finds the objects to be copied, and the symbols, breadth first. The
+// pointers are left as they are.
+//
+// Nothing is allocated meanwhile, so as the collector does, the objects
+// are marked in self_, which is restored by Unmark: with where they go
+// in the buffer, or the index of the symbol and 1.
+class Message::Collector : public Relocation {
+public:
+    Collector(Heap &heap, Message *message)
+        : heap_(heap),
+          message_(message),
+          size_(0),
+          failed_(false) { }
+
+    virtual RawObject *Relocate(RawObject *ro) {
+        Add(ro);
+        return ro;
+    }
+
+    void Add(RawObject *ro) {
+        // Fixnums and such, the shared space and what is marked.
+        if (!ro->heap_allocated() || !heap_.Contains(ro) ||
+                ro->self_ != ro) {
+            return;
+        }
+        if (ro->IsSymbol() && ((RawSymbol *)ro)->interned()) {
+            ro->self_ = (RawHeapObject *)(
+                    (message_->symbols_.size() << 1) | 1);
+            message_->symbols_.push_back(std::string(
+                    ((RawSymbol *)ro)->Unwrap(),
+                    ((RawSymbol *)ro)->length()));
+            symbols_.push_back(ro);
+            return;
+        }
+        if (ro->IsProcedure() || ro->IsClosure() || ro->IsContinuation() ||
+                ro->IsPort()) {
+            failed_ = true;
+            return;
+        }
+        ro->self_ = (RawHeapObject *)(size_ << 1);
+        size_ += ro->object_size_;
+        objects_.push_back(ro);
+    }
+
+    void Unmark() {
+        for (size_t i = 0; i < objects_.size(); ++i) {
+            objects_[i]->self_ = (RawHeapObject *)objects_[i];
+        }
+        for (size_t i = 0; i < symbols_.size(); ++i) {
+            symbols_[i]->self_ = (RawHeapObject *)symbols_[i];
+        }
+    }
+
+    Heap &heap_;
+    Message *message_;
+    std::vector<RawObject *> objects_;
+    std::vector<RawObject *> symbols_;
+    size_t size_;
+    bool failed_;
+};
+
+// Points the pointers of the copies into the buffer.
+class Message::Encoder : public Relocation {
+public:
+    Encoder(const Collector &collector, char *data)
+        : collector_(collector),
+          data_(data) { }
+
+    virtual RawObject *Relocate(RawObject *ro) {
+        if (!collector_.heap_.Contains(ro)) {
+            return ro;
+        }
+        uintptr_t mark = (uintptr_t)ro->self_;
+        if (mark & 1) {
+            return (RawObject *)(data_ + collector_.size_ +
+                                 (mark >> 1) * Heap::kAlignment);
+        }
+        return (RawObject *)(data_ + (mark >> 1));
+    }
+
+private:
+    const Collector &collector_;
+    char *data_;
+};
+
+// Points the pointers into the buffer to where it was copied in the
+// heap, and to the interned symbols.
+class Message::Decoder : public Relocation {
+public:
+    Decoder(const Message &message, char *objects, RawVector *symbols)
+        : message_(message),
+          data_(message.data_.empty() ? NULL : &message.data_[0]),
+          objects_(objects),
+          symbols_(symbols) { }
+
+    virtual RawObject *Relocate(RawObject *ro) {
+        uintptr_t offset = (uintptr_t)ro - (uintptr_t)data_;
+        if (offset < message_.objects_size_) {
+            return (RawObject *)(objects_ + offset);
+        }
+        if (offset < message_.data_.size()) {
+            offset -= message_.objects_size_;
+            return symbols_->At(offset / Heap::kAlignment);
+        }
+        return ro;
+    }
+
+private:
+    const Message &message_;
+    const char *data_;
+    char *objects_;
+    RawVector *symbols_;
+};
+
+Message *Message::Write(RawObject *value) {
+    Heap &heap = Heap::Get();
+    Message *message = new Message();
+    Collector collector(heap, message);
+    collector.Add(value);
+    for (size_t i = 0; i < collector.objects_.size(); ++i) {
+        heap.RelocateInteriorPointers(collector.objects_[i], &collector);
+    }
+    if (collector.failed_) {
+        collector.Unmark();
+        delete message;
+        return NULL;
+    }
+
+    // Aligned as the heap is, since new aligns to 16 bytes.
+    message->objects_size_ = collector.size_;
+    message->data_.resize(collector.size_ +
+                          message->symbols_.size() * Heap::kAlignment);
+    char *data = message->data_.empty() ? NULL : &message->data_[0];
+    Encoder encoder(collector, data);
+    for (size_t i = 0; i < collector.objects_.size(); ++i) {
+        RawObject *object = collector.objects_[i];
+        RawObject *copy = (RawObject *)(data +
+                                        ((uintptr_t)object->self_ >> 1));
+        memcpy((void *)copy, object, object->object_size_);
+        heap.RelocateInteriorPointers(copy, &encoder);
+    }
+    message->value_ = value->heap_allocated() ? encoder.Relocate(value)
+                                              : value;
+    collector.Unmark();
+    return message;
+}
+
+RawObject *Message::Read() const {
+    Heap &heap = Heap::Get();
+    Handle symbols = RawVector::Wrap(symbols_.size(), RawNil::Wrap());
+    for (size_t i = 0; i < symbols_.size(); ++i) {
+        RawSymbol *symbol = ObjSpace::Get().InternSymbol(
+                symbols_[i].data(), symbols_[i].size());
+        symbols.AsVector().Set(i, symbol);
+    }
+
+    // All of the objects at once, nothing is allocated afterwards.
+    char *objects = NULL;
+    if (objects_size_) {
+        objects = (char *)heap.Alloc(objects_size_);
+        memcpy(objects, &data_[0], objects_size_);
+    }
+    Decoder decoder(*this, objects, &symbols.AsVector());
+    for (size_t offset = 0; offset < objects_size_; ) {
+        RawObject *object = (RawObject *)(objects + offset);
+        object->self_ = (RawHeapObject *)object;
+        heap.RelocateInteriorPointers(object, &decoder);
+        offset += object->object_size_;
+    }
+    return value_->heap_allocated() ? decoder.Relocate(value_) : value_;
+}
+
+Channel::Channel(size_t capacity)
+    : capacity_(capacity),
+      closed_(false) {
+    pthread_mutex_init(&mutex_, NULL);
+    pthread_cond_init(&not_empty_, NULL);
+    pthread_cond_init(&not_full_, NULL);
+}
+
+Channel::~Channel() {
+    for (size_t i = 0; i < messages_.size(); ++i) {
+        delete messages_[i];
+    }
+    pthread_cond_destroy(&not_full_);
+    pthread_cond_destroy(&not_empty_);
+    pthread_mutex_destroy(&mutex_);
+}
+
+bool Channel::Send(const Handle &value) {
+    Message *message = Message::Write(value.raw());
+    if (!message) {
+        return false;
+    }
+    pthread_mutex_lock(&mutex_);
+    while (!closed_ && capacity_ && messages_.size() >= capacity_) {
+        pthread_cond_wait(&not_full_, &mutex_);
+    }
+    if (closed_) {
+        pthread_mutex_unlock(&mutex_);
+        delete message;
+        return false;
+    }
+    messages_.push_back(message);
+    pthread_cond_signal(&not_empty_);
+    pthread_mutex_unlock(&mutex_);
+    return true;
+}
+
+RawObject *Channel::Receive() {
+    pthread_mutex_lock(&mutex_);
+    while (!closed_ && messages_.empty()) {
+        pthread_cond_wait(&not_empty_, &mutex_);
+    }
+    if (messages_.empty()) {
+        pthread_mutex_unlock(&mutex_);
+        return NULL;
+    }
+    Message *message = messages_.front();
+    messages_.pop_front();
+    pthread_cond_signal(&not_full_);
+    pthread_mutex_unlock(&mutex_);
+
+    RawObject *value = message->Read();
+    delete message;
+    return value;
+}
+
+void Channel::Close() {
+    pthread_mutex_lock(&mutex_);
+    closed_ = true;
+    pthread_cond_broadcast(&not_empty_);
+    pthread_cond_broadcast(&not_full_);
+    pthread_mutex_unlock(&mutex_);
+}
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
@@ -0,0 +1,107 @@
+#ifndef CHANNEL_HPP
+#define CHANNEL_HPP
+/**
+ * @file channel.hpp
+ * @brief Passes objects between isolates (see isolate.hpp).
+ */
+
+#include <deque>
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include "objectmodel.hpp"
+
+namespace sanya {
+
+/**
+ * @class Message
+ * @brief An object and everything it references, taken out of the heap
+ * of one isolate to be put into the heap of another.
+ *
+ * The objects are copied as they are into one buffer, with their pointers
+ * to each other pointing into the buffer, so that the receiver allocates
+ * them all at once and fixes up the pointers in one pass, as a snapshot
+ * is restored. What is not copied:
+ *
+ * - Interned symbols are sent by name, and interned by the receiver.
+ * - Strings in the shared space (see sharedspace.hpp) are pointed to.
+ *
+ * Procedures and closures can't be sent, their constants hold the global
+ * variables of their isolate, and neither can continuations or ports.
+ */
+class Message {
+public:
+    /**
+     * @brief Copy value, from the current isolate. Returns NULL if it
+     * references a procedure, a closure, a continuation or a port.
+     * Doesn't allocate on the heap.
+     */
+    static Message *Write(RawObject *value);
+
+    /** @brief Build the value in the current isolate. */
+    RawObject *Read() const;
+
+    /** @brief In bytes, of the objects that are copied. */
+    size_t size() const { return objects_size_; }
+
+private:
+    class Collector;
+    class Encoder;
+    class Decoder;
+
+    Message()
+        : objects_size_(0),
+          value_(NULL) { }
+
+    // The objects from offset 0, and then a slot of Heap::kAlignment
+    // bytes per symbol, which pointers to the symbol point to.
+    std::vector<char> data_;
+    size_t objects_size_;
+    std::vector<std::string> symbols_;
+    RawObject *value_;
+};
+
+/**
+ * @class Channel
+ * @brief A queue of messages, which any thread may send to or receive
+ * from.
+ *
+ * Values are copied by Send, in the isolate of the sender, and built
+ * again by Receive, in the isolate of the receiver, so neither blocks the
+ * other for longer than it takes to queue a pointer.
+ */
+class Channel {
+public:
+    /** @brief Send blocks while capacity messages are queued, if not 0. */
+    explicit Channel(size_t capacity = 0);
+    ~Channel();
+
+    /**
+     * @brief Queue a copy of value. Returns false if the channel is
+     * closed or value can't be sent (see Message).
+     */
+    bool Send(const Handle &value);
+
+    /**
+     * @brief Wait for a message and build its value. Returns NULL once
+     * the channel is closed and empty.
+     */
+    RawObject *Receive();
+
+    /** @brief Wake up the receivers, nothing may be sent afterwards. */
+    void Close();
+
+private:
+    size_t capacity_;
+    bool closed_;
+    std::deque<Message *> messages_;
+    pthread_mutex_t mutex_;
+    pthread_cond_t not_empty_;
+    pthread_cond_t not_full_;
+};
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
+
+#endif /* CHANNEL_HPP */
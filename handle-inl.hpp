@@ -67,6 +67,30 @@ RawDict &Handle::AsDict() const {
     return *(RawDict *)raw_;
 }
 
+RawCell &Handle::AsCell() const {
+    return *(RawCell *)raw_;
+}
+
+RawProcedure &Handle::AsProcedure() const {
+    return *(RawProcedure *)raw_;
+}
+
+RawClosure &Handle::AsClosure() const {
+    return *(RawClosure *)raw_;
+}
+
+RawNative &Handle::AsNative() const {
+    return *(RawNative *)raw_;
+}
+
+RawString &Handle::AsString() const {
+    return *(RawString *)raw_;
+}
+
+RawPort &Handle::AsPort() const {
+    return *(RawPort *)raw_;
+}
+
 inline Handle::Handle() {
     Empty();
 }
@@ -78,7 +102,9 @@ inline void Handle::Empty() {
 }
 
 inline void Handle::LinkToRootSet(RawObject *ro) {
-    if (ro->heap_allocated()) {
+    // Don't call heap_allocated() on NULL: compilers assume that `this`
+    // is never NULL and will fold the check away.
+    if (ro && ro->heap_allocated()) {
         if (!next_root_) {
             // The first time we got a heap object
             RootSet::Get().Put(this);
@@ -87,7 +113,7 @@ inline void Handle::LinkToRootSet(RawObject *ro) {
             // So we already have a heap object
         }
     }
-    else if (raw_->heap_allocated()) {
+    else if (next_root_) {
         // Switching from heap object to non-heap object
         // release the root set.
         UnlinkFromRootSet();
@@ -14,6 +14,12 @@ class RawSymbol;
 class RawVector;
 class RawGrowableVector;
 class RawDict;
+class RawCell;
+class RawProcedure;
+class RawClosure;
+class RawNative;
+class RawString;
+class RawPort;
 
 /**
  * Copied from Google Dart's code -- this will slightly affect
@@ -53,6 +59,12 @@ public:
     inline RawGrowableVector &AsGrowableVector() const;
     inline RawVector &AsVector() const;
     inline RawDict &AsDict() const;
+    inline RawCell &AsCell() const;
+    inline RawProcedure &AsProcedure() const;
+    inline RawClosure &AsClosure() const;
+    inline RawNative &AsNative() const;
+    inline RawString &AsString() const;
+    inline RawPort &AsPort() const;
 
     void print_info() {
         printf("raw = %p, prev_root = %p, next_root = %p\n",
@@ -6,6 +6,7 @@
 #include "heap.hpp"
 #include "handle-inl.hpp"
 #include "heap-inl.hpp"
+#include "isolate-inl.hpp"
 #include "objectmodel-inl.hpp"
 
 namespace sanya {
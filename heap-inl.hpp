@@ -1,11 +1,12 @@
 #ifndef HEAP_INL_HPP
 #define HEAP_INL_HPP
+#include "isolate.hpp"
+#include "oldspace.hpp"
+
 namespace sanya {
 
 Heap &Heap::Get() {
-    if (!default_s)
-        default_s = new Heap(kDefaultSize);
-    return *default_s;
+    return Isolate::Current()->heap();
 }
 
 RawHeapObject *Heap::Alloc(size_t size) {
@@ -40,11 +41,31 @@ RawObject *Heap::MarkAndCopy(RawObject *ro) {
     // E.g., fixnum object.
     if (!IsHeapAllocated(ro)) return ro;
 
+    if (relocation_) return relocation_->Relocate(ro);
+
     // If is already copied.
-    if (IsForwardPointer(ro)) return GetForwardPointer((RawHeapObject *)ro);
+    if (IsForwardPointer(ro)) {
+        RawHeapObject *forward = GetForwardPointer((RawHeapObject *)ro);
+
+        // Unless it was promoted, see ScanOld.
+        if ((uintptr_t)forward - (uintptr_t)to_space_ < size_) {
+            young_ref_ = true;
+        }
+        return forward;
+    }
+
+    // Such as the old space or the shared space, whose objects don't move.
+    if (!IsYoung(ro)) return ro;
 
     // Prepare for the copy.
     RawHeapObject *rho = (RawHeapObject *)ro;
+
+    // It survived the last collection too.
+    if (old_ && (uintptr_t)ro - (uintptr_t)from_space_ < survivor_end_) {
+        RawHeapObject *promoted = Promote(rho);
+        if (promoted) return promoted;
+    }
+
     size_t object_size = GetRawObjectSize(rho);
     RawHeapObject *destination = (RawHeapObject *)(to_space_ + copy_usage_);
     copy_usage_ += object_size;
@@ -58,11 +79,31 @@ RawObject *Heap::MarkAndCopy(RawObject *ro) {
     // XXX: eliminate recursive calls!
     destination->UpdateInteriorPointers(*this);
 
+    young_ref_ = true;
     return destination;
 }
 
+bool Heap::Contains(RawObject *ro) const {
+    return IsYoung(ro) || (old_ && old_->Contains(ro));
+}
+
+bool Heap::IsYoung(RawObject *ro) const {
+    return (uintptr_t)ro - (uintptr_t)from_space_ < size_;
+}
+
+bool Heap::IsOld(RawObject *ro) const {
+    return old_ && ro && ro->heap_allocated() && old_->Contains(ro);
+}
+
+void Heap::WriteBarrier(RawObject *container, RawObject *old_value,
+                        RawObject *new_value) {
+    if (old_ && old_->Contains(container)) {
+        RecordWrite(container, old_value, new_value);
+    }
+}
+
 bool Heap::IsHeapAllocated(RawObject *ro) {
-    return ro->heap_allocated();
+    return ro && ro->heap_allocated();
 }
 
 bool Heap::IsForwardPointer(RawObject *ro) {
@@ -84,9 +125,7 @@ size_t Heap::GetRawObjectSize(RawObject *ro) {
 
 
 RootSet &RootSet::Get() {
-    if (!default_s)
-        default_s = new RootSet();
-    return *default_s;
+    return Isolate::Current()->root_set();
 }
 
 void RootSet::Put(Handle *o) {
@@ -4,20 +4,26 @@
 #include <cstring>
 #include <utility>
 
+#include "allocprofile.hpp"
 #include "heap.hpp"
 #include "objectmodel.hpp"
+#include "oldspace.hpp"
 #include "inlines.hpp"
 
 namespace sanya {
 
-Heap *Heap::default_s = NULL;
-
 Heap::Heap(size_t size)
     : size_(size),
       usage_(0),
       from_space_(new char[size]),
       copy_usage_(0),
-      to_space_(new char[size]) {
+      to_space_(new char[size]),
+      collections_(0),
+      relocation_(NULL),
+      old_(NULL),
+      survivor_end_(0),
+      young_ref_(false),
+      old_full_(false) {
 
     // Not quite sure why valgrind says error....
     memset(from_space_, 0, size);
@@ -25,6 +31,11 @@ Heap::Heap(size_t size)
 }
 
 Heap::~Heap() {
+    for (size_t i = 0; i < finalizable_.size(); ++i) {
+        finalizable_[i]->Finalize();
+    }
+    delete old_;
+    old_ = NULL;
     delete[] from_space_;
     from_space_ = NULL;
     delete[] to_space_;
@@ -36,21 +47,148 @@ Heap::~Heap() {
 void Heap::TriggerCollection() {
     Handle *dummy = RootSet::Get().head_;
     Handle *it;
+    std::vector<RawObject *> remembered;
+    if (old_) {
+        old_->TakeRemembered(&remembered);
+    }
 
     // Iterate through the root set, do mark-and-copy, and update
-    // the pointer fields in the root sets.
+    // the pointer fields in the root sets. Old roots are scanned too,
+    // since what they point to may have been written without the barrier.
     for (it = dummy->next_root_; it != dummy; it = it->next_root_) {
         it->raw_ = MarkAndCopy(it->raw_);
+        if (IsOld(it->raw_)) {
+            ScanOld(it->raw_);
+        }
+    }
+    for (size_t i = 0; i < remembered.size(); ++i) {
+        ScanOld(remembered[i]);
     }
 
-    // Optional: call destructors for objects.
-    printf(":heap-collect %ld => %ld\n", usage_, copy_usage_);
+    // Sampled objects that were not copied are garbage.
+    AllocationProfile::AfterCollection();
+
+    // So are the finalizable objects that were not copied, and those
+    // that were promoted are finalized when the old space sweeps them.
+    size_t kept = 0;
+    for (size_t i = 0; i < finalizable_.size(); ++i) {
+        RawHeapObject *rho = finalizable_[i];
+        if (!IsForwardPointer(rho)) {
+            rho->Finalize();
+        }
+        else if (!IsOld(GetForwardPointer(rho))) {
+            finalizable_[kept++] = GetForwardPointer(rho);
+        }
+    }
+    finalizable_.resize(kept);
+    //printf(":heap-collect %ld => %ld\n", usage_, copy_usage_);
 
     // Flip over and clean up
     std::swap(usage_, copy_usage_);
     copy_usage_ = 0;
     std::swap(from_space_, to_space_);
     std::fill(to_space_, to_space_ + size_, 0);
+    survivor_end_ = usage_;
+    ++collections_;
+
+    if (old_) {
+        CollectOldSpace();
+    }
+}
+
+void Heap::EnableOldSpace(size_t size) {
+    if (!old_) {
+        old_ = new OldSpace(*this, size);
+    }
+}
+
+RawHeapObject *Heap::Promote(RawHeapObject *rho) {
+    size_t object_size = GetRawObjectSize(rho);
+    RawHeapObject *destination = old_->Alloc(object_size);
+    if (!destination) {
+        // Stays in the nursery, and the old space is collected in full.
+        old_full_ = true;
+        return NULL;
+    }
+    memcpy((void *)destination, rho, object_size);
+    SetForwardPointer(rho, destination);
+    destination->self_ = (RawHeapObject *)destination;
+
+    bool young_ref = young_ref_;
+    ScanOld(destination);
+    young_ref_ = young_ref;
+    return destination;
+}
+
+void Heap::ScanOld(RawObject *ro) {
+    young_ref_ = false;
+    ro->UpdateInteriorPointers(*this);
+    if (young_ref_) {
+        old_->Remember(ro);
+    }
+}
+
+void Heap::RecordWrite(RawObject *container, RawObject *old_value,
+                       RawObject *new_value) {
+    // What was alive at the start of the cycle stays so until its end.
+    if (old_->phase() == OldSpace::kMarking) {
+        old_->Shade(old_value);
+    }
+    if (IsHeapAllocated(new_value) && IsYoung(new_value)) {
+        old_->Remember(container);
+    }
+}
+
+void Heap::RecordWrites(RawObject *ro) {
+    if (!IsOld(ro)) {
+        return;
+    }
+    old_->Remember(ro);
+    if (old_->phase() == OldSpace::kMarking) {
+        old_->ShadeFields(ro);
+    }
+}
+
+void Heap::CollectOldSpace() {
+    bool full = old_full_;
+    old_full_ = false;
+
+    // Twice what a collection of the nursery may promote, to keep up.
+    size_t budget = full ? SIZE_MAX : 2 * size_;
+    if (old_->phase() == OldSpace::kIdle) {
+        if (!full && !old_->ShouldStart()) {
+            return;
+        }
+
+        // The snapshot: the roots, what the old ones point to as they
+        // are scanned above, and the nursery, which is all alive now.
+        old_->StartMarking();
+        Handle *dummy = RootSet::Get().head_;
+        for (Handle *it = dummy->next_root_; it != dummy;
+                it = it->next_root_) {
+            old_->Shade(it->raw_);
+            if (IsOld(it->raw_)) {
+                old_->ShadeFields(it->raw_);
+            }
+        }
+        for (size_t offset = 0; offset < usage_; ) {
+            RawObject *object = (RawObject *)(from_space_ + offset);
+            old_->ShadeFields(object);
+            offset += GetRawObjectSize(object);
+        }
+    }
+    if (old_->phase() == OldSpace::kMarking) {
+        old_->Mark(budget);
+    }
+    if (old_->phase() == OldSpace::kSweeping) {
+        old_->Sweep(budget);
+    }
+}
+
+void Heap::RelocateInteriorPointers(RawObject *ro, Relocation *relocation) {
+    relocation_ = relocation;
+    ro->UpdateInteriorPointers(*this);
+    relocation_ = NULL;
 }
 
 // Private implementation of a dummy head.
@@ -62,14 +200,11 @@ public:
     }
 };
 
-static DummyObjectHead dummy_head_s = DummyObjectHead();
-
-RootSet *RootSet::default_s = NULL;
-
 RootSet::RootSet()
-    : head_(&dummy_head_s) { }
+    : head_(new DummyObjectHead()) { }
 
 RootSet::~RootSet() {
+    delete head_;
 }
 
 
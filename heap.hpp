@@ -7,6 +7,7 @@
 #include <cstring>
 #include <cstddef>
 #include <utility>
+#include <vector>
 
 #include "sanya.hpp"
 
@@ -16,6 +17,20 @@ namespace sanya {
 class Handle;
 class RawObject;
 class RawHeapObject;
+class OldSpace;
+
+/**
+ * @class Relocation
+ * @brief Where the pointers of an object go, see
+ * Heap::RelocateInteriorPointers.
+ */
+class Relocation {
+public:
+    virtual ~Relocation() { }
+
+    /** @brief Called with every heap-allocated pointer. */
+    virtual RawObject *Relocate(RawObject *ro) = 0;
+};
 
 /**
  * @class Heap
@@ -23,6 +38,7 @@ class RawHeapObject;
  * knows every objects and their handles (through RootSet).
  */
 class Heap {
+    friend class Snapshot;
 public:
     const static int kAlignment = 16;  // 16-bytes
     const static int kAligner = kAlignment - 1;
@@ -33,7 +49,7 @@ public:
     Heap(size_t size);
     ~Heap();
 
-    /** @brief Get the singleton heap */
+    /** @brief Get the heap of the current isolate (see isolate.hpp). */
     inline static Heap &Get();
 
     /**
@@ -61,6 +77,61 @@ public:
      */
     void TriggerCollection();
 
+    /** @brief Bytes in use, which are all live right after a collection. */
+    size_t usage() const { return usage_; }
+
+    /** @brief How many times TriggerCollection has run. */
+    size_t collections() const { return collections_; }
+
+    /**
+     * @brief rho, which was just allocated, holds something outside of
+     * the heap, so its Finalize is called once a collection finds it
+     * dead, or when the heap is deleted. The old space finalizes every
+     * object that it sweeps, so this is only needed in the nursery.
+     */
+    void AddFinalizer(RawHeapObject *rho) { finalizable_.push_back(rho); }
+
+    /**
+     * @brief Replace the interior pointers of an object that is not
+     * (yet) in the heap, such as one that was copied into it from a
+     * snapshot (see snapshot.hpp), by what relocation tells.
+     */
+    void RelocateInteriorPointers(RawObject *ro, Relocation *relocation);
+
+    /**
+     * @brief Whether ro is in this heap, the nursery or the old space.
+     * Objects elsewhere, such as in the shared space (see
+     * sharedspace.hpp), are never moved.
+     */
+    inline bool Contains(RawObject *ro) const;
+
+    /**
+     * @brief Promote the objects that survive a second collection into
+     * an old space of size bytes (see oldspace.hpp), so that they are no
+     * longer copied. Off by default, and the heap can't be saved in a
+     * snapshot afterwards.
+     */
+    void EnableOldSpace(size_t size);
+
+    /** @brief NULL unless EnableOldSpace was called. */
+    OldSpace *old_space() const { return old_; }
+
+    /**
+     * @brief Called before a pointer field of container is changed from
+     * old_value to new_value, by the setters of the objects that may be
+     * in the old space. Writes to objects that were just allocated don't
+     * need it.
+     */
+    inline void WriteBarrier(RawObject *container, RawObject *old_value,
+                             RawObject *new_value);
+
+    /**
+     * @brief ro was or is about to be written without the barrier, as
+     * the stack of the interpreter is while it's running. Called when
+     * such an object stops or starts being written.
+     */
+    void RecordWrites(RawObject *ro);
+
 protected:
 
     // False for fixnum.
@@ -74,8 +145,16 @@ protected:
 
     inline size_t GetRawObjectSize(RawObject *ro);
 
+    // In the from space, or the old space.
+    inline bool IsYoung(RawObject *ro) const;
+    inline bool IsOld(RawObject *ro) const;
+
 private:
-    static Heap *default_s;
+    RawHeapObject *Promote(RawHeapObject *rho);
+    void ScanOld(RawObject *ro);
+    void RecordWrite(RawObject *container, RawObject *old_value,
+                     RawObject *new_value);
+    void CollectOldSpace();
 
     size_t size_;
     size_t usage_;
@@ -83,6 +162,27 @@ private:
 
     size_t copy_usage_;
     char *to_space_;
+
+    size_t collections_;
+
+    // Set by RelocateInteriorPointers, MarkAndCopy relocates the
+    // pointers instead.
+    Relocation *relocation_;
+
+    OldSpace *old_;
+
+    // The objects below it in the from space survived the last
+    // collection, and are promoted at the next one.
+    size_t survivor_end_;
+
+    // Whether the old object being scanned points into the nursery.
+    bool young_ref_;
+
+    // Whether promotion ran out of room during this collection.
+    bool old_full_;
+
+    // The objects in the nursery that were passed to AddFinalizer.
+    std::vector<RawHeapObject *> finalizable_;
 };
 
 class RootSet {
@@ -90,13 +190,14 @@ class RootSet {
 public:
     RootSet();
     ~RootSet();
+
+    /** @brief Get the root set of the current isolate. */
     static inline RootSet &Get();
 
     inline void Put(Handle *o);
 
 private:
-    static RootSet *default_s;
-
+    // A dummy handle, the list of roots is circular.
     Handle *head_;
 };
 
@@ -5,7 +5,9 @@
 #include "handle.hpp"
 #include "objectmodel.hpp"
 #include "objspace.hpp"
+#include "isolate.hpp"
 
+#include "isolate-inl.hpp"
 #include "heap-inl.hpp"
 #include "handle-inl.hpp"
 #include "objectmodel-inl.hpp"
@@ -0,0 +1,44 @@
+#ifndef ISOLATE_INL_HPP
+#define ISOLATE_INL_HPP
+#include "heap.hpp"
+#include "objspace.hpp"
+#include "vm-jit.hpp"
+
+namespace sanya {
+
+Isolate *Isolate::Current() {
+    Isolate *isolate = current_s;
+    if (!isolate) {
+        isolate = current_s = Main();
+    }
+    return isolate;
+}
+
+Heap &Isolate::heap() {
+    return *heap_;
+}
+
+RootSet &Isolate::root_set() {
+    return *root_set_;
+}
+
+ObjSpace &Isolate::obj_space() {
+    if (!obj_space_) {
+        NewObjSpace();
+    }
+    return *obj_space_;
+}
+
+vm_jit::CodeArena &Isolate::code_arena() {
+    if (!code_arena_) {
+        NewCodeArena();
+    }
+    return *code_arena_;
+}
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
+
+
+#endif /* ISOLATE_INL_HPP */
@@ -0,0 +1,52 @@
+#include "isolate.hpp"
+#include "inlines.hpp"
+
+namespace sanya {
+
+__thread Isolate *Isolate::current_s = NULL;
+Isolate *Isolate::main_s = NULL;
+
+Isolate::Isolate(size_t heap_size)
+    : heap_(new Heap(heap_size)),
+      root_set_(new RootSet()),
+      obj_space_(NULL),
+      code_arena_(NULL) { }
+
+Isolate::~Isolate() {
+    // Its handles are the last ones in the root set.
+    delete obj_space_;
+    delete root_set_;
+    delete heap_;
+    delete code_arena_;
+    if (current_s == this) {
+        current_s = NULL;
+    }
+}
+
+Isolate *Isolate::Main() {
+    if (!main_s) {
+        main_s = new Isolate(Heap::kDefaultSize);
+    }
+    return main_s;
+}
+
+void Isolate::NewObjSpace() {
+    obj_space_ = new ObjSpace();
+}
+
+void Isolate::NewCodeArena() {
+    code_arena_ = new vm_jit::CodeArena();
+}
+
+Isolate::Scope::Scope(Isolate *isolate)
+    : previous_(current_s) {
+    current_s = isolate;
+}
+
+Isolate::Scope::~Scope() {
+    current_s = previous_;
+}
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
@@ -0,0 +1,90 @@
+#ifndef ISOLATE_HPP
+#define ISOLATE_HPP
+/**
+ * @file isolate.hpp
+ * @brief Independent interpreters in one process.
+ */
+
+#include <cstddef>
+
+namespace sanya {
+
+// Forwarded from heap.hpp, objspace.hpp and vm-jit.hpp
+class Heap;
+class RootSet;
+class ObjSpace;
+
+namespace vm_jit {
+class CodeArena;
+}
+
+/**
+ * @class Isolate
+ * @brief Owns a heap, its root set, an object space (the symbol table
+ * and the global variables), which is everything that Heap::Get,
+ * RootSet::Get and ObjSpace::Get give access to, and the machine code
+ * of its procedures.
+ *
+ * Each thread has a current isolate, and the objects and handles of an
+ * isolate are only used on the thread where it is current, so isolates
+ * run in parallel without any locks. Objects never move between
+ * isolates, and every handle and interpreter of an isolate has to be
+ * gone before it is deleted.
+ *
+ * Threads that never enter an isolate use the main one, which is created
+ * on first use, so only one of them may do so.
+ */
+class Isolate {
+    friend class Snapshot;
+public:
+    explicit Isolate(size_t heap_size);
+    ~Isolate();
+
+    /** @brief The isolate of the calling thread. */
+    inline static Isolate *Current();
+
+    /**
+     * @class Scope
+     * @brief Makes an isolate current on the calling thread for as long
+     * as it lives, and restores the previous one.
+     */
+    class Scope {
+    public:
+        explicit Scope(Isolate *isolate);
+        ~Scope();
+
+    private:
+        Isolate *previous_;
+    };
+
+    inline Heap &heap();
+    inline RootSet &root_set();
+
+    /** @brief Created on first use, so it has to be current by then. */
+    inline ObjSpace &obj_space();
+
+    /** @brief Where vm_jit puts code, created on first use. */
+    inline vm_jit::CodeArena &code_arena();
+
+private:
+    static Isolate *Main();
+
+    // Out of line so that users of the accessors above need not see the
+    // constructors.
+    void NewObjSpace();
+    void NewCodeArena();
+
+    static __thread Isolate *current_s;
+    static Isolate *main_s;
+
+    Heap *heap_;
+    RootSet *root_set_;
+    ObjSpace *obj_space_;
+    vm_jit::CodeArena *code_arena_;
+};
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
+
+#endif /* ISOLATE_HPP */
@@ -1,28 +1,146 @@
 #include <cstdio>
+#include <cstdlib>
 #include <string>
-#include <iostream>
+#include "allocprofile.hpp"
 #include "heap.hpp"
+#include "isolate.hpp"
 #include "objectmodel.hpp"
+#include "vm-compiler.hpp"
+#include "vm-image.hpp"
+#include "vm-interp.hpp"
+#include "vm-perf.hpp"
+#include "vm-prelude.hpp"
+#include "vm-profile.hpp"
+#include "snapshot.hpp"
 #include "sparse/parse_api.h"
+#include "sparse/scm_reader.hpp"
 #include "inlines.hpp"
 
 using namespace sanya;
 
 int main(int argc, const char *argv[])
 {
+    // SANYA_HEAP_MB is the size of each half of the heap in megabytes,
+    // such as for programs that spawn many tasks.
+    const char *heap_mb = getenv("SANYA_HEAP_MB");
+    Isolate isolate(heap_mb ? atol(heap_mb) * Heap::MB : Heap::kDefaultSize);
+    Isolate::Scope scope(&isolate);
+
+    // SANYA_SNAPSHOT names a snapshot of the heap after the prelude is
+    // installed, it's written if it can't be restored.
+    const char *snapshot_path = getenv("SANYA_SNAPSHOT");
+    if (!snapshot_path || !Snapshot::Restore(snapshot_path)) {
+        vm_prelude::Install();
+        if (snapshot_path) {
+            Snapshot::Save(snapshot_path);
+        }
+    }
+
+    // SANYA_OLD_SPACE_MB promotes what survives the nursery into an old
+    // space of that many megabytes, which is collected in slices rather
+    // than copied at every collection (see oldspace.hpp).
+    const char *old_space_mb = getenv("SANYA_OLD_SPACE_MB");
+    if (old_space_mb) {
+        Heap::Get().EnableOldSpace(atol(old_space_mb) * Heap::MB);
+    }
+
+    // SANYA_PROFILE names a file for the folded stacks of a sampling
+    // profile, taken SANYA_PROFILE_HZ times per second of CPU time.
+    const char *profile_path = getenv("SANYA_PROFILE");
+    if (profile_path) {
+        const char *hz = getenv("SANYA_PROFILE_HZ");
+        if (!vm_profile::Start(hz ? atoi(hz) : 1000)) {
+            fprintf(stderr, "can't start the profiler\n");
+            profile_path = NULL;
+        }
+    }
+
+    // SANYA_ALLOC_PROFILE names a file for the allocation sites, sampled
+    // every SANYA_ALLOC_PROFILE_BYTES bytes.
+    const char *alloc_profile_path = getenv("SANYA_ALLOC_PROFILE");
+    if (alloc_profile_path) {
+        const char *bytes = getenv("SANYA_ALLOC_PROFILE_BYTES");
+        AllocationProfile::set_site_function(
+                vm_interp::Interp::RunningProcedure);
+        AllocationProfile::Start(bytes ? atol(bytes) : 4096);
+    }
+
+    // SANYA_PERF_MAP writes /tmp/perf-<pid>.map, and SANYA_JITDUMP names
+    // a directory for a jitdump, for perf to see the jit'ed procedures.
+    const char *jitdump_dir = getenv("SANYA_JITDUMP");
+    if (!vm_perf::Start(getenv("SANYA_PERF_MAP") != NULL, jitdump_dir)) {
+        fprintf(stderr, "can't write the perf map or the jitdump\n");
+    }
+
     Handle expr = RawNil::Wrap();
+    Handle closure = RawNil::Wrap();
+    vm_interp::Interp interp;
 
-    while (true) {
-        std::string line;
-        std::getline(std::cin, line);
-        expr = sparse_do_string(line.c_str());
-        if (!expr.raw()) {
-            break;
+    if (argc > 1) {
+        // foo.scm is compiled into foo.scmc, which is used instead as
+        // long as it's newer.
+        std::string image_path = std::string(argv[1]) + "c";
+        RawClosure *loaded = vm_image::Load(image_path.c_str(), argv[1]);
+        if (loaded) {
+            closure = loaded;
+        }
+        else {
+            FILE *fp = fopen(argv[1], "r");
+            if (!fp) {
+                perror(argv[1]);
+                return 1;
+            }
+            expr = sparse_do_file(fp);
+            fclose(fp);
+            if (expr.raw()) {
+                closure = vm_compiler::Compile(expr);
+                vm_image::Save(image_path.c_str(), closure);
+            }
+        }
+        if (closure.raw()->IsClosure()) {
+            interp.Run(closure);
         }
-        //Heap::Get().TriggerCollection();
-        expr.raw()->Write(stdout);
     }
 
+    if (argc <= 1) {
+        // Forms may span lines, each is run once it's complete.
+        SexprReader reader(0);
+        SexprReader::Status status;
+        while ((status = reader.Read(&expr)) != SexprReader::kEnd) {
+            if (status != SexprReader::kDatum) {
+                continue;
+            }
+            expr = RawPair::Wrap(expr, RawNil::Wrap());
+            closure = vm_compiler::Compile(expr);
+            interp.Run(closure)->Write(stdout);
+            printf("\n");
+        }
+    }
+
+    vm_perf::Stop();
+#ifdef SANYA_OPCODE_PROFILE
+    interp.DumpOpcodeProfile(stderr);
+#endif
+    if (profile_path) {
+        vm_profile::Stop();
+        FILE *fp = fopen(profile_path, "w");
+        if (!fp) {
+            perror(profile_path);
+            return 1;
+        }
+        vm_profile::Dump(fp);
+        fclose(fp);
+    }
+    if (alloc_profile_path) {
+        AllocationProfile::Stop();
+        FILE *fp = fopen(alloc_profile_path, "w");
+        if (!fp) {
+            perror(alloc_profile_path);
+            return 1;
+        }
+        AllocationProfile::Dump(fp);
+        fclose(fp);
+    }
     return 0;
 }
 
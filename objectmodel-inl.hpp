@@ -2,6 +2,7 @@
 #define OBJECTMODEL_INL_HPP
 #include <algorithm>
 #include "sanya.hpp"
+#include "allocprofile.hpp"
 
 namespace sanya {
 
@@ -11,6 +12,11 @@ void *RawObject::operator new(size_t size) {
 
     // Size is set in the heap since alignment may occur.
     o->self_ = (RawHeapObject *)o;
+
+    // Never reached unless the allocation profile is on.
+    if ((AllocationProfile::countdown_s -= o->object_size_) < 0) {
+        AllocationProfile::Sample(o);
+    }
     return ptr;
 }
 
@@ -57,6 +63,14 @@ void RawObject::Write(FILE *stream) const {
         case kBooleanType:
             fprintf(stream, "%s", ((RawBoolean *)this)->Unwrap() ? "#t" : "#f");
             break;
+        case kTagType:
+            if (((RawTag *)this)->Unwrap() == RawTag::kEof) {
+                fprintf(stream, "#<eof>");
+            }
+            else {
+                fprintf(stream, "#<tag %d>", ((RawTag *)this)->Unwrap());
+            }
+            break;
         default:
             Write_V(stream);
     }
@@ -94,11 +108,85 @@ bool RawObject::IsDict() const {
     return object_type() == kDictType;
 }
 
+bool RawObject::IsCell() const {
+    return object_type() == kCellType;
+}
+
+bool RawObject::IsProcedure() const {
+    return object_type() == kProcedureType;
+}
+
+bool RawObject::IsClosure() const {
+    return object_type() == kClosureType;
+}
+
+bool RawObject::IsNative() const {
+    return object_type() == kNativeType;
+}
+
+bool RawObject::IsFlonum() const {
+    return object_type() == kFlonumType;
+}
+
+bool RawObject::IsString() const {
+    return object_type() == kStringType;
+}
+
+bool RawObject::IsContinuation() const {
+    return object_type() == kContinuationType;
+}
+
+bool RawObject::IsPort() const {
+    return object_type() == kPortType;
+}
+
 RawFixnum *RawFixnum::Wrap(intptr_t int_val) {
-    // XXX: overflow check
     return (RawFixnum *)((int_val << kNonHeapTypeShift) | kFixnumType);
 }
 
+bool RawFixnum::CanWrap(intptr_t int_val) {
+    return int_val >= kMinValue && int_val <= kMaxValue;
+}
+
+bool RawFixnum::BothFixnums(RawObject *lhs, RawObject *rhs) {
+    return ((((uintptr_t)lhs ^ kFixnumType) | ((uintptr_t)rhs ^ kFixnumType))
+            & kNonHeapTypeMask) == 0;
+}
+
+// With x and y being the tagged words (a << 4 | 1) and (b << 4 | 1):
+// x + (y - 1) is (a + b) << 4 | 1, x - (y - 1) is (a - b) << 4 | 1
+// and (x - 1) * (y >> 4) + 1 is (a * b) << 4 | 1.
+
+bool RawFixnum::Add(RawFixnum *lhs, RawFixnum *rhs, RawFixnum **result) {
+    intptr_t sum;
+    if (__builtin_add_overflow((intptr_t)lhs, (intptr_t)rhs - kFixnumType,
+                               &sum)) {
+        return false;
+    }
+    *result = (RawFixnum *)sum;
+    return true;
+}
+
+bool RawFixnum::Sub(RawFixnum *lhs, RawFixnum *rhs, RawFixnum **result) {
+    intptr_t difference;
+    if (__builtin_sub_overflow((intptr_t)lhs, (intptr_t)rhs - kFixnumType,
+                               &difference)) {
+        return false;
+    }
+    *result = (RawFixnum *)difference;
+    return true;
+}
+
+bool RawFixnum::Mul(RawFixnum *lhs, RawFixnum *rhs, RawFixnum **result) {
+    intptr_t product;
+    if (__builtin_mul_overflow((intptr_t)lhs - kFixnumType,
+                               rhs->Unwrap(), &product)) {
+        return false;
+    }
+    *result = (RawFixnum *)(product | kFixnumType);
+    return true;
+}
+
 intptr_t RawFixnum::Unwrap() const {
     return ((intptr_t)this) >> kNonHeapTypeShift;
 }
@@ -115,6 +203,14 @@ intptr_t RawBoolean::Unwrap() const {
     return ((intptr_t)this) >> kNonHeapTypeShift;
 }
 
+RawTag *RawTag::Wrap(Tag tag_val) {
+    return (RawTag *)(((intptr_t)tag_val << kNonHeapTypeShift) | kTagType);
+}
+
+RawTag::Tag RawTag::Unwrap() const {
+    return (Tag)(((intptr_t)this) >> kNonHeapTypeShift);
+}
+
 RawPair::RawPair() {
     object_type_ = kPairType;
 }
@@ -135,23 +231,29 @@ RawObject *RawPair::cdr() const {
 }
 
 void RawPair::set_car(RawObject *new_car) {
+    Heap::Get().WriteBarrier(this, car_, new_car);
     car_ = new_car;
 }
 
 void RawPair::set_cdr(RawObject *new_cdr) {
+    Heap::Get().WriteBarrier(this, cdr_, new_cdr);
     cdr_ = new_cdr;
 }
 
 RawSymbol::RawSymbol(const char *s, size_t len) {
     object_type_ = kSymbolType;
-    std::copy(s, s + len + 1, sval_);
+    std::copy(s, s + len, sval_);
+    sval_[len] = '\0';
     this->len_ = len;
     this->hash_ = StringHash(s, len);
     this->interned_ = false;
 }
 
 RawSymbol *RawSymbol::Wrap(const char *str_val) {
-    size_t len = strlen(str_val);
+    return Wrap(str_val, strlen(str_val));
+}
+
+RawSymbol *RawSymbol::Wrap(const char *str_val, size_t len) {
     void *addr = RawObject::operator new(sizeof(RawSymbol) + len + 1);
     return (RawSymbol *)::new (addr) RawSymbol(str_val, len);
 }
@@ -202,12 +304,52 @@ bool RawSymbol::SymbolEq(RawSymbol *lhs, RawSymbol *rhs) {
         }
         const char *lhs_str = lhs->Unwrap();
         const char *rhs_str = rhs->Unwrap();
-        printf("comparing %s with %s\n", lhs_str, rhs_str);
+        //printf("comparing %s with %s\n", lhs_str, rhs_str);
         size_t lhs_len = lhs->length();
-        return std::equal(lhs_str, lhs_str + lhs_len, rhs->Unwrap());
+        return std::equal(lhs_str, lhs_str + lhs_len, rhs_str);
+    }
+}
+
+RawFlonum::RawFlonum(double value)
+    : value_(value) {
+    object_type_ = kFlonumType;
+}
+
+RawFlonum *RawFlonum::Wrap(double value) {
+    return new RawFlonum(value);
+}
+
+double RawFlonum::Unwrap() const {
+    return value_;
+}
+
+// The characters are left alone if s is NULL.
+RawString::RawString(const char *s, size_t length)
+    : kind_(kFlat),
+      depth_(0),
+      length_(length),
+      left_(NULL),
+      right_(NULL),
+      offset_(0) {
+    object_type_ = kStringType;
+    if (s) {
+        memcpy(chars_, s, length);
     }
 }
 
+RawString *RawString::Wrap(const char *s, size_t length) {
+    void *addr = RawObject::operator new(sizeof(RawString) + length);
+    return (RawString *)::new (addr) RawString(s, length);
+}
+
+size_t RawString::length() const {
+    return length_;
+}
+
+uint32_t RawString::depth() const {
+    return kind_ == kRope ? depth_ : 0;
+}
+
 RawVector *RawVector::Wrap(size_t length, const Handle &fill) {
     void *addr = RawObject::operator new(sizeof(RawVector) +
             length * sizeof(RawObject *));
@@ -240,14 +382,21 @@ size_t RawVector::length() const {
     return length_;
 }
 
-RawGrowableVector::RawGrowableVector()
-    : usage_(0) {
-    Handle self = this;
-    data_ = RawVector::Wrap(kInitSize, RawNil::Wrap());
+void RawVector::Set(size_t index, RawObject *value) {
+    RawObject *&slot = At(index);
+    Heap::Get().WriteBarrier(this, slot, value);
+    slot = value;
+}
+
+RawGrowableVector::RawGrowableVector(RawVector *data)
+    : usage_(0),
+      data_(data) {
+    object_type_ = kGrowableVectorType;
 }
 
 RawGrowableVector *RawGrowableVector::Wrap() {
-    return new RawGrowableVector();
+    Handle data = RawVector::Wrap(kInitSize, RawNil::Wrap());
+    return new RawGrowableVector(&data.AsVector());
 }
 
 RawObject *& RawGrowableVector::At(intptr_t index) {
@@ -270,14 +419,19 @@ size_t RawGrowableVector::length() const {
 
 RawObject *RawGrowableVector::Pop() {
     Handle retval = At(-1);
-    At(-1) = RawNil::Wrap();
+    RawObject *&last = At(-1);
+    Heap::Get().WriteBarrier(data_, last, RawNil::Wrap());
+    last = RawNil::Wrap();
     DecreaseUsage();
     return retval.raw();
 }
 
 void RawGrowableVector::Append(const Handle &o) {
+    // We may be moved during the resize.
+    Handle self = this;
     IncreaseUsage();
-    At(-1) = o.raw();
+    RawGrowableVector &gv = self.AsGrowableVector();
+    gv.data_->Set(gv.usage_ - 1, o.raw());
 }
 
 void RawGrowableVector::DecreaseUsage() {
@@ -296,13 +450,11 @@ void RawGrowableVector::IncreaseUsage() {
     }
 }
 
-RawDict::RawDict()
+RawDict::RawDict(RawVector *vec)
     : used_(0),
-      size_(kPrimes[0]),
-      vec_(NULL) {
-    Handle self = this;
+      size_(vec->length()),
+      vec_(vec) {
     object_type_ = kDictType;
-    self.AsDict().vec_ = RawVector::Wrap(size_, RawNil::Wrap());
 }
 
 void RawDict::IncreaseUsage() {
@@ -336,6 +488,298 @@ void RawDict::DecreaseUsage() {
     }
 }
 
+RawCell::RawCell() {
+    object_type_ = kCellType;
+}
+
+RawCell *RawCell::Wrap(const Handle &value) {
+    RawCell *self = new RawCell();
+    self->value_ = value.raw();
+    return self;
+}
+
+RawObject *RawCell::value() const {
+    return value_;
+}
+
+void RawCell::set_value(RawObject *new_value) {
+    Heap::Get().WriteBarrier(this, value_, new_value);
+    value_ = new_value;
+}
+
+RawProcedure::RawProcedure()
+    : hotness_(0),
+      jit_code_(NULL) {
+    object_type_ = kProcedureType;
+}
+
+RawProcedure *RawProcedure::Wrap(uint32_t *code, size_t code_length,
+                                 bool owns_code,
+                                 const Handle &consts,
+                                 const Handle &name,
+                                 intptr_t arity, bool has_rest,
+                                 intptr_t frame_size, intptr_t num_free) {
+    RawProcedure *self = new RawProcedure();
+    self->code_ = code;
+    self->code_length_ = code_length;
+    self->owns_code_ = owns_code;
+    self->consts_ = &consts.AsVector();
+    self->name_ = name.raw();
+    self->arity_ = arity;
+    self->has_rest_ = has_rest;
+    self->frame_size_ = frame_size;
+    self->num_free_ = num_free;
+    if (owns_code) {
+        Heap::Get().AddFinalizer(self);
+    }
+    return self;
+}
+
+const uint32_t *RawProcedure::code() const {
+    return code_;
+}
+
+size_t RawProcedure::code_length() const {
+    return code_length_;
+}
+
+RawVector *RawProcedure::consts() const {
+    return consts_;
+}
+
+RawObject *RawProcedure::name() const {
+    return name_;
+}
+
+intptr_t RawProcedure::arity() const {
+    return arity_;
+}
+
+bool RawProcedure::has_rest() const {
+    return has_rest_;
+}
+
+intptr_t RawProcedure::frame_size() const {
+    return frame_size_;
+}
+
+intptr_t RawProcedure::num_free() const {
+    return num_free_;
+}
+
+intptr_t RawProcedure::IncreaseHotness() {
+    return ++hotness_;
+}
+
+void *RawProcedure::jit_code() const {
+    return jit_code_;
+}
+
+void RawProcedure::set_jit_code(void *code) {
+    jit_code_ = code;
+}
+
+RawClosure::RawClosure(RawProcedure *proc)
+    : proc_(proc) {
+    object_type_ = kClosureType;
+    std::fill(env_, env_ + proc->num_free(), RawNil::Wrap());
+}
+
+RawClosure *RawClosure::Wrap(const Handle &proc) {
+    void *addr = RawObject::operator new(sizeof(RawClosure) +
+            proc.AsProcedure().num_free() * sizeof(RawObject *));
+    return (RawClosure *)::new (addr) RawClosure(&proc.AsProcedure());
+}
+
+RawProcedure *RawClosure::proc() const {
+    return proc_;
+}
+
+RawObject *& RawClosure::At(size_t index) {
+    return env_[index];
+}
+
+RawObject *const& RawClosure::At(size_t index) const {
+    return env_[index];
+}
+
+RawNative::RawNative(Function fn, intptr_t arity, const char *name)
+    : fn_(fn),
+      arity_(arity),
+      name_(name) {
+    object_type_ = kNativeType;
+}
+
+RawNative *RawNative::Wrap(Function fn, intptr_t arity, const char *name) {
+    return new RawNative(fn, arity, name);
+}
+
+RawObject *RawNative::Call(intptr_t argc, RawObject **argv) const {
+    return fn_(argc, argv);
+}
+
+intptr_t RawNative::arity() const {
+    return arity_;
+}
+
+const char *RawNative::name() const {
+    return name_;
+}
+
+RawContinuation::RawContinuation() {
+    object_type_ = kContinuationType;
+}
+
+RawContinuation *RawContinuation::Wrap(const Handle &stack,
+                                       const Handle &frames,
+                                       const Handle &parent, State state,
+                                       intptr_t base, intptr_t pc,
+                                       intptr_t slot, intptr_t task) {
+    RawContinuation *self = new RawContinuation();
+    self->stack_ = stack.raw();
+    self->frames_ = frames.raw();
+    self->parent_ = parent.raw();
+    self->next_ = RawNil::Wrap();
+    self->value_ = RawNil::Wrap();
+    self->state_ = state;
+    self->base_ = base;
+    self->pc_ = pc;
+    self->slot_ = slot;
+    self->task_ = task;
+    return self;
+}
+
+RawVector *RawContinuation::stack() const {
+    return (RawVector *)stack_;
+}
+
+RawVector *RawContinuation::frames() const {
+    return (RawVector *)frames_;
+}
+
+RawObject *RawContinuation::parent() const {
+    return parent_;
+}
+
+RawObject *RawContinuation::next() const {
+    return next_;
+}
+
+void RawContinuation::set_next(RawObject *next) {
+    Heap::Get().WriteBarrier(this, next_, next);
+    next_ = next;
+}
+
+RawObject *RawContinuation::value() const {
+    return value_;
+}
+
+void RawContinuation::set_value(RawObject *value) {
+    Heap::Get().WriteBarrier(this, value_, value);
+    value_ = value;
+}
+
+RawContinuation::State RawContinuation::state() const {
+    return state_;
+}
+
+intptr_t RawContinuation::base() const {
+    return base_;
+}
+
+intptr_t RawContinuation::pc() const {
+    return pc_;
+}
+
+intptr_t RawContinuation::slot() const {
+    return slot_;
+}
+
+intptr_t RawContinuation::task() const {
+    return task_;
+}
+
+void RawContinuation::MarkResumed() {
+    Heap &heap = Heap::Get();
+    heap.WriteBarrier(this, stack_, NULL);
+    heap.WriteBarrier(this, frames_, NULL);
+    heap.WriteBarrier(this, parent_, NULL);
+    heap.WriteBarrier(this, value_, NULL);
+    stack_ = RawNil::Wrap();
+    frames_ = RawNil::Wrap();
+    parent_ = RawNil::Wrap();
+    value_ = RawNil::Wrap();
+    state_ = kResumed;
+}
+
+RawPort::RawPort(int fd, Kind kind)
+    : fd_(fd),
+      kind_(kind),
+      eof_(false),
+      in_start_(0),
+      in_end_(0),
+      out_end_(0) {
+    object_type_ = kPortType;
+}
+
+RawPort *RawPort::Wrap(int fd, Kind kind) {
+    size_t buffers_size = kind == kStream ? 2 * kBufferSize : 0;
+    void *addr = RawObject::operator new(sizeof(RawPort) + buffers_size);
+    return (RawPort *)::new (addr) RawPort(fd, kind);
+}
+
+int RawPort::fd() const {
+    return fd_;
+}
+
+void RawPort::set_fd(int fd) {
+    fd_ = fd;
+}
+
+RawPort::Kind RawPort::kind() const {
+    return kind_;
+}
+
+bool RawPort::eof() const {
+    return eof_;
+}
+
+void RawPort::set_eof(bool eof) {
+    eof_ = eof;
+}
+
+char *RawPort::in_buffer() {
+    return buffers_;
+}
+
+size_t RawPort::in_start() const {
+    return in_start_;
+}
+
+void RawPort::set_in_start(size_t start) {
+    in_start_ = start;
+}
+
+size_t RawPort::in_end() const {
+    return in_end_;
+}
+
+void RawPort::set_in_end(size_t end) {
+    in_end_ = end;
+}
+
+char *RawPort::out_buffer() {
+    return buffers_ + kBufferSize;
+}
+
+size_t RawPort::out_end() const {
+    return out_end_;
+}
+
+void RawPort::set_out_end(size_t end) {
+    out_end_ = end;
+}
+
 }  // namespace sanya
 
 // vim: set ts=4 sw=4 sts=4:
@@ -1,5 +1,8 @@
 
 #include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
 #include "objectmodel.hpp"
 #include "inlines.hpp"
 
@@ -42,6 +45,265 @@ intptr_t RawSymbol::Hash_V() const {
     return hash_;
 }
 
+void RawFlonum::Write_V(FILE *stream) const {
+    if (value_ != value_) {
+        fprintf(stream, "+nan.0");
+        return;
+    }
+    if (value_ - value_ != 0) {
+        fprintf(stream, value_ > 0 ? "+inf.0" : "-inf.0");
+        return;
+    }
+
+    // The fewest digits that read back as the same value.
+    char buf[32];
+    int precision = 1;
+    for (; precision < 17; ++precision) {
+        snprintf(buf, sizeof(buf), "%.*e", precision - 1, value_);
+        if (strtod(buf, NULL) == value_) {
+            break;
+        }
+    }
+    snprintf(buf, sizeof(buf), "%.*e", precision - 1, value_);
+    char *e = strchr(buf, 'e');
+    int exponent = atoi(e + 1);
+
+    // Like 0.000001 and 1e-7, or 100000000000000000000.0 and 1e21. There
+    // is always a point or an exponent, so that they read back as
+    // flonums.
+    if (exponent >= -7 && exponent < 21) {
+        int decimals = precision - 1 - exponent;
+        fprintf(stream, "%.*f", decimals > 1 ? decimals : 1, value_);
+    }
+    else {
+        *e = '\0';
+        fprintf(stream, "%se%d", buf, exponent);
+    }
+}
+
+intptr_t RawFlonum::Hash_V() const {
+    intptr_t bits;
+    memcpy(&bits, &value_, sizeof(bits));
+    return bits;
+}
+
+RawString *RawString::Substring(const Handle &str, size_t start,
+                                size_t end) {
+    size_t length = end - start;
+    if (length == str.AsString().length_) {
+        return &str.AsString();
+    }
+    if (length < kMinSliceLength) {
+        RawString *result = Wrap(NULL, length);
+        str.AsString().CopyRange(result->chars_, start, length);
+        return result;
+    }
+
+    Chars(str);
+    RawString *self = &str.AsString();
+    if (self->kind_ == kFlat) {
+        return NewSlice(str, start, length);
+    }
+    // Slices of slices share the same parent.
+    Handle parent = self->left_;
+    return NewSlice(parent, self->offset_ + start, length);
+}
+
+RawString *RawString::Append(const Handle &lhs, const Handle &rhs) {
+    RawString *left = &lhs.AsString();
+    RawString *right = &rhs.AsString();
+    if (right->length_ == 0) {
+        return left;
+    }
+    if (left->length_ == 0) {
+        return right;
+    }
+    size_t length = left->length_ + right->length_;
+    if (length < kMinRopeLength) {
+        RawString *result = Wrap(NULL, length);
+        lhs.AsString().CopyTo(result->chars_);
+        rhs.AsString().CopyTo(result->chars_ + lhs.AsString().length_);
+        return result;
+    }
+
+    // Small appends go into the last leaf, which keeps the depth.
+    if (left->kind_ == kRope && left->right_->kind_ != kRope &&
+            left->right_->length_ + right->length_ < kMinRopeLength) {
+        Handle first = left->left_;
+        Handle last = left->right_;
+        Handle merged = Append(last, rhs);
+        return NewRope(first, merged);
+    }
+    return Join(lhs, rhs);
+}
+
+const char *RawString::Chars(const Handle &str) {
+    RawString *self = &str.AsString();
+    if (self->kind_ == kFlat) {
+        return self->chars_;
+    }
+    if (self->kind_ == kRope) {
+        // Becomes a slice of all of the flat string. The depth is kept as
+        // it was, see depth().
+        RawString *flat = Wrap(NULL, self->length_);
+        self = &str.AsString();
+        self->CopyTo(flat->chars_);
+        Heap::Get().WriteBarrier(self, self->left_, flat);
+        Heap::Get().WriteBarrier(self, self->right_, NULL);
+        self->kind_ = kSlice;
+        self->left_ = flat;
+        self->right_ = NULL;
+        self->offset_ = 0;
+    }
+    return self->left_->chars_ + self->offset_;
+}
+
+void RawString::CopyTo(char *out) const {
+    CopyRange(out, 0, length_);
+}
+
+void RawString::CopyRange(char *out, size_t start, size_t length) const {
+    const RawString *self = this;
+    while (length) {
+        if (self->kind_ == kFlat) {
+            memcpy(out, self->chars_ + start, length);
+            return;
+        }
+        if (self->kind_ == kSlice) {
+            memcpy(out, self->left_->chars_ + self->offset_ + start, length);
+            return;
+        }
+        // Recurse on the left only, ropes are balanced.
+        size_t left_length = self->left_->length_;
+        if (start < left_length) {
+            size_t count = std::min(length, left_length - start);
+            self->left_->CopyRange(out, start, count);
+            out += count;
+            length -= count;
+            start = 0;
+        }
+        else {
+            start -= left_length;
+        }
+        self = self->right_;
+    }
+}
+
+bool RawString::Equal(RawString *lhs, RawString *rhs) {
+    if (lhs->length_ != rhs->length_) {
+        return false;
+    }
+    std::vector<char> lhs_chars(lhs->length_ + 1);
+    std::vector<char> rhs_chars(rhs->length_ + 1);
+    lhs->CopyTo(&lhs_chars[0]);
+    rhs->CopyTo(&rhs_chars[0]);
+    return lhs_chars == rhs_chars;
+}
+
+void RawString::Display(FILE *stream) const {
+    std::vector<char> chars(length_ + 1);
+    CopyTo(&chars[0]);
+    fwrite(&chars[0], 1, length_, stream);
+}
+
+void RawString::Write_V(FILE *stream) const {
+    std::vector<char> chars(length_ + 1);
+    CopyTo(&chars[0]);
+    fputc('"', stream);
+    for (size_t i = 0; i < length_; ++i) {
+        switch (chars[i]) {
+            case '"':   fputs("\\\"", stream); break;
+            case '\\':  fputs("\\\\", stream); break;
+            case '\n':  fputs("\\n", stream); break;
+            case '\t':  fputs("\\t", stream); break;
+            default:    fputc(chars[i], stream); break;
+        }
+    }
+    fputc('"', stream);
+}
+
+intptr_t RawString::Hash_V() const {
+    std::vector<char> chars(length_ + 1);
+    CopyTo(&chars[0]);
+    return RawSymbol::StringHash(&chars[0], length_);
+}
+
+void RawString::UpdateInteriorPointers(Heap &heap) {
+    if (kind_ != kFlat) {
+        left_ = (RawString *)heap.MarkAndCopy(left_);
+    }
+    if (kind_ == kRope) {
+        right_ = (RawString *)heap.MarkAndCopy(right_);
+    }
+}
+
+RawString *RawString::NewSlice(const Handle &parent, size_t offset,
+                               size_t length) {
+    RawString *result = Wrap(NULL, 0);
+    result->kind_ = kSlice;
+    result->length_ = length;
+    result->left_ = &parent.AsString();
+    result->offset_ = offset;
+    return result;
+}
+
+RawString *RawString::NewRope(const Handle &left, const Handle &right) {
+    RawString *result = Wrap(NULL, 0);
+    result->kind_ = kRope;
+    result->depth_ = std::max(left.AsString().depth(),
+                              right.AsString().depth()) + 1;
+    result->length_ = left.AsString().length_ + right.AsString().length_;
+    result->left_ = &left.AsString();
+    result->right_ = &right.AsString();
+    return result;
+}
+
+// The join of AVL trees: go down the side of the deeper one until the
+// depths are close, and rotate on the way back up if that got too deep.
+RawString *RawString::Join(const Handle &lhs, const Handle &rhs) {
+    uint32_t lhs_depth = lhs.AsString().depth();
+    uint32_t rhs_depth = rhs.AsString().depth();
+    if (lhs_depth > rhs_depth + 1) {
+        Handle outer = lhs.AsString().left_;
+        Handle inner = lhs.AsString().right_;
+        Handle joined = Join(inner, rhs);
+        if (joined.AsString().depth() <= outer.AsString().depth() + 1) {
+            return NewRope(outer, joined);
+        }
+        Handle middle = joined.AsString().left_;
+        Handle last = joined.AsString().right_;
+        if (middle.AsString().depth() <= last.AsString().depth()) {
+            Handle first = NewRope(outer, middle);
+            return NewRope(first, last);
+        }
+        Handle middle_left = middle.AsString().left_;
+        Handle middle_right = middle.AsString().right_;
+        Handle first = NewRope(outer, middle_left);
+        Handle second = NewRope(middle_right, last);
+        return NewRope(first, second);
+    }
+    if (rhs_depth > lhs_depth + 1) {
+        Handle outer = rhs.AsString().right_;
+        Handle inner = rhs.AsString().left_;
+        Handle joined = Join(lhs, inner);
+        if (joined.AsString().depth() <= outer.AsString().depth() + 1) {
+            return NewRope(joined, outer);
+        }
+        Handle first = joined.AsString().left_;
+        Handle middle = joined.AsString().right_;
+        if (middle.AsString().depth() <= first.AsString().depth()) {
+            Handle last = NewRope(middle, outer);
+            return NewRope(first, last);
+        }
+        Handle middle_left = middle.AsString().left_;
+        Handle middle_right = middle.AsString().right_;
+        Handle second = NewRope(first, middle_left);
+        Handle last = NewRope(middle_right, outer);
+        return NewRope(second, last);
+    }
+    return NewRope(lhs, rhs);
+}
+
 RawVector::RawVector(size_t length, const Handle &fill) {
     object_type_ = kVectorType;
     this->length_ = length;
@@ -102,8 +364,16 @@ intptr_t RawGrowableVector::Hash_V() const {
 
 void RawGrowableVector::Resize(size_t to_size) {
     Handle self = this;
-    self.AsGrowableVector().data_
-        = RawVector::Wrap(data_, usage_, to_size, RawNil::Wrap());
+    Handle new_data = RawVector::Wrap(to_size, RawNil::Wrap());
+
+    // Copy after the allocation since the old data may have been moved.
+    RawGrowableVector &gv = self.AsGrowableVector();
+    size_t copy_howmany = std::min(gv.usage_, gv.data_->length());
+    for (size_t i = 0; i < copy_howmany; ++i) {
+        new_data.AsVector().At(i) = gv.data_->At(i);
+    }
+    Heap::Get().WriteBarrier(&gv, gv.data_, new_data.raw());
+    gv.data_ = &new_data.AsVector();
 }
 
 void RawGrowableVector::UpdateInteriorPointers(Heap &heap) {
@@ -130,7 +400,7 @@ RawPair *RawDict::LookupSymbol(const Handle& symbol, LookupFlag flag) {
         if (flag & kCreateOnAbsent) {
             Handle new_entry = RawPair::Wrap(symbol, RawNil::Wrap());
             Handle lis_item = RawPair::Wrap(new_entry.raw(), RawNil::Wrap());
-            vec.AsVector().At(bucket) = lis_item.raw();
+            vec.AsVector().Set(bucket, lis_item.raw());
             self.AsDict().IncreaseUsage();  // may enlarge and rehash
             return &new_entry.AsPair();
         }
@@ -168,7 +438,7 @@ found:
     if (flag & kDeleteOnFound) {
         if (iter.raw() == head.raw()) {
             // Removing the first item in the list -- should modify vector.
-            vec.AsVector().At(bucket) = iter.AsPair().cdr();
+            vec.AsVector().Set(bucket, iter.AsPair().cdr());
         }
         else {
             dummy_head.AsPair().set_cdr(iter.AsPair().cdr());
@@ -178,8 +448,22 @@ found:
     return &entry.AsPair();
 }
 
+RawPair *RawDict::FindSymbol(const char *s, size_t len) const {
+    size_t bucket = RawSymbol::StringHash(s, len) % size_;
+    RawObject *iter = vec_->At(bucket);
+    while (!iter->IsNil()) {
+        RawPair *entry = (RawPair *)((RawPair *)iter)->car();
+        RawSymbol *key = (RawSymbol *)entry->car();
+        if (key->length() == len && memcmp(key->Unwrap(), s, len) == 0) {
+            return entry;
+        }
+        iter = ((RawPair *)iter)->cdr();
+    }
+    return NULL;
+}
+
 void RawDict::Resize(const size_t new_size) {
-    printf("Resize from %ld to %ld\n", size_, new_size);
+    //printf("Resize from %ld to %ld\n", size_, new_size);
     Handle self = this;
     const size_t old_length = vec_->length();
     Handle old_vec = vec_;
@@ -192,13 +476,14 @@ void RawDict::Resize(const size_t new_size) {
             Handle key = item.AsPair().car();
             const intptr_t hash = key.AsSymbol().Hash();
             const size_t bucket = hash % new_size;
-            printf("Rehashing from %ld to %ld\n",
-                    hash % (old_length - 1), bucket);
+            //printf("Rehashing from %ld to %ld\n",
+            //        hash % (old_length - 1), bucket);
             new_vec.AsVector().At(bucket)
                 = RawPair::Wrap(item, new_vec.AsVector().At(bucket));
         }
     }
     self.AsDict().size_ = new_size;
+    Heap::Get().WriteBarrier(self.raw(), self.AsDict().vec_, new_vec.raw());
     self.AsDict().vec_ = &new_vec.AsVector();
 }
 
@@ -214,6 +499,92 @@ void RawDict::UpdateInteriorPointers(Heap &heap) {
     vec_ = (RawVector *)heap.MarkAndCopy(vec_);
 }
 
+void RawCell::Write_V(FILE *stream) const {
+    fprintf(stream, "#<cell ");
+    value_->Write(stream);
+    fprintf(stream, ">");
+}
+
+intptr_t RawCell::Hash_V() const {
+    FATAL_ERROR("mutable hash");
+}
+
+void RawCell::UpdateInteriorPointers(Heap &heap) {
+    value_ = heap.MarkAndCopy(value_);
+}
+
+void RawProcedure::Write_V(FILE *stream) const {
+    fprintf(stream, "#<procedure ");
+    name_->Write(stream);
+    fprintf(stream, ">");
+}
+
+intptr_t RawProcedure::Hash_V() const {
+    FATAL_ERROR("mutable hash");
+}
+
+void RawProcedure::UpdateInteriorPointers(Heap &heap) {
+    consts_ = (RawVector *)heap.MarkAndCopy(consts_);
+    name_ = heap.MarkAndCopy(name_);
+}
+
+void RawProcedure::Finalize() {
+    if (owns_code_) {
+        free(code_);
+        code_ = NULL;
+        owns_code_ = false;
+    }
+}
+
+void RawClosure::Write_V(FILE *stream) const {
+    fprintf(stream, "#<closure ");
+    proc_->name()->Write(stream);
+    fprintf(stream, ">");
+}
+
+intptr_t RawClosure::Hash_V() const {
+    FATAL_ERROR("mutable hash");
+}
+
+void RawClosure::UpdateInteriorPointers(Heap &heap) {
+    proc_ = (RawProcedure *)heap.MarkAndCopy(proc_);
+    for (intptr_t i = 0; i < proc_->num_free(); ++i) {
+        env_[i] = heap.MarkAndCopy(env_[i]);
+    }
+}
+
+void RawNative::Write_V(FILE *stream) const {
+    fprintf(stream, "#<native %s>", name_);
+}
+
+intptr_t RawNative::Hash_V() const {
+    FATAL_ERROR("mutable hash");
+}
+
+void RawContinuation::Write_V(FILE *stream) const {
+    fprintf(stream, "#<continuation>");
+}
+
+intptr_t RawContinuation::Hash_V() const {
+    FATAL_ERROR("mutable hash");
+}
+
+void RawContinuation::UpdateInteriorPointers(Heap &heap) {
+    stack_ = heap.MarkAndCopy(stack_);
+    frames_ = heap.MarkAndCopy(frames_);
+    parent_ = heap.MarkAndCopy(parent_);
+    next_ = heap.MarkAndCopy(next_);
+    value_ = heap.MarkAndCopy(value_);
+}
+
+void RawPort::Write_V(FILE *stream) const {
+    fprintf(stream, "#<port %d>", fd_);
+}
+
+intptr_t RawPort::Hash_V() const {
+    FATAL_ERROR("mutable hash");
+}
+
 }  // namespace sanya
 
 // vim: set ts=4 sw=4 sts=4:
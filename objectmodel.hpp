@@ -3,6 +3,7 @@
 
 #include <new>
 #include <cstring>
+#include <stdint.h>
 #include "sanya.hpp"
 #include "heap.hpp"
 #include "handle.hpp"
@@ -23,6 +24,9 @@ namespace sanya {
 
 class RawObject {
     friend class Heap;
+    friend class Message;
+    friend class OldSpace;
+    friend class Snapshot;
 public:
     static const uintptr_t kNonHeapTypeShift = 4;
     static const uintptr_t kNonHeapTypeMask = (1 << kNonHeapTypeShift) - 1;
@@ -37,7 +41,15 @@ public:
         kPairType,
         kVectorType,
         kGrowableVectorType,
-        kDictType
+        kDictType,
+        kCellType,
+        kProcedureType,
+        kClosureType,
+        kNativeType,
+        kFlonumType,
+        kStringType,
+        kContinuationType,
+        kPortType
     };
 
     virtual ~RawObject() { }
@@ -64,6 +76,14 @@ public:
     inline bool IsVector() const;
     inline bool IsGrowableVector() const;
     inline bool IsDict() const;
+    inline bool IsCell() const;
+    inline bool IsProcedure() const;
+    inline bool IsClosure() const;
+    inline bool IsNative() const;
+    inline bool IsFlonum() const;
+    inline bool IsString() const;
+    inline bool IsContinuation() const;
+    inline bool IsPort() const;
 
     virtual void Write_V(FILE *stream) const = 0;
     virtual intptr_t Hash_V() const = 0;
@@ -78,6 +98,10 @@ protected:
     // but is it possible that inlining it will greatly affect the performance?
     virtual void UpdateInteriorPointers(Heap &heap) = 0;
 
+    // Called once the object is dead, to release what it holds outside
+    // of the heap (see Heap::AddFinalizer).
+    virtual void Finalize() { }
+
     // Those may not present in non-heap objects
     uint32_t object_size_;
     ObjectType object_type_;
@@ -91,8 +115,26 @@ private:
 
 class RawFixnum : public RawObject {
 public:
+    static const intptr_t kMaxValue = INTPTR_MAX >> kNonHeapTypeShift;
+    static const intptr_t kMinValue = INTPTR_MIN >> kNonHeapTypeShift;
+
+    /** @brief The value is not checked, see CanWrap. */
     static inline RawFixnum *Wrap(intptr_t int_val);
+    static inline bool CanWrap(intptr_t int_val);
     inline intptr_t Unwrap() const;
+
+    static inline bool BothFixnums(RawObject *lhs, RawObject *rhs);
+
+    /**
+     * @brief Arithmetics done directly on the tagged words. Return false
+     * if the result overflows.
+     */
+    static inline bool Add(RawFixnum *lhs, RawFixnum *rhs,
+                           RawFixnum **result);
+    static inline bool Sub(RawFixnum *lhs, RawFixnum *rhs,
+                           RawFixnum **result);
+    static inline bool Mul(RawFixnum *lhs, RawFixnum *rhs,
+                           RawFixnum **result);
 };
 
 class RawNil : public RawObject {
@@ -106,12 +148,27 @@ public:
     inline intptr_t Unwrap() const;
 };
 
+/**
+ * @brief Immediate markers that are never visible to scheme code, e.g.
+ * the value of a global that is referenced before being defined.
+ */
+class RawTag : public RawObject {
+public:
+    enum Tag {
+        kUnbound = 0,
+        kEof
+    };
+    static inline RawTag *Wrap(Tag tag_val);
+    inline Tag Unwrap() const;
+};
+
 /**
  * @brief The baseclass for any raw object that is allocated on the
  * garbage-collected heap.
  */
 class RawHeapObject : public RawObject {
     friend class Heap;
+    friend class AllocationProfile;
 };
 
 class RawPair : public RawHeapObject {
@@ -140,6 +197,7 @@ private:
 class RawSymbol : public RawHeapObject {
 public:
     inline static RawSymbol *Wrap(const char *str_val);
+    inline static RawSymbol *Wrap(const char *str_val, size_t len);
     inline const char *Unwrap() const;
     inline size_t length() const;
     inline bool interned() const;
@@ -165,6 +223,106 @@ private:
     char sval_[0];
 };
 
+/**
+ * @brief A boxed double. Flonums are never mutated, so eqv? compares
+ * their values instead of their addresses.
+ */
+class RawFlonum : public RawHeapObject {
+public:
+    inline static RawFlonum *Wrap(double value);
+    inline double Unwrap() const;
+
+    virtual void Write_V(FILE *stream) const;
+    virtual intptr_t Hash_V() const;
+
+protected:
+    inline RawFlonum(double value);
+
+    // Dummy
+    virtual void UpdateInteriorPointers(Heap &heap) { }
+
+private:
+    double value_;
+};
+
+/**
+ * @brief An immutable string.
+ *
+ * Short strings keep their characters inline. Long substrings are slices
+ * that share the characters of their parent, and long results of
+ * string-append are ropes, which are kept balanced like AVL trees so
+ * that repeated appends don't copy what's already there. A rope is only
+ * turned into one flat string when its characters are asked for.
+ */
+class RawString : public RawHeapObject {
+    friend class SharedSpace;
+    friend class Snapshot;
+public:
+    // Shorter substrings are copied, so they don't keep a large parent
+    // alive.
+    static const size_t kMinSliceLength = 32;
+
+    // Shorter results of Append are copied into one flat string.
+    static const size_t kMinRopeLength = 256;
+
+    inline static RawString *Wrap(const char *s, size_t length);
+
+    /** @brief Characters [start, end) of str, which are not checked. */
+    static RawString *Substring(const Handle &str, size_t start,
+                                size_t end);
+    static RawString *Append(const Handle &lhs, const Handle &rhs);
+
+    /**
+     * @brief The characters of str, without a NUL. A rope is flattened
+     * first, so this may allocate. Valid until the next allocation.
+     */
+    static const char *Chars(const Handle &str);
+
+    inline size_t length() const;
+
+    /** @brief Copy the characters into out, without allocating. */
+    void CopyTo(char *out) const;
+    void CopyRange(char *out, size_t start, size_t length) const;
+
+    static bool Equal(RawString *lhs, RawString *rhs);
+
+    /** @brief Write the characters, without quotes. */
+    void Display(FILE *stream) const;
+
+    virtual void Write_V(FILE *stream) const;
+    virtual intptr_t Hash_V() const;
+
+protected:
+    inline RawString(const char *s, size_t length);
+
+    virtual void UpdateInteriorPointers(Heap &heap);
+
+private:
+    enum Kind {
+        kFlat,
+        kSlice,
+        kRope
+    };
+
+    static RawString *NewSlice(const Handle &parent, size_t offset,
+                               size_t length);
+    static RawString *NewRope(const Handle &left, const Handle &right);
+
+    // Concatenate two ropes, keeping them balanced.
+    static RawString *Join(const Handle &lhs, const Handle &rhs);
+
+    // Flattened ropes count as leaves.
+    inline uint32_t depth() const;
+
+    Kind kind_;
+    uint32_t depth_;
+    size_t length_;
+    RawString *left_;   // The flat parent of slices
+    RawString *right_;
+    size_t offset_;     // Into the parent
+    char chars_[0];     // Of flat strings
+};
+
 class RawVector : public RawHeapObject {
 public:
     static inline RawVector *Wrap(size_t length, const Handle &fill);
@@ -175,6 +333,12 @@ public:
     inline RawObject *const&At(size_t index) const;
     inline size_t length() const;
 
+    /**
+     * @brief At(index) = value, with the write barrier (see
+     * Heap::WriteBarrier) for vectors that may be old.
+     */
+    inline void Set(size_t index, RawObject *value);
+
     virtual void Write_V(FILE *stream) const;
     virtual intptr_t Hash_V() const;
 
@@ -192,6 +356,7 @@ private:
 };
 
 class RawGrowableVector : public RawHeapObject {
+    friend class Snapshot;
 public:
     static const size_t kInitSize = 4;
     static inline RawGrowableVector *Wrap();
@@ -206,7 +371,7 @@ public:
     virtual intptr_t Hash_V() const;
 
 protected:
-    inline RawGrowableVector();
+    inline RawGrowableVector(RawVector *data);
 
     inline void DecreaseUsage();
     inline void IncreaseUsage();
@@ -219,6 +384,7 @@ private:
 };
 
 class RawDict : public RawHeapObject {
+    friend class Snapshot;
 public:
     enum LookupFlag {
         kLookupDefault  = 1,
@@ -231,7 +397,10 @@ public:
     static const size_t kPrimes[kNumberPrimes];
 
     static RawDict *Wrap() {
-        return new RawDict();
+        // Allocate the buckets first since we may be moved during the
+        // allocation if it's done in the constructor.
+        Handle vec = RawVector::Wrap(kPrimes[0], RawNil::Wrap());
+        return new RawDict(&vec.AsVector());
     }
 
     virtual intptr_t Hash_V() const;
@@ -243,8 +412,14 @@ public:
      */
     RawPair *LookupSymbol(const Handle &key, LookupFlag flag);
 
+    /**
+     * @brief Find the entry of the symbol named s without allocating
+     * anything. Return NULL if not found.
+     */
+    RawPair *FindSymbol(const char *s, size_t len) const;
+
 protected:
-    inline RawDict();
+    inline RawDict(RawVector *vec);
 
     virtual void UpdateInteriorPointers(Heap &heap);
     void Resize(const size_t new_size);
@@ -257,6 +432,281 @@ private:
     RawVector *vec_;
 };
 
+/**
+ * @brief A mutable box for variables that are both captured by a closure
+ * and assigned to (see vm_insn::kBuildCell).
+ */
+class RawCell : public RawHeapObject {
+public:
+    inline static RawCell *Wrap(const Handle &value);
+
+    inline RawObject *value() const;
+    inline void set_value(RawObject *new_value);
+
+    virtual void Write_V(FILE *stream) const;
+    virtual intptr_t Hash_V() const;
+
+protected:
+    inline RawCell();
+
+    virtual void UpdateInteriorPointers(Heap &heap);
+
+private:
+    RawObject *value_;
+};
+
+/**
+ * @brief Compiled code for a lambda. Only the closure (see below) is
+ * callable, the procedure itself is just a template.
+ */
+class RawProcedure : public RawHeapObject {
+    friend class Snapshot;
+public:
+    /**
+     * @brief code is either malloc'ed by the compiler, in which case
+     * owns_code is true and it's freed along with the procedure, or
+     * mapped from an image (see vm-image.hpp) and never freed.
+     */
+    inline static RawProcedure *Wrap(uint32_t *code, size_t code_length,
+                                     bool owns_code,
+                                     const Handle &consts,
+                                     const Handle &name,
+                                     intptr_t arity, bool has_rest,
+                                     intptr_t frame_size, intptr_t num_free);
+
+    /**
+     * @brief Instructions (see vm-insn.hpp). They live outside of the
+     * heap so they are never moved.
+     */
+    inline const uint32_t *code() const;
+    inline size_t code_length() const;
+    inline RawVector *consts() const;
+    inline RawObject *name() const;
+
+    /** @brief Number of required arguments */
+    inline intptr_t arity() const;
+
+    /** @brief If true, extra arguments are passed as a list */
+    inline bool has_rest() const;
+
+    /** @brief Number of registers, including the closure at slot 0 */
+    inline intptr_t frame_size() const;
+
+    /** @brief Number of free variables captured by the closure */
+    inline intptr_t num_free() const;
+
+    /** @brief Counts calls and loop iterations, returns the new count */
+    inline intptr_t IncreaseHotness();
+
+    /** @brief Machine code from vm_jit, or NULL */
+    inline void *jit_code() const;
+    inline void set_jit_code(void *code);
+
+    virtual void Write_V(FILE *stream) const;
+    virtual intptr_t Hash_V() const;
+
+protected:
+    inline RawProcedure();
+
+    virtual void UpdateInteriorPointers(Heap &heap);
+    virtual void Finalize();
+
+private:
+    uint32_t *code_;
+    size_t code_length_;
+    bool owns_code_;
+    RawVector *consts_;
+    RawObject *name_;
+    intptr_t arity_;
+    bool has_rest_;
+    intptr_t frame_size_;
+    intptr_t num_free_;
+    intptr_t hotness_;
+    void *jit_code_;
+};
+
+class RawClosure : public RawHeapObject {
+public:
+    /** @brief The free variables are filled with nil. */
+    static inline RawClosure *Wrap(const Handle &proc);
+
+    inline RawProcedure *proc() const;
+    inline RawObject *&At(size_t index);
+    inline RawObject *const&At(size_t index) const;
+
+    virtual void Write_V(FILE *stream) const;
+    virtual intptr_t Hash_V() const;
+
+protected:
+    inline RawClosure(RawProcedure *proc);
+
+    virtual void UpdateInteriorPointers(Heap &heap);
+
+private:
+    RawProcedure *proc_;
+    RawObject *env_[0];
+};
+
+/**
+ * @brief Builtin procedure implemented in C++.
+ *
+ * Arguments are passed as a pointer into the interpreter's register window,
+ * which may be moved by the collector. Wrap them into handles before
+ * allocating anything.
+ */
+class RawNative : public RawHeapObject {
+    friend class Snapshot;
+public:
+    typedef RawObject *(*Function)(intptr_t argc, RawObject **argv);
+    static const intptr_t kVariadic = -1;
+
+    inline static RawNative *Wrap(Function fn, intptr_t arity,
+                                  const char *name);
+
+    inline RawObject *Call(intptr_t argc, RawObject **argv) const;
+    inline intptr_t arity() const;
+    inline const char *name() const;
+
+    virtual void Write_V(FILE *stream) const;
+    virtual intptr_t Hash_V() const;
+
+protected:
+    inline RawNative(Function fn, intptr_t arity, const char *name);
+
+    // Dummy
+    virtual void UpdateInteriorPointers(Heap &heap) { }
+
+private:
+    Function fn_;
+    intptr_t arity_;
+    const char *name_;
+};
+
+/**
+ * @brief A one-shot continuation of vm_interp::Interp: the value stack
+ * and the frames of a suspended task.
+ *
+ * The stack is taken over rather than copied, both when the continuation
+ * is made and when it's resumed, so it may be resumed only once. The
+ * frames are (base . pc) pairs flattened into a vector of fixnums.
+ */
+class RawContinuation : public RawHeapObject {
+public:
+    enum State {
+        kStart,     // Call the closure at slot 0 with no arguments
+        kCall,      // Store the value into slot, and go on at pc
+        kReturn,    // Return the value from the frame at base
+        kResumed
+    };
+
+    inline static RawContinuation *Wrap(const Handle &stack,
+                                        const Handle &frames,
+                                        const Handle &parent, State state,
+                                        intptr_t base, intptr_t pc,
+                                        intptr_t slot, intptr_t task);
+
+    inline RawVector *stack() const;
+    inline RawVector *frames() const;
+
+    /** @brief What the bottom frame returns into, or nil. */
+    inline RawObject *parent() const;
+
+    /** @brief The next one in the run queue of the interpreter, or nil. */
+    inline RawObject *next() const;
+    inline void set_next(RawObject *next);
+
+    /** @brief What it's resumed with from the run queue. */
+    inline RawObject *value() const;
+    inline void set_value(RawObject *value);
+
+    inline State state() const;
+    inline intptr_t base() const;
+    inline intptr_t pc() const;
+    inline intptr_t slot() const;
+    inline intptr_t task() const;
+
+    /** @brief Drop the stack and the frames, which were taken over. */
+    inline void MarkResumed();
+
+    virtual void Write_V(FILE *stream) const;
+    virtual intptr_t Hash_V() const;
+
+protected:
+    inline RawContinuation();
+
+    virtual void UpdateInteriorPointers(Heap &heap);
+
+private:
+    RawObject *stack_;
+    RawObject *frames_;
+    RawObject *parent_;
+    RawObject *next_;
+    RawObject *value_;
+    State state_;
+    intptr_t base_;
+    intptr_t pc_;
+    intptr_t slot_;
+    intptr_t task_;
+};
+
+/**
+ * @brief A file descriptor in non-blocking mode, with its buffers in the
+ * object itself (see vm-io.hpp for what's done with them).
+ *
+ * The descriptor isn't closed when the port is collected, the port has to
+ * be closed explicitly.
+ */
+class RawPort : public RawHeapObject {
+public:
+    static const size_t kBufferSize = 4096;
+
+    enum Kind {
+        kStream,
+        kListener   // Has no buffers
+    };
+
+    inline static RawPort *Wrap(int fd, Kind kind);
+
+    /** @brief -1 once closed. */
+    inline int fd() const;
+    inline void set_fd(int fd);
+    inline Kind kind() const;
+
+    /** @brief If the end of the input was read. */
+    inline bool eof() const;
+    inline void set_eof(bool eof);
+
+    /** @brief [in_start, in_end) of the input buffer is yet to be read. */
+    inline char *in_buffer();
+    inline size_t in_start() const;
+    inline void set_in_start(size_t start);
+    inline size_t in_end() const;
+    inline void set_in_end(size_t end);
+
+    /** @brief [0, out_end) of the output buffer is yet to be written. */
+    inline char *out_buffer();
+    inline size_t out_end() const;
+    inline void set_out_end(size_t end);
+
+    virtual void Write_V(FILE *stream) const;
+    virtual intptr_t Hash_V() const;
+
+protected:
+    inline RawPort(int fd, Kind kind);
+
+    // Dummy
+    virtual void UpdateInteriorPointers(Heap &heap) { }
+
+private:
+    int fd_;
+    Kind kind_;
+    bool eof_;
+    size_t in_start_;
+    size_t in_end_;
+    size_t out_end_;
+    char buffers_[0];
+};
+
 }  // namespace sanya
 
 // vim: set ts=4 sw=4 sts=4:
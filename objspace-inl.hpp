@@ -4,14 +4,13 @@
 namespace sanya {
 
 ObjSpace& ObjSpace::Get() {
-    if (!inst_s) {
-        inst_s = new ObjSpace();
-    }
-    return *inst_s;
+    return Isolate::Current()->obj_space();
 }
 
 ObjSpace::ObjSpace()
-    : symbol_table_(RawDict::Wrap()) { }
+    : symbol_table_(RawDict::Wrap()),
+      global_table_(RawDict::Wrap()),
+      global_version_(0) { }
 
 RawSymbol *ObjSpace::InternSymbol(const Handle &symbol) {
     RawPair *rp = symbol_table_.AsDict().LookupSymbol(symbol,
@@ -23,10 +22,50 @@ RawSymbol *ObjSpace::InternSymbol(const Handle &symbol) {
 }
 
 RawSymbol *ObjSpace::InternSymbol(const char *s) {
-    Handle symbol = RawSymbol::Wrap(s);
+    return InternSymbol(s, strlen(s));
+}
+
+RawSymbol *ObjSpace::InternSymbol(const char *s, size_t len) {
+    RawPair *entry = symbol_table_.AsDict().FindSymbol(s, len);
+    if (entry) {
+        return (RawSymbol *)entry->car();
+    }
+    Handle symbol = RawSymbol::Wrap(s, len);
     return InternSymbol(symbol);
 }
 
+RawPair *ObjSpace::LookupGlobal(const Handle &symbol) {
+    RawPair *rp = global_table_.AsDict().LookupSymbol(symbol,
+            RawDict::kLookupDefault);
+    if (!rp) {
+        rp = global_table_.AsDict().LookupSymbol(symbol,
+                RawDict::kCreateOnAbsent);
+        rp->set_cdr(RawTag::Wrap(RawTag::kUnbound));
+    }
+    return rp;
+}
+
+void ObjSpace::SetGlobal(RawPair *entry, RawObject *value) {
+    if (entry->cdr()->IsNative()) {
+        ++global_version_;
+    }
+    entry->set_cdr(value);
+}
+
+void ObjSpace::UndefineGlobal(const Handle &symbol) {
+    RawPair *rp = global_table_.AsDict().LookupSymbol(symbol,
+            RawDict::kDeleteOnFound);
+    if (rp) {
+        // A new entry will be created if it's defined again.
+        rp->set_cdr(RawTag::Wrap(RawTag::kUnbound));
+        ++global_version_;
+    }
+}
+
+intptr_t ObjSpace::global_version() const {
+    return global_version_;
+}
+
 }  // namespace sanya
 
 // vim: set ts=4 sw=4 sts=4:
@@ -1,8 +0,0 @@
-#include "objspace.hpp"
-#include "inlines.hpp"
-
-namespace sanya {
-
-ObjSpace* ObjSpace::inst_s = NULL;
-
-}
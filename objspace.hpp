@@ -10,17 +10,46 @@
 namespace sanya {
 
 class ObjSpace {
+    friend class Isolate;
+    friend class Snapshot;
 public:
+    /** @brief Get the object space of the current isolate. */
     inline static ObjSpace& Get();
 
     inline RawSymbol *InternSymbol(const Handle &symbol);
     inline RawSymbol *InternSymbol(const char *s);
 
-protected:
-    static ObjSpace *inst_s;
+    /** @brief Only allocates if the symbol is new. */
+    inline RawSymbol *InternSymbol(const char *s, size_t len);
+
+    /**
+     * @brief Find the (symbol . value) entry of a global variable,
+     * creating an unbound one if absent.
+     */
+    inline RawPair *LookupGlobal(const Handle &symbol);
+
+    /**
+     * @brief Set the value of a global variable, whose entry is from
+     * LookupGlobal.
+     */
+    inline void SetGlobal(RawPair *entry, RawObject *value);
 
+    /** @brief Remove a global variable, making it unbound. */
+    inline void UndefineGlobal(const Handle &symbol);
+
+    /**
+     * @brief Changes whenever a global variable is removed, so that its
+     * cached entry is no longer valid, and whenever one that is bound to
+     * a native is redefined or assigned, which compiled code may have
+     * assumed never happens.
+     */
+    inline intptr_t global_version() const;
+
+protected:
     inline ObjSpace();
     Handle symbol_table_;
+    Handle global_table_;
+    intptr_t global_version_;
 };
 
 }  // namespace sanya
@@ -0,0 +1,263 @@
+#include <algorithm>
+#include "oldspace.hpp"
+#include "inlines.hpp"
+
+namespace sanya {
+
+// Shades every pointer it's given.
+class OldSpace::Marker : public Relocation {
+public:
+    explicit Marker(OldSpace *space)
+        : space_(space) { }
+
+    virtual RawObject *Relocate(RawObject *ro) {
+        space_->Shade(ro);
+        return ro;
+    }
+
+private:
+    OldSpace *space_;
+};
+
+// A free chunk, whose self_ is NULL as no object's is, so that the sweeper
+// walks over it as over the objects.
+class OldSpace::FreeChunk : public RawHeapObject {
+public:
+    FreeChunk(size_t size, FreeChunk *next)
+        : next_(next) {
+        object_size_ = size;
+        self_ = NULL;
+    }
+
+    virtual void Write_V(FILE *stream) const {
+        fprintf(stream, "#<free>");
+    }
+
+    virtual intptr_t Hash_V() const {
+        FATAL_ERROR("mutable hash");
+    }
+
+    FreeChunk *next_;
+
+protected:
+    virtual void UpdateInteriorPointers(Heap &heap) { }
+};
+
+OldSpace::OldSpace(Heap &heap, size_t size)
+    : heap_(heap),
+      base_(new char[size]),
+      size_(size),
+      top_(base_),
+      usage_(0),
+      cycles_(0),
+      phase_(kIdle),
+      marker_(new Marker(this)),
+      non_empty_lists_(0),
+      sweep_cursor_(NULL),
+      sweep_end_(NULL),
+      run_start_(NULL) {
+    size_t words = (size / Heap::kAlignment + 63) / 64;
+    marks_.resize(words, 0);
+    remembered_bits_.resize(words, 0);
+    std::fill(free_lists_, free_lists_ + kFreeLists, (FreeChunk *)NULL);
+}
+
+OldSpace::~OldSpace() {
+    // Free chunks, and the dead objects that were swept, have no self_.
+    for (char *it = base_; it < top_; ) {
+        RawHeapObject *chunk = (RawHeapObject *)it;
+        if (chunk->self_) {
+            chunk->Finalize();
+        }
+        it += chunk->object_size_;
+    }
+    delete marker_;
+    delete[] base_;
+}
+
+bool OldSpace::TestBit(const std::vector<uintptr_t> &bits, size_t i) {
+    return (bits[i / 64] >> (i % 64)) & 1;
+}
+
+bool OldSpace::SetBit(std::vector<uintptr_t> *bits, size_t i) {
+    uintptr_t mask = (uintptr_t)1 << (i % 64);
+    uintptr_t &word = (*bits)[i / 64];
+    bool was_set = word & mask;
+    word |= mask;
+    return was_set;
+}
+
+void OldSpace::ClearBit(std::vector<uintptr_t> *bits, size_t i) {
+    (*bits)[i / 64] &= ~((uintptr_t)1 << (i % 64));
+}
+
+RawHeapObject *OldSpace::Alloc(size_t size) {
+    RawHeapObject *ro = AllocFromFreeLists(size);
+    if (!ro) {
+        if (size > (size_t)(base_ + size_ - top_)) {
+            return NULL;
+        }
+        ro = (RawHeapObject *)top_;
+        top_ += size;
+    }
+    usage_ += size;
+
+    // Promoted objects are alive at least until the end of the cycle.
+    if (phase_ == kMarking) {
+        SetBit(&marks_, Granule(ro));
+    }
+    return ro;
+}
+
+RawHeapObject *OldSpace::AllocFromFreeLists(size_t size) {
+    size_t first = std::min(size / Heap::kAlignment, kLastList);
+    uint32_t lists = non_empty_lists_ & ~(((uint32_t)1 << first) - 1);
+    while (lists) {
+        size_t i = __builtin_ctz(lists);
+        lists &= lists - 1;
+        FreeChunk **link = &free_lists_[i];
+        while (*link) {
+            FreeChunk *chunk = *link;
+            size_t rest = chunk->object_size_ - size;
+
+            // Leaves no remainder that is too small to be a chunk.
+            if (rest == 0 || rest >= kMinChunk) {
+                *link = chunk->next_;
+                if (!free_lists_[i]) {
+                    non_empty_lists_ &= ~((uint32_t)1 << i);
+                }
+                if (rest) {
+                    AddFreeChunk((char *)chunk + size, rest);
+                }
+                return chunk;
+            }
+            if (i != kLastList) {
+                // They are all of the same size.
+                break;
+            }
+            link = &chunk->next_;
+        }
+    }
+    return NULL;
+}
+
+void OldSpace::AddFreeChunk(char *start, size_t size) {
+    size_t i = std::min(size / Heap::kAlignment, kLastList);
+    free_lists_[i] = ::new (start) FreeChunk(size, free_lists_[i]);
+    non_empty_lists_ |= (uint32_t)1 << i;
+}
+
+void OldSpace::ClearFreeLists() {
+    std::fill(free_lists_, free_lists_ + kFreeLists, (FreeChunk *)NULL);
+    non_empty_lists_ = 0;
+}
+
+void OldSpace::Remember(RawObject *ro) {
+    if (!SetBit(&remembered_bits_, Granule(ro))) {
+        remembered_.push_back(ro);
+    }
+}
+
+void OldSpace::TakeRemembered(std::vector<RawObject *> *remembered) {
+    remembered->swap(remembered_);
+    remembered_.clear();
+    for (size_t i = 0; i < remembered->size(); ++i) {
+        ClearBit(&remembered_bits_, Granule((*remembered)[i]));
+    }
+}
+
+void OldSpace::StartMarking() {
+    std::fill(marks_.begin(), marks_.end(), 0);
+    phase_ = kMarking;
+    ++cycles_;
+}
+
+void OldSpace::Shade(RawObject *ro) {
+    if (ro && ro->heap_allocated() && Contains(ro) &&
+            !SetBit(&marks_, Granule(ro))) {
+        grey_.push_back(ro);
+    }
+}
+
+void OldSpace::ShadeFields(RawObject *ro) {
+    heap_.RelocateInteriorPointers(ro, marker_);
+}
+
+void OldSpace::Mark(size_t budget) {
+    size_t traced = 0;
+    while (!grey_.empty() && traced < budget) {
+        RawObject *ro = grey_.back();
+        grey_.pop_back();
+        ShadeFields(ro);
+        traced += ro->object_size_;
+    }
+    if (grey_.empty()) {
+        StartSweeping();
+    }
+}
+
+void OldSpace::StartSweeping() {
+    // The dead objects are about to be freed.
+    size_t kept = 0;
+    for (size_t i = 0; i < remembered_.size(); ++i) {
+        RawObject *ro = remembered_[i];
+        if (TestBit(marks_, Granule(ro))) {
+            remembered_[kept++] = ro;
+        }
+        else {
+            ClearBit(&remembered_bits_, Granule(ro));
+        }
+    }
+    remembered_.resize(kept);
+
+    // Free chunks are found again, and until then promotion allocates
+    // past what is swept.
+    ClearFreeLists();
+    sweep_cursor_ = base_;
+    sweep_end_ = top_;
+    run_start_ = NULL;
+    phase_ = kSweeping;
+}
+
+void OldSpace::Sweep(size_t budget) {
+    size_t swept = 0;
+    while (sweep_cursor_ < sweep_end_ && swept < budget) {
+        RawHeapObject *chunk = (RawHeapObject *)sweep_cursor_;
+        size_t size = chunk->object_size_;
+        if (chunk->self_ && TestBit(marks_, Granule(chunk))) {
+            if (run_start_) {
+                AddFreeChunk(run_start_, sweep_cursor_ - run_start_);
+                run_start_ = NULL;
+            }
+        }
+        else {
+            if (chunk->self_) {
+                usage_ -= size;
+                chunk->Finalize();
+                chunk->self_ = NULL;
+            }
+            if (!run_start_) {
+                run_start_ = sweep_cursor_;
+            }
+        }
+        sweep_cursor_ += size;
+        swept += size;
+    }
+    if (sweep_cursor_ < sweep_end_) {
+        return;
+    }
+    if (run_start_) {
+        if (sweep_end_ == top_) {
+            top_ = run_start_;
+        }
+        else {
+            AddFreeChunk(run_start_, sweep_end_ - run_start_);
+        }
+        run_start_ = NULL;
+    }
+    phase_ = kIdle;
+}
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
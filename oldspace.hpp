@@ -0,0 +1,145 @@
+#ifndef OLDSPACE_HPP
+#define OLDSPACE_HPP
+/**
+ * @file oldspace.hpp
+ * @brief A mark-sweep space for the objects that survive the nursery.
+ */
+
+#include <vector>
+#include <stdint.h>
+#include "heap.hpp"
+
+namespace sanya {
+
+/**
+ * @class OldSpace
+ * @brief Where the heap (see Heap::EnableOldSpace) promotes the objects
+ * that survived a collection of the nursery, so that they are no longer
+ * copied at every collection. Objects here are never moved.
+ *
+ * Marking and sweeping are done in slices at the end of the collections
+ * of the nursery, a cycle at a time:
+ *
+ * - It starts once half of the space is in use, by shading the roots and
+ *   what the nursery points to. That's a snapshot of the objects that are
+ *   alive at the beginning, which are all marked by the end.
+ * - While marking, the write barrier (see Heap::WriteBarrier) shades the
+ *   pointers that are overwritten in old objects, and promoted objects
+ *   are marked as they are allocated.
+ * - Once there is nothing left to trace, the unmarked objects are swept
+ *   into the free lists, which promotion allocates from.
+ *
+ * The space also keeps the remembered set, the old objects that may point
+ * into the nursery, which are scanned at every collection of the nursery
+ * as well as the roots.
+ */
+class OldSpace {
+public:
+    enum Phase {
+        kIdle,
+        kMarking,
+        kSweeping
+    };
+
+    OldSpace(Heap &heap, size_t size);
+    ~OldSpace();
+
+    /** @brief Whether ro, which is heap-allocated, is in this space. */
+    bool Contains(RawObject *ro) const {
+        return (uintptr_t)ro - (uintptr_t)base_ < size_;
+    }
+
+    Phase phase() const { return phase_; }
+
+    /** @brief Bytes in use, including those not swept yet. */
+    size_t usage() const { return usage_; }
+
+    /** @brief How many marking cycles have started. */
+    size_t cycles() const { return cycles_; }
+
+    /** @brief Whether usage is high enough to start a cycle. */
+    bool ShouldStart() const { return usage_ > size_ / 2; }
+
+    /**
+     * @brief Room for an object of size bytes, which is a multiple of
+     * Heap::kAlignment, or NULL if there isn't any. It's marked if a
+     * cycle is marking.
+     */
+    RawHeapObject *Alloc(size_t size);
+
+    /** @brief ro may point into the nursery. */
+    void Remember(RawObject *ro);
+
+    /** @brief Moves the remembered set into remembered. */
+    void TakeRemembered(std::vector<RawObject *> *remembered);
+
+    /** @brief Clears the marks, the roots are shaded next. */
+    void StartMarking();
+
+    /** @brief Marks ro if it's an unmarked object of this space. */
+    void Shade(RawObject *ro);
+
+    /** @brief Shades what ro points to. */
+    void ShadeFields(RawObject *ro);
+
+    /**
+     * @brief Traces about budget bytes of the shaded objects, and starts
+     * sweeping if none are left.
+     */
+    void Mark(size_t budget);
+
+    /** @brief Sweeps about budget bytes, and is idle once it's done. */
+    void Sweep(size_t budget);
+
+private:
+    class Marker;
+    class FreeChunk;
+
+    // Free chunks of 2 to kLastList - 1 granules of Heap::kAlignment
+    // bytes have their own lists, the larger ones share the last one.
+    static const size_t kFreeLists = 32;
+    static const size_t kLastList = kFreeLists - 1;
+    static const size_t kMinChunk = 2 * Heap::kAlignment;
+
+    size_t Granule(RawObject *ro) const {
+        return ((char *)ro - base_) / Heap::kAlignment;
+    }
+    static bool TestBit(const std::vector<uintptr_t> &bits, size_t i);
+    static bool SetBit(std::vector<uintptr_t> *bits, size_t i);
+    static void ClearBit(std::vector<uintptr_t> *bits, size_t i);
+
+    RawHeapObject *AllocFromFreeLists(size_t size);
+    void AddFreeChunk(char *start, size_t size);
+    void ClearFreeLists();
+    void StartSweeping();
+
+    Heap &heap_;
+    char *base_;
+    size_t size_;
+    char *top_;         // Where the bump allocation is
+    size_t usage_;
+    size_t cycles_;
+    Phase phase_;
+
+    // Set for the marked objects and the remembered ones, by granule.
+    std::vector<uintptr_t> marks_;
+    std::vector<uintptr_t> remembered_bits_;
+    std::vector<RawObject *> remembered_;
+    std::vector<RawObject *> grey_;
+    Marker *marker_;
+
+    FreeChunk *free_lists_[kFreeLists];
+    uint32_t non_empty_lists_;
+
+    // The chunks up to sweep_end_ are swept from sweep_cursor_ on, and
+    // run_start_ is the start of the free ones right before it, if any.
+    char *sweep_cursor_;
+    char *sweep_end_;
+    char *run_start_;
+};
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
+
+#endif /* OLDSPACE_HPP */
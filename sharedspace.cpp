@@ -0,0 +1,61 @@
+#include <algorithm>
+#include <pthread.h>
+#include "sharedspace.hpp"
+#include "inlines.hpp"
+
+namespace sanya {
+
+namespace {
+
+// Isolates share strings from their own threads.
+pthread_mutex_t mutex_s = PTHREAD_MUTEX_INITIALIZER;
+
+char *chunk_s = NULL;
+size_t chunk_size_s = 0;
+size_t chunk_usage_s = 0;
+size_t usage_s = 0;
+
+}  // namespace
+
+RawString *SharedSpace::Share(const Handle &str) {
+    // Strings are either in the heap or in here.
+    if (!Heap::Get().Contains(str.raw())) {
+        return &str.AsString();
+    }
+
+    size_t length = str.AsString().length();
+    size_t size = (sizeof(RawString) + length + Heap::kAligner) &
+                  (~Heap::kAligner);
+    RawString *shared = (RawString *)::new (Alloc(size)) RawString(NULL,
+                                                                 length);
+    shared->object_size_ = size;
+    shared->self_ = (RawHeapObject *)shared;
+    str.AsString().CopyTo(shared->chars_);
+    return shared;
+}
+
+size_t SharedSpace::usage() {
+    pthread_mutex_lock(&mutex_s);
+    size_t usage = usage_s;
+    pthread_mutex_unlock(&mutex_s);
+    return usage;
+}
+
+void *SharedSpace::Alloc(size_t size) {
+    pthread_mutex_lock(&mutex_s);
+    if (!chunk_s || chunk_usage_s + size > chunk_size_s) {
+        // The rest of the last chunk is left unused.
+        chunk_size_s = std::max(size, kChunkSize);
+        chunk_s = new char[chunk_size_s];
+        chunk_usage_s = 0;
+    }
+    void *addr = chunk_s + chunk_usage_s;
+    chunk_usage_s += size;
+    usage_s += size;
+    pthread_mutex_unlock(&mutex_s);
+    return addr;
+}
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
@@ -0,0 +1,45 @@
+#ifndef SHAREDSPACE_HPP
+#define SHAREDSPACE_HPP
+/**
+ * @file sharedspace.hpp
+ * @brief Immutable objects that every isolate can use.
+ */
+
+#include "objectmodel.hpp"
+
+namespace sanya {
+
+/**
+ * @class SharedSpace
+ * @brief A process-wide region of flat strings that are never moved,
+ * mutated or freed.
+ *
+ * The heaps leave the objects there alone (see Heap::Contains), so any
+ * isolate may point to them, and channels (see channel.hpp) pass them
+ * between isolates without copying. Since they are never freed, share
+ * strings that are sent many times or to many isolates, such as the
+ * input of a fan-out, rather than every string that is sent.
+ */
+class SharedSpace {
+public:
+    // The size of the chunks that strings are allocated from.
+    static const size_t kChunkSize = 1 * Heap::MB;
+
+    /**
+     * @brief A flat copy of str in the shared space, or str if it's
+     * there already. Doesn't allocate on the heap.
+     */
+    static RawString *Share(const Handle &str);
+
+    /** @brief Bytes in use, for all isolates. */
+    static size_t usage();
+
+private:
+    static void *Alloc(size_t size);
+};
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
+
+#endif /* SHAREDSPACE_HPP */
@@ -0,0 +1,461 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "snapshot.hpp"
+#include "heap.hpp"
+#include "objectmodel.hpp"
+#include "objspace.hpp"
+#include "vm-image.hpp"
+#include "vm-prelude.hpp"
+#include "inlines.hpp"
+
+namespace sanya {
+
+namespace {
+
+const char kMagic[4] = { 'S', 'N', 'Y', 'H' };
+
+struct SnapshotHeader {
+    char magic[4];
+    uint32_t version;
+
+    // The executable that wrote it.
+    uint64_t executable_size;
+    int64_t executable_mtime_sec;
+    int64_t executable_mtime_nsec;
+
+    // Where things were, to move the pointers by the difference.
+    uint64_t anchor;            // Address of Snapshot::Save
+    uint64_t heap_base;
+
+    uint64_t heap_length;       // In bytes, followed by the code
+    uint64_t code_length;       // In words
+
+    // Offsets into the heap.
+    uint64_t symbol_table;
+    uint64_t global_table;
+    int64_t global_version;
+};
+
+bool GetExecutable(SnapshotHeader *header) {
+    struct stat exe_stat;
+    if (stat("/proc/self/exe", &exe_stat) != 0) {
+        return false;
+    }
+    header->executable_size = exe_stat.st_size;
+    header->executable_mtime_sec = exe_stat.st_mtim.tv_sec;
+    header->executable_mtime_nsec = exe_stat.st_mtim.tv_nsec;
+    return true;
+}
+
+uintptr_t Anchor() {
+    return (uintptr_t)&Snapshot::Save;
+}
+
+// Pointers into the heap that was saved, moved by delta. They have to
+// land on the start of an object, which types has the type of by granule
+// (zero elsewhere), and ok is cleared otherwise.
+class CheckedRelocation : public Relocation {
+public:
+    CheckedRelocation(char *base, const std::vector<uint8_t> &types,
+                      intptr_t delta)
+        : base_(base),
+          types_(types),
+          delta_(delta),
+          ok_(true) { }
+
+    virtual RawObject *Relocate(RawObject *ro) {
+        size_t offset = (char *)ro + delta_ - base_;
+        if (offset % Heap::kAlignment != 0 ||
+                offset / Heap::kAlignment >= types_.size() ||
+                !types_[offset / Heap::kAlignment]) {
+            ok_ = false;
+            return RawNil::Wrap();
+        }
+        return (RawObject *)(base_ + offset);
+    }
+
+    bool ok() const { return ok_; }
+
+private:
+    char *base_;
+    const std::vector<uint8_t> &types_;
+    intptr_t delta_;
+    bool ok_;
+};
+
+// Unlike RawObject::object_type, takes NULL.
+bool Is(RawObject *ro, RawObject::ObjectType type) {
+    return ro && ro->object_type() == type;
+}
+
+void AddVTable(uintptr_t vtables[], RawObject *ro) {
+    memcpy(&vtables[ro->object_type()], (void *)ro, sizeof(uintptr_t));
+}
+
+// The vtable of every type of object that may be restored, by type, taken
+// from objects that are dropped right away. Ports and continuations are
+// not among them, as they don't outlive the process.
+void GetVTables(uintptr_t vtables[]) {
+    std::fill(vtables, vtables + RawObject::kPortType + 1, 0);
+    Handle nil = RawNil::Wrap();
+    Handle vector = RawVector::Wrap(0, nil);
+    Handle proc = RawProcedure::Wrap(NULL, 0, false, vector, nil, 0, false,
+                                     1, 0);
+    AddVTable(vtables, RawSymbol::Wrap(""));
+    AddVTable(vtables, RawPair::Wrap(nil, nil));
+    AddVTable(vtables, vector.raw());
+    AddVTable(vtables, RawGrowableVector::Wrap());
+    AddVTable(vtables, RawDict::Wrap());
+    AddVTable(vtables, RawCell::Wrap(nil));
+    AddVTable(vtables, proc.raw());
+    AddVTable(vtables, RawClosure::Wrap(proc));
+    AddVTable(vtables, RawNative::Wrap(NULL, 0, ""));
+    AddVTable(vtables, RawFlonum::Wrap(0));
+    AddVTable(vtables, RawString::Wrap("", 0));
+}
+
+}  // namespace
+
+bool Snapshot::FitsInObject(RawObject *object) {
+    size_t size = object->object_size_;
+    switch (object->object_type_) {
+        case RawObject::kSymbolType: {
+            RawSymbol *symbol = (RawSymbol *)object;
+            return size > sizeof(RawSymbol) &&
+                symbol->length() < size - sizeof(RawSymbol) &&
+                symbol->Unwrap()[symbol->length()] == '\0';
+        }
+        case RawObject::kVectorType:
+            return size >= sizeof(RawVector) &&
+                ((RawVector *)object)->length() <=
+                    (size - sizeof(RawVector)) / sizeof(RawObject *);
+        case RawObject::kStringType: {
+            RawString *str = (RawString *)object;
+            if (size < sizeof(RawString)) {
+                return false;
+            }
+            if (str->kind_ == RawString::kFlat) {
+                return str->length_ <= size - sizeof(RawString);
+            }
+            return str->kind_ == RawString::kSlice ||
+                str->kind_ == RawString::kRope;
+        }
+        case RawObject::kPairType:
+            return size >= sizeof(RawPair);
+        case RawObject::kGrowableVectorType:
+            return size >= sizeof(RawGrowableVector);
+        case RawObject::kDictType:
+            return size >= sizeof(RawDict);
+        case RawObject::kCellType:
+            return size >= sizeof(RawCell);
+        case RawObject::kProcedureType:
+            return size >= sizeof(RawProcedure);
+        case RawObject::kClosureType:
+            return size >= sizeof(RawClosure);
+        case RawObject::kNativeType:
+            return size >= sizeof(RawNative);
+        case RawObject::kFlonumType:
+            return size >= sizeof(RawFlonum);
+        default:
+            return false;
+    }
+}
+
+bool Snapshot::HasValidFields(RawObject *object, size_t max_length) {
+    switch (object->object_type_) {
+        case RawObject::kStringType: {
+            RawString *str = (RawString *)object;
+            RawString *left = str->left_;
+            RawString *right = str->right_;
+            if (str->kind_ == RawString::kSlice) {
+                return Is(left, RawObject::kStringType) &&
+                    left->kind_ == RawString::kFlat &&
+                    str->offset_ <= left->length_ &&
+                    str->length_ <= left->length_ - str->offset_;
+            }
+            // Deeper than its halves, so that it has no cycles.
+            return str->kind_ != RawString::kRope ||
+                (Is(left, RawObject::kStringType) &&
+                 Is(right, RawObject::kStringType) &&
+                 str->depth_ > left->depth() &&
+                 str->depth_ > right->depth() &&
+                 str->length_ == left->length_ + right->length_);
+        }
+        case RawObject::kGrowableVectorType: {
+            RawGrowableVector *vector = (RawGrowableVector *)object;
+            return Is(vector->data_, RawObject::kVectorType) &&
+                vector->usage_ <= vector->data_->length();
+        }
+        case RawObject::kDictType: {
+            RawDict *dict = (RawDict *)object;
+            if (!Is(dict->vec_, RawObject::kVectorType) ||
+                    dict->size_ == 0 ||
+                    dict->size_ != dict->vec_->length()) {
+                return false;
+            }
+
+            // Each bucket is a list of (symbol . value) entries.
+            size_t length = 0;
+            for (size_t i = 0; i < dict->size_; ++i) {
+                RawObject *it = dict->vec_->At(i);
+                while (Is(it, RawObject::kPairType)) {
+                    RawObject *entry = ((RawPair *)it)->car();
+                    if (++length > max_length ||
+                            !Is(entry, RawObject::kPairType) ||
+                            !Is(((RawPair *)entry)->car(),
+                                RawObject::kSymbolType)) {
+                        return false;
+                    }
+                    it = ((RawPair *)it)->cdr();
+                }
+                if (!it || !it->IsNil()) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case RawObject::kProcedureType:
+            return Is(((RawProcedure *)object)->consts_,
+                      RawObject::kVectorType);
+        case RawObject::kNativeType: {
+            RawNative *native = (RawNative *)object;
+            return vm_prelude::IsBuiltin(native->fn_, native->arity_,
+                                         native->name_);
+        }
+        default:
+            return true;
+    }
+}
+
+bool Snapshot::Save(const char *path) {
+    Heap &heap = Heap::Get();
+    ObjSpace &space = ObjSpace::Get();
+
+    // Only the from space is saved.
+    if (heap.old_space()) {
+        return false;
+    }
+
+    // Leaves the live objects at the start of the from space.
+    heap.TriggerCollection();
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    if (!GetExecutable(&header)) {
+        return false;
+    }
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.anchor = Anchor();
+    header.heap_base = (uintptr_t)heap.from_space_;
+    header.heap_length = heap.usage_;
+    header.symbol_table = (char *)space.symbol_table_.raw() -
+        heap.from_space_;
+    header.global_table = (char *)space.global_table_.raw() -
+        heap.from_space_;
+    header.global_version = space.global_version_;
+
+    // Procedures are written with the offset of their code instead, and
+    // without their machine code.
+    std::vector<char> image(heap.from_space_,
+                            heap.from_space_ + heap.usage_);
+    std::vector<uint32_t> code;
+    for (size_t offset = 0; offset < image.size(); ) {
+        RawObject *object = (RawObject *)&image[offset];
+        if (object->object_type_ == RawObject::kProcedureType) {
+            RawProcedure *proc = (RawProcedure *)object;
+            size_t start = code.size();
+            code.insert(code.end(), proc->code_,
+                        proc->code_ + proc->code_length_);
+            proc->code_ = (uint32_t *)start;
+            proc->owns_code_ = false;
+            proc->hotness_ = 0;
+            proc->jit_code_ = NULL;
+        }
+        offset += object->object_size_;
+    }
+    header.code_length = code.size();
+
+    // Written aside and renamed, so that a reader never sees half of it.
+    std::string tmp_path = std::string(path) + ".tmp";
+    FILE *fp = fopen(tmp_path.c_str(), "wb");
+    if (!fp) {
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+    if (ok && !image.empty()) {
+        ok = fwrite(&image[0], 1, image.size(), fp) == image.size();
+    }
+    if (ok && !code.empty()) {
+        ok = fwrite(&code[0], sizeof(uint32_t), code.size(), fp) ==
+            code.size();
+    }
+    ok = fclose(fp) == 0 && ok;
+    if (!ok || rename(tmp_path.c_str(), path) != 0) {
+        remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool Snapshot::Restore(const char *path) {
+    Heap &heap = Heap::Get();
+    if (heap.usage_ != 0 || Isolate::Current()->obj_space_) {
+        return false;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 ||
+            file_stat.st_size < (off_t)sizeof(SnapshotHeader)) {
+        close(fd);
+        return false;
+    }
+    size_t size = file_stat.st_size;
+    void *addr = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+
+    const char *data = (const char *)addr;
+    const SnapshotHeader &header = *(const SnapshotHeader *)data;
+    SnapshotHeader current;
+    if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+            header.version != kVersion ||
+            !GetExecutable(&current) ||
+            header.executable_size != current.executable_size ||
+            header.executable_mtime_sec != current.executable_mtime_sec ||
+            header.executable_mtime_nsec != current.executable_mtime_nsec ||
+            header.heap_length > heap.size_ ||
+            header.heap_length % Heap::kAlignment != 0 ||
+            sizeof(header) + header.heap_length +
+                header.code_length * sizeof(uint32_t) > size ||
+            header.symbol_table >= header.heap_length ||
+            header.global_table >= header.heap_length) {
+        munmap(addr, size);
+        return false;
+    }
+
+    // Taken while the heap is still empty.
+    uintptr_t vtables[RawObject::kPortType + 1];
+    GetVTables(vtables);
+    std::fill(heap.from_space_, heap.from_space_ + heap.usage_, 0);
+    heap.usage_ = 0;
+
+    memcpy(heap.from_space_, data + sizeof(header), header.heap_length);
+    heap.usage_ = header.heap_length;
+
+    // The code stays in the mapping, which is never unmapped.
+    uint32_t *code = (uint32_t *)(data + sizeof(header) +
+                                  header.heap_length);
+    intptr_t heap_delta = heap.from_space_ - (char *)header.heap_base;
+    intptr_t exe_delta = Anchor() - header.anchor;
+
+    // Nothing that was read is trusted. The objects are laid out and
+    // typed first, so that their pointers can be checked as they are
+    // relocated, and then their fields and code are checked.
+    std::vector<uint8_t> types(heap.usage_ / Heap::kAlignment, 0);
+    bool ok = true;
+    for (size_t offset = 0; ok && offset < heap.usage_; ) {
+        RawObject *object = (RawObject *)(heap.from_space_ + offset);
+        size_t object_size = object->object_size_;
+        unsigned type = object->object_type_;
+
+        // The vtable lives in the executable.
+        uintptr_t vptr;
+        memcpy(&vptr, object, sizeof(vptr));
+        vptr += exe_delta;
+
+        ok = object_size != 0 && object_size % Heap::kAlignment == 0 &&
+            object_size <= heap.usage_ - offset &&
+            type <= RawObject::kPortType && vtables[type] != 0 &&
+            vptr == vtables[type] && FitsInObject(object);
+        if (ok) {
+            memcpy((void *)object, &vptr, sizeof(vptr));
+            object->self_ = (RawHeapObject *)object;
+            types[offset / Heap::kAlignment] = type;
+            offset += object_size;
+        }
+    }
+
+    CheckedRelocation relocation(heap.from_space_, types, heap_delta);
+    for (size_t offset = 0; ok && offset < heap.usage_; ) {
+        RawObject *object = (RawObject *)(heap.from_space_ + offset);
+        size_t object_size = object->object_size_;
+
+        // Its free variables are counted by its procedure.
+        if (object->object_type_ == RawObject::kClosureType) {
+            RawProcedure *proc = (RawProcedure *)relocation.Relocate(
+                    ((RawClosure *)object)->proc());
+            ok = relocation.ok() &&
+                proc->object_type_ == RawObject::kProcedureType &&
+                proc->num_free_ >= 0 &&
+                (size_t)proc->num_free_ <= (object_size -
+                    sizeof(RawClosure)) / sizeof(RawObject *);
+        }
+        if (ok) {
+            heap.RelocateInteriorPointers(object, &relocation);
+            ok = relocation.ok();
+        }
+
+        if (ok && object->object_type_ == RawObject::kProcedureType) {
+            RawProcedure *proc = (RawProcedure *)object;
+            uintptr_t start = (uintptr_t)proc->code_;
+            ok = start <= header.code_length &&
+                proc->code_length_ <= header.code_length - start;
+            proc->code_ = code + start;
+            proc->owns_code_ = false;
+            proc->jit_code_ = NULL;
+        }
+        else if (ok && object->object_type_ == RawObject::kNativeType) {
+            RawNative *native = (RawNative *)object;
+            native->fn_ = (RawNative::Function)(
+                    (uintptr_t)native->fn_ + exe_delta);
+            native->name_ += exe_delta;
+        }
+        offset += object_size;
+    }
+
+    for (size_t offset = 0; ok && offset < heap.usage_; ) {
+        RawObject *object = (RawObject *)(heap.from_space_ + offset);
+        ok = HasValidFields(object, types.size()) &&
+            (object->object_type_ != RawObject::kProcedureType ||
+             vm_image::IsValidCode((RawProcedure *)object));
+        offset += object->object_size_;
+    }
+
+    if (!ok || header.symbol_table % Heap::kAlignment != 0 ||
+            header.global_table % Heap::kAlignment != 0 ||
+            types[header.symbol_table / Heap::kAlignment] !=
+                RawObject::kDictType ||
+            types[header.global_table / Heap::kAlignment] !=
+                RawObject::kDictType) {
+        heap.usage_ = 0;
+        munmap(addr, size);
+        return false;
+    }
+
+    // Allocates two empty tables that are dropped right away.
+    ObjSpace &space = ObjSpace::Get();
+    space.symbol_table_ = (RawObject *)(heap.from_space_ +
+                                        header.symbol_table);
+    space.global_table_ = (RawObject *)(heap.from_space_ +
+                                        header.global_table);
+    space.global_version_ = header.global_version;
+    return true;
+}
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
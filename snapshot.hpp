@@ -0,0 +1,62 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+/**
+ * @file snapshot.hpp
+ * @brief Saves the heap after initialization and restores it at startup.
+ */
+
+namespace sanya {
+
+class RawObject;
+
+/**
+ * @class Snapshot
+ * @brief A copy of the live objects in the heap together with the symbol
+ * table and the global variables.
+ *
+ * The objects are written as they are in the semispace after a
+ * collection, followed by the code of the procedures among them. Pointers
+ * are written as is, along with where the heap and the executable were
+ * at that time, and are fixed up in one pass over the objects when the
+ * snapshot is restored. The executable has to be the same one, the
+ * snapshot is rejected otherwise. So is one whose objects don't check
+ * out: their types and vtables, their pointers, which have to land on
+ * other objects, the code of the procedures (see vm_image::IsValidCode)
+ * and the natives.
+ */
+class Snapshot {
+public:
+    static const unsigned kVersion = 1;
+
+    /**
+     * @brief Collect and write the heap of the current isolate into
+     * path. Returns false on IO errors, or if the heap has an old space.
+     * Everything that is still referenced by a handle is written, but
+     * only the symbol table and the globals are restored, so save it
+     * when little else is alive.
+     */
+    static bool Save(const char *path);
+
+    /**
+     * @brief Restore the heap of the current isolate from path. Returns
+     * false if it can't be read or is not valid. Has to be done before
+     * anything is allocated, in place of the initialization that was
+     * saved.
+     */
+    static bool Restore(const char *path);
+
+private:
+    // Whether what the fields of object say is inline, such as the items
+    // of a vector, fits in its size. Its pointers are not relocated yet.
+    static bool FitsInObject(RawObject *object);
+
+    // Whether the fields of object, whose pointers are relocated, are
+    // what its type expects. Lists longer than max_length are rejected.
+    static bool HasValidFields(RawObject *object, size_t max_length);
+};
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
+
+#endif /* SNAPSHOT_HPP */
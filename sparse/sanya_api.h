@@ -2,23 +2,18 @@
 #define SANYA_API_H
 
 #include <cstdlib>
+#include <string>
 #include "sanya.hpp"
 #include "objectmodel.hpp"
 #include "handle.hpp"
 #include "objspace.hpp"
-#include "handlezone.hpp"
 #include "inlines.hpp"
+#include "scm_number.hpp"
 
 using namespace sanya;
 
-extern HandleZone *parser_zone;
-
 extern "C" {
 
-inline Handle *alloc_handle(RawObject *ro) {
-    return &parser_zone->Alloc(ro);
-}
-
 inline RawObject *make_nil() {
     return RawNil::Wrap();
 }
@@ -35,16 +30,35 @@ inline RawObject *make_pair(RawObject *car, RawObject *cdr) {
     return RawPair::Wrap(car, cdr);
 }
 
-inline RawObject *make_fixnum(const char *s) {
-    return RawFixnum::Wrap(strtol(s, NULL, 10));
+// Numbers are read in place, s needs not end with a NUL.
+inline RawObject *make_flonum(const char *s, size_t length) {
+    return RawFlonum::Wrap(ParseDecimal(s, length));
 }
 
-inline RawObject *make_flonum(const char *s) {
-    FATAL_ERROR("no flonum support yet");
+inline RawObject *make_fixnum(const char *s, size_t length) {
+    intptr_t value;
+    if (!ParseInteger(s, length, &value) || !RawFixnum::CanWrap(value)) {
+        // There are no bignums.
+        return make_flonum(s, length);
+    }
+    return RawFixnum::Wrap(value);
 }
 
-inline RawObject *make_string(const char *s, int length) {
-    FATAL_ERROR("no string support yet");
+inline RawObject *make_string(const char *s, size_t length) {
+    std::string text;
+    text.reserve(length);
+    for (const char *end = s + length; s != end; ++s) {
+        if (*s != '\\' || s + 1 == end) {
+            text.push_back(*s);
+            continue;
+        }
+        switch (*++s) {
+            case 'n':   text.push_back('\n'); break;
+            case 't':   text.push_back('\t'); break;
+            default:    text.push_back(*s); break;
+        }
+    }
+    return RawString::Wrap(text.data(), text.size());
 }
 
 inline RawObject *make_symbol(const char *s) {
@@ -56,7 +70,9 @@ inline RawObject *make_vector(RawObject *list) {
 }
 
 inline RawObject *make_quoted(RawObject *content) {
-    FATAL_ERROR("not supported yet");
+    Handle quoted = make_pair(content, make_nil());
+    Handle quote = make_symbol("quote");
+    return make_pair(quote.raw(), quoted.raw());
 }
 
 inline RawObject *make_quasiquoted(RawObject *content) {
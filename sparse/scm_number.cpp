@@ -0,0 +1,148 @@
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "scm_number.hpp"
+
+namespace sanya {
+
+namespace {
+
+// Doubles have 53 bits of mantissa, and 10^22 is the largest power of
+// ten that is exact.
+const uint64_t kMaxExactMantissa = (uint64_t)1 << 53;
+const int kMaxExactPower = 22;
+const double kPowersOfTen[kMaxExactPower + 1] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+    1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+    1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// More digits than that may not fit in a uint64_t.
+const int kMaxMantissaDigits = 19;
+
+bool IsDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+
+// The value of eight digits, by combining neighbouring bytes, then pairs
+// of them, then the two halves.
+uint64_t EightDigits(const char *s) {
+    uint64_t chunk;
+    memcpy(&chunk, s, sizeof(chunk));
+    chunk -= 0x3030303030303030ULL;
+    chunk = (chunk * 10 + (chunk >> 8)) & 0x00FF00FF00FF00FFULL;
+    chunk = (chunk * 100 + (chunk >> 16)) & 0x0000FFFF0000FFFFULL;
+    return (chunk * 10000 + (chunk >> 32)) & 0xFFFFFFFFULL;
+}
+
+#else
+
+uint64_t EightDigits(const char *s) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value = value * 10 + (s[i] - '0');
+    }
+    return value;
+}
+
+#endif
+
+}  // namespace
+
+bool ParseInteger(const char *s, size_t length, intptr_t *value) {
+    const char *end = s + length;
+    bool negative = s != end && *s == '-';
+    s += negative;
+
+    uint64_t magnitude = 0;
+    for (; end - s >= 8; s += 8) {
+        if (__builtin_mul_overflow(magnitude, 100000000, &magnitude) ||
+                __builtin_add_overflow(magnitude, EightDigits(s),
+                                       &magnitude)) {
+            return false;
+        }
+    }
+    for (; s != end; ++s) {
+        if (__builtin_mul_overflow(magnitude, 10, &magnitude) ||
+                __builtin_add_overflow(magnitude, *s - '0', &magnitude)) {
+            return false;
+        }
+    }
+
+    uint64_t limit = negative ? (uint64_t)INTPTR_MAX + 1 : INTPTR_MAX;
+    if (magnitude > limit) {
+        return false;
+    }
+    *value = negative ? (intptr_t)(0 - magnitude) : (intptr_t)magnitude;
+    return true;
+}
+
+double ParseDecimal(const char *s, size_t length) {
+    const char *p = s;
+    const char *end = s + length;
+    bool negative = p != end && *p == '-';
+    p += negative;
+
+    // The value is mantissa * 10^exponent, as long as no digit is
+    // dropped.
+    uint64_t mantissa = 0;
+    int num_digits = 0;
+    int exponent = 0;
+    bool truncated = false;
+    for (bool in_fraction = false; p != end; ++p) {
+        if (*p == '.') {
+            in_fraction = true;
+            continue;
+        }
+        if (!IsDigit(*p)) {
+            break;
+        }
+        if (num_digits < kMaxMantissaDigits) {
+            mantissa = mantissa * 10 + (*p - '0');
+            num_digits += mantissa != 0;
+            exponent -= in_fraction;
+        }
+        else {
+            truncated |= *p != '0';
+            exponent += !in_fraction;
+        }
+    }
+    if (p != end) {
+        // [eE][+-]?[0-9]+, large ones are left to strtod.
+        ++p;
+        bool negative_exponent = p != end && *p == '-';
+        p += p != end && (*p == '-' || *p == '+');
+        int explicit_exponent = 0;
+        for (; p != end && explicit_exponent < 100000; ++p) {
+            explicit_exponent = explicit_exponent * 10 + (*p - '0');
+        }
+        exponent += negative_exponent ? -explicit_exponent
+                                      : explicit_exponent;
+    }
+
+    // Both the mantissa and the power of ten are exact, so one rounding
+    // gives the nearest double.
+    if (mantissa == 0 && !truncated) {
+        return negative ? -0.0 : 0.0;
+    }
+    if (!truncated && mantissa <= kMaxExactMantissa &&
+            exponent >= -kMaxExactPower && exponent <= kMaxExactPower) {
+        double value = (double)mantissa;
+        if (exponent < 0) {
+            value /= kPowersOfTen[-exponent];
+        }
+        else {
+            value *= kPowersOfTen[exponent];
+        }
+        return negative ? -value : value;
+    }
+
+    std::string text(s, length);
+    return strtod(text.c_str(), NULL);
+}
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
@@ -0,0 +1,24 @@
+#ifndef SCM_NUMBER_HPP
+#define SCM_NUMBER_HPP
+#include <cstddef>
+#include <stdint.h>
+
+namespace sanya {
+
+/**
+ * @brief Parse -?[0-9]+ without copying it. Returns false if the value
+ * doesn't fit in an intptr_t.
+ */
+bool ParseInteger(const char *s, size_t length, intptr_t *value);
+
+/**
+ * @brief Parse a number as the lexer accepts it, e.g. -1.5e10, into the
+ * nearest double.
+ */
+double ParseDecimal(const char *s, size_t length);
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
+
+#endif /* SCM_NUMBER_HPP */
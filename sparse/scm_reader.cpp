@@ -0,0 +1,836 @@
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "sanya_api.h"
+#include "parse_api.h"
+#include "scm_reader.hpp"
+
+namespace sanya {
+
+namespace {
+
+enum CharClass {
+    kWhitespace = 1,
+    kDelimiter = 2,         // Ends a symbol or a number
+    kSymbolInitial = 4,
+    kSymbolSubsequent = 8,
+    kDigit = 16
+};
+
+/**
+ * @class CharTable
+ * @brief The class bits of every byte, so that the scanner does one
+ * lookup per character.
+ */
+class CharTable {
+public:
+    CharTable() {
+        memset(classes_, 0, sizeof(classes_));
+        Set(" \t\n\r\f\v", kWhitespace | kDelimiter);
+        Set("()[]\";'`,", kDelimiter);
+        Set(".+-*^?!<=>_~/$%&:", kSymbolInitial | kSymbolSubsequent);
+        for (int c = 'a'; c <= 'z'; ++c) {
+            classes_[c] = classes_[c - 'a' + 'A'] =
+                kSymbolInitial | kSymbolSubsequent;
+        }
+        for (int c = '0'; c <= '9'; ++c) {
+            classes_[c] = kSymbolSubsequent | kDigit;
+        }
+    }
+
+    bool Is(char c, int char_class) const {
+        return classes_[(unsigned char)c] & char_class;
+    }
+
+private:
+    void Set(const char *chars, int char_class) {
+        for (; *chars; ++chars) {
+            classes_[(unsigned char)*chars] = char_class;
+        }
+    }
+
+    unsigned char classes_[256];
+};
+
+const CharTable kCharTable;
+
+const size_t kReadSize = 65536;
+
+}  // namespace
+
+SexprLexer::SexprLexer(const char *begin, const char *end, bool eof)
+    : pos_(begin),
+      end_(end),
+      eof_(eof),
+      need_input_(false),
+      error_(NULL) { }
+
+void SexprLexer::Rebase(const char *begin, const char *end, bool eof) {
+    pos_ = begin;
+    end_ = end;
+    eof_ = eof;
+}
+
+SexprLexer::Status SexprLexer::Next(SexprToken *token) {
+    need_input_ = false;
+    if (!SkipAtmosphere()) {
+        return kNeedInput;
+    }
+    if (pos_ == end_) {
+        return eof_ ? kEnd : kNeedInput;
+    }
+
+    const char *start = pos_;
+    token->text = start;
+    token->length = 1;
+    Status status = kToken;
+    char c = *pos_;
+    switch (c) {
+        case '(':
+        case '[':
+            token->kind = SexprToken::kOpen;
+            token->close = c == '(' ? ')' : ']';
+            ++pos_;
+            break;
+
+        case ')':
+        case ']':
+            token->kind = SexprToken::kClose;
+            token->close = c;
+            ++pos_;
+            break;
+
+        case '\'':
+            token->kind = SexprToken::kQuote;
+            ++pos_;
+            break;
+
+        case '`':
+            token->kind = SexprToken::kQuasiquote;
+            ++pos_;
+            break;
+
+        case ',':
+            if (pos_ + 1 == end_ && !eof_) {
+                return kNeedInput;
+            }
+            if (pos_ + 1 != end_ && pos_[1] == '@') {
+                token->kind = SexprToken::kSplicing;
+                token->length = 2;
+            }
+            else {
+                token->kind = SexprToken::kUnquote;
+            }
+            pos_ += token->length;
+            break;
+
+        case '"':
+            status = LexString(token);
+            break;
+
+        case '#':
+            status = LexSharp(token);
+            break;
+
+        case '.':
+            if (IsDelimiterAt(pos_ + 1)) {
+                if (need_input_) {
+                    return kNeedInput;
+                }
+                token->kind = SexprToken::kDot;
+                ++pos_;
+                break;
+            }
+            status = LexAtom(token);
+            break;
+
+        default:
+            status = LexAtom(token);
+            break;
+    }
+    if (status == kNeedInput) {
+        pos_ = start;
+    }
+    return status;
+}
+
+bool SexprLexer::LexAll(std::vector<SexprToken> *tokens) {
+    SexprToken token;
+    Status status;
+    while ((status = Next(&token)) == kToken) {
+        tokens->push_back(token);
+    }
+    return status == kEnd;
+}
+
+bool SexprLexer::SkipAtmosphere() {
+    while (pos_ != end_) {
+        if (kCharTable.Is(*pos_, kWhitespace)) {
+            ++pos_;
+        }
+        else if (*pos_ == ';') {
+            const char *newline =
+                (const char *)memchr(pos_, '\n', end_ - pos_);
+            if (!newline && !eof_) {
+                return false;
+            }
+            pos_ = newline ? newline + 1 : end_;
+        }
+        else {
+            break;
+        }
+    }
+    return true;
+}
+
+SexprLexer::Status SexprLexer::LexAtom(SexprToken *token) {
+    const char *start = pos_;
+    while (!IsDelimiterAt(pos_)) {
+        if (!kCharTable.Is(*pos_, kSymbolSubsequent)) {
+            return Error("unexpected character");
+        }
+        ++pos_;
+    }
+    if (need_input_) {
+        return kNeedInput;
+    }
+    token->length = pos_ - start;
+
+    // -?[0-9]+ or -?([0-9]+\.?[0-9]*|\.[0-9]+)([eE][+-]?[0-9]+)? with a
+    // point or an exponent.
+    const char *p = start;
+    if (*p == '-') {
+        ++p;
+    }
+    size_t num_digits = SkipDigits(&p);
+    if (p == pos_ && num_digits) {
+        token->kind = SexprToken::kFixnum;
+        return kToken;
+    }
+    bool is_flonum = false;
+    if (p != pos_ && *p == '.') {
+        ++p;
+        num_digits += SkipDigits(&p);
+        is_flonum = num_digits;
+    }
+    if (num_digits && p != pos_ && (*p == 'e' || *p == 'E')) {
+        ++p;
+        if (p != pos_ && (*p == '+' || *p == '-')) {
+            ++p;
+        }
+        is_flonum = SkipDigits(&p);
+    }
+    if (is_flonum && p == pos_) {
+        token->kind = SexprToken::kFlonum;
+        return kToken;
+    }
+    if (!kCharTable.Is(*start, kSymbolInitial)) {
+        return Error("bad number");
+    }
+    token->kind = SexprToken::kSymbol;
+    return kToken;
+}
+
+SexprLexer::Status SexprLexer::LexString(SexprToken *token) {
+    const char *start = ++pos_;
+    while (true) {
+        if (pos_ == end_ && !eof_) {
+            return kNeedInput;
+        }
+        if (pos_ == end_ || *pos_ == '\n' || *pos_ == '\r') {
+            return Error("unterminated string");
+        }
+        if (*pos_ == '"') {
+            break;
+        }
+        // Escaping seq is resolved in make_string.
+        if (*pos_ == '\\' && pos_ + 1 != end_ && pos_[1] != '\n') {
+            ++pos_;
+        }
+        else if (*pos_ == '\\' && pos_ + 1 == end_ && !eof_) {
+            return kNeedInput;
+        }
+        ++pos_;
+    }
+    token->kind = SexprToken::kString;
+    token->text = start;
+    token->length = pos_ - start;
+    ++pos_;
+    return kToken;
+}
+
+SexprLexer::Status SexprLexer::LexSharp(SexprToken *token) {
+    if (pos_ + 1 == end_ && !eof_) {
+        return kNeedInput;
+    }
+    if (pos_ + 1 != end_ && pos_[1] == '(') {
+        token->kind = SexprToken::kOpenVector;
+        token->close = ')';
+        token->length = 2;
+        pos_ += 2;
+        return kToken;
+    }
+    if (pos_ + 1 != end_ && (pos_[1] == 't' || pos_[1] == 'f') &&
+            IsDelimiterAt(pos_ + 2)) {
+        if (need_input_) {
+            return kNeedInput;
+        }
+        token->kind = pos_[1] == 't' ? SexprToken::kTrue
+                                     : SexprToken::kFalse;
+        token->length = 2;
+        pos_ += 2;
+        return kToken;
+    }
+    return Error("bad # syntax");
+}
+
+size_t SexprLexer::SkipDigits(const char **p) const {
+    const char *start = *p;
+    while (*p != pos_ && kCharTable.Is(**p, kDigit)) {
+        ++*p;
+    }
+    return *p - start;
+}
+
+bool SexprLexer::IsDelimiterAt(const char *p) {
+    if (p == end_) {
+        need_input_ = !eof_;
+        return true;
+    }
+    return kCharTable.Is(*p, kDelimiter);
+}
+
+SexprLexer::Status SexprLexer::Error(const char *why) {
+    error_ = why;
+    return kError;
+}
+
+SexprReader::SexprReader(int fd)
+    : fd_(fd),
+      eof_(false),
+      lines_(0),
+      begin_(NULL),
+      end_(NULL),
+      lexer_(NULL, NULL, false),
+      stack_(RawGrowableVector::Wrap()) {
+    frames_.push_back(Frame(kToplevel, '\0', 0));
+}
+
+SexprReader::SexprReader(const char *data, size_t length)
+    : fd_(-1),
+      eof_(true),
+      lines_(0),
+      begin_(data),
+      end_(data + length),
+      lexer_(data, data + length, true),
+      stack_(RawGrowableVector::Wrap()) {
+    frames_.push_back(Frame(kToplevel, '\0', 0));
+}
+
+SexprReader::Status SexprReader::Read(Handle *datum) {
+    SexprToken token;
+    while (true) {
+        switch (lexer_.Next(&token)) {
+            case SexprLexer::kToken: {
+                Step step = Build(token, datum);
+                if (step == kGotDatum) {
+                    return kDatum;
+                }
+                if (step == kFailed) {
+                    Reset();
+                    return kError;
+                }
+                break;
+            }
+
+            case SexprLexer::kEnd:
+                if (!Finish()) {
+                    Reset();
+                    return kError;
+                }
+                return kEnd;
+
+            case SexprLexer::kNeedInput:
+                if (!Fill()) {
+                    return kWouldBlock;
+                }
+                break;
+
+            case SexprLexer::kError:
+                Error(lexer_.pos(), lexer_.error());
+                Reset();
+                return kError;
+        }
+    }
+}
+
+SexprReader::Status SexprReader::ReadTokens(const SexprToken **tokens,
+                                            const SexprToken *end,
+                                            Handle *datum) {
+    while (*tokens != end) {
+        Step step = Build(*(*tokens)++, datum);
+        if (step == kGotDatum) {
+            return kDatum;
+        }
+        if (step == kFailed) {
+            return kError;
+        }
+    }
+    return kEnd;
+}
+
+bool SexprReader::Finish() {
+    if (frames_.size() != 1) {
+        Error(end_, "unexpected end of input");
+        return false;
+    }
+    return true;
+}
+
+void SexprReader::Error(const char *pos, const char *why) {
+    size_t line = lines_ + 1;
+    for (const char *p = begin_; p != pos; ++p) {
+        line += *p == '\n';
+    }
+    fprintf(stderr, "syntax error on line %zu: %s\n", line, why);
+}
+
+SexprReader::Step SexprReader::Build(const SexprToken &token,
+                                     Handle *datum) {
+    Handle value = NULL;
+    switch (token.kind) {
+        case SexprToken::kOpen:
+            Open(kList, token.close);
+            return kContinue;
+
+        case SexprToken::kOpenVector:
+            Open(kVector, token.close);
+            return kContinue;
+
+        case SexprToken::kClose:
+            return Close(token, datum);
+
+        case SexprToken::kDot:
+            return Dot(token);
+
+        case SexprToken::kQuote:
+            Open(kQuote, '\0');
+            return kContinue;
+
+        case SexprToken::kQuasiquote:
+            Open(kQuasiquote, '\0');
+            return kContinue;
+
+        case SexprToken::kUnquote:
+            Open(kUnquote, '\0');
+            return kContinue;
+
+        case SexprToken::kSplicing:
+            Open(kSplicing, '\0');
+            return kContinue;
+
+        case SexprToken::kFixnum:
+            value = make_fixnum(token.text, token.length);
+            break;
+
+        case SexprToken::kFlonum:
+            value = make_flonum(token.text, token.length);
+            break;
+
+        case SexprToken::kSymbol:
+            value = ObjSpace::Get().InternSymbol(token.text, token.length);
+            break;
+
+        case SexprToken::kString:
+            value = make_string(token.text, token.length);
+            break;
+
+        case SexprToken::kTrue:
+            value = make_true();
+            break;
+
+        case SexprToken::kFalse:
+            value = make_false();
+            break;
+    }
+    return Add(token, value, datum);
+}
+
+void SexprReader::Open(FrameKind kind, char close) {
+    size_t slot = stack_.AsGrowableVector().length();
+    if (kind == kList || kind == kVector) {
+        Handle head = RawPair::Wrap(RawNil::Wrap(), RawNil::Wrap());
+        stack_.AsGrowableVector().Append(head);
+        stack_.AsGrowableVector().Append(head);
+    }
+    frames_.push_back(Frame(kind, close, slot));
+}
+
+SexprReader::Step SexprReader::Close(const SexprToken &token,
+                                     Handle *datum) {
+    Frame frame = frames_.back();
+    if ((frame.kind != kList && frame.kind != kVector) ||
+            frame.close != token.close) {
+        Error(token.text, "unexpected closing parenthesis");
+        return kFailed;
+    }
+    if (frame.dot == kAfterDot) {
+        Error(token.text, "missing the tail after a dot");
+        return kFailed;
+    }
+    frames_.pop_back();
+
+    Handle value =
+        ((RawPair *)stack_.AsGrowableVector().At(frame.slot))->cdr();
+    stack_.AsGrowableVector().Pop();
+    stack_.AsGrowableVector().Pop();
+    if (frame.kind == kVector) {
+        value = make_vector(value.raw());
+    }
+    return Add(token, value, datum);
+}
+
+SexprReader::Step SexprReader::Dot(const SexprToken &token) {
+    Frame &frame = frames_.back();
+    if (frame.kind != kList || frame.empty || frame.dot != kNoDot) {
+        Error(token.text, "unexpected dot");
+        return kFailed;
+    }
+    frame.dot = kAfterDot;
+    return kContinue;
+}
+
+SexprReader::Step SexprReader::Add(const SexprToken &token,
+                                   const Handle &datum_value,
+                                   Handle *datum) {
+    Handle value = datum_value;
+    while (true) {
+        FrameKind kind = frames_.back().kind;
+        if (kind == kQuote) {
+            value = make_quoted(value.raw());
+        }
+        else if (kind == kQuasiquote) {
+            value = make_quasiquoted(value.raw());
+        }
+        else if (kind == kUnquote) {
+            value = make_unquoted(value.raw());
+        }
+        else if (kind == kSplicing) {
+            value = make_splicing(value.raw());
+        }
+        else {
+            break;
+        }
+        frames_.pop_back();
+    }
+
+    Frame &frame = frames_.back();
+    if (frame.kind == kToplevel) {
+        *datum = value;
+        return kGotDatum;
+    }
+    if (frame.dot == kAfterTail) {
+        Error(token.text, "more than one datum after a dot");
+        return kFailed;
+    }
+    if (frame.dot == kAfterDot) {
+        RawObject *last = stack_.AsGrowableVector().At(frame.slot + 1);
+        ((RawPair *)last)->set_cdr(value.raw());
+        frame.dot = kAfterTail;
+        return kContinue;
+    }
+
+    RawPair *pair = RawPair::Wrap(value, RawNil::Wrap());
+    RawObject *&last = stack_.AsGrowableVector().At(frame.slot + 1);
+    ((RawPair *)last)->set_cdr(pair);
+    last = pair;
+    frame.empty = false;
+    return kContinue;
+}
+
+bool SexprReader::Fill() {
+    // Drop what has been read, the current token moves to the front.
+    const char *pos = lexer_.pos();
+    size_t unread = end_ - pos;
+    for (const char *p = begin_; p != pos; ++p) {
+        lines_ += *p == '\n';
+    }
+    if (unread) {
+        memmove(&buffer_[0], pos, unread);
+    }
+    buffer_.resize(unread + kReadSize);
+
+    ssize_t got;
+    do {
+        got = read(fd_, &buffer_[unread], kReadSize);
+    } while (got < 0 && errno == EINTR);
+    bool would_block = got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+    if (got < 0 && !would_block) {
+        perror("read");
+    }
+    if (got <= 0 && !would_block) {
+        eof_ = true;
+    }
+    buffer_.resize(unread + (got > 0 ? got : 0));
+
+    begin_ = buffer_.empty() ? NULL : &buffer_[0];
+    end_ = begin_ + buffer_.size();
+    lexer_.Rebase(begin_, end_, eof_);
+    return !would_block;
+}
+
+void SexprReader::Reset() {
+    frames_.resize(1, Frame(kToplevel, '\0', 0));
+    while (stack_.AsGrowableVector().length()) {
+        stack_.AsGrowableVector().Pop();
+    }
+
+    // Skip the rest of the line.
+    const char *pos = lexer_.pos();
+    const char *newline = (const char *)memchr(pos, '\n', end_ - pos);
+    lexer_.set_pos(newline ? newline + 1 : end_);
+}
+
+}  // namespace sanya
+
+namespace {
+
+// Files at least this large are lexed on several threads.
+const size_t kParallelSize = 4 * Heap::MB;
+const size_t kChunkSize = 1 * Heap::MB;
+
+/**
+ * @class ParallelLexer
+ * @brief Lexes a buffer on worker threads, in chunks that end at
+ * newlines, while the caller builds the data from them in order.
+ *
+ * Tokens only point into the buffer, so the workers never touch the heap.
+ * They stay a few chunks ahead of the caller, so that only those chunks'
+ * tokens are kept.
+ */
+class ParallelLexer {
+public:
+    struct Chunk {
+        const char *begin;
+        const char *end;
+        std::vector<SexprToken> tokens;
+        bool done;
+        bool ok;
+        const char *error_pos;
+        const char *error;
+    };
+
+    ParallelLexer(const char *data, size_t length, int num_threads)
+        : next_(0),
+          released_(0),
+          max_ahead_(2 * num_threads),
+          stop_(false) {
+        const char *end = data + length;
+        for (const char *begin = data; begin != end; ) {
+            const char *chunk_end = end;
+            if ((size_t)(end - begin) > kChunkSize) {
+                const char *newline = (const char *)memchr(
+                        begin + kChunkSize, '\n',
+                        end - begin - kChunkSize);
+                chunk_end = newline ? newline + 1 : end;
+            }
+            chunks_.push_back(Chunk());
+            chunks_.back().begin = begin;
+            chunks_.back().end = chunk_end;
+            chunks_.back().done = false;
+            begin = chunk_end;
+        }
+
+        pthread_mutex_init(&mutex_, NULL);
+        pthread_cond_init(&cond_, NULL);
+        for (int i = 0; i < num_threads; ++i) {
+            pthread_t thread;
+            if (pthread_create(&thread, NULL, Work, this) == 0) {
+                threads_.push_back(thread);
+            }
+        }
+    }
+
+    ~ParallelLexer() {
+        pthread_mutex_lock(&mutex_);
+        stop_ = true;
+        pthread_cond_broadcast(&cond_);
+        pthread_mutex_unlock(&mutex_);
+        for (size_t i = 0; i < threads_.size(); ++i) {
+            pthread_join(threads_[i], NULL);
+        }
+        pthread_cond_destroy(&cond_);
+        pthread_mutex_destroy(&mutex_);
+    }
+
+    size_t num_chunks() const {
+        return chunks_.size();
+    }
+
+    /** @brief Wait for the ith chunk to be lexed. */
+    const Chunk &Get(size_t i) {
+        if (threads_.empty()) {
+            // No thread could be started, lex it here.
+            Lex(&chunks_[i]);
+            return chunks_[i];
+        }
+        pthread_mutex_lock(&mutex_);
+        while (!chunks_[i].done) {
+            pthread_cond_wait(&cond_, &mutex_);
+        }
+        pthread_mutex_unlock(&mutex_);
+        return chunks_[i];
+    }
+
+    /** @brief Drop the tokens of the ith chunk and lex further ones. */
+    void Release(size_t i) {
+        std::vector<SexprToken>().swap(chunks_[i].tokens);
+        pthread_mutex_lock(&mutex_);
+        released_ = i + 1;
+        pthread_cond_broadcast(&cond_);
+        pthread_mutex_unlock(&mutex_);
+    }
+
+private:
+    static void *Work(void *arg) {
+        ParallelLexer *self = (ParallelLexer *)arg;
+        pthread_mutex_lock(&self->mutex_);
+        while (true) {
+            while (!self->stop_ && self->next_ != self->chunks_.size() &&
+                    self->next_ >= self->released_ + self->max_ahead_) {
+                pthread_cond_wait(&self->cond_, &self->mutex_);
+            }
+            if (self->stop_ || self->next_ == self->chunks_.size()) {
+                break;
+            }
+            Chunk *chunk = &self->chunks_[self->next_++];
+            pthread_mutex_unlock(&self->mutex_);
+            self->Lex(chunk);
+            pthread_mutex_lock(&self->mutex_);
+            chunk->done = true;
+            pthread_cond_broadcast(&self->cond_);
+        }
+        pthread_mutex_unlock(&self->mutex_);
+        return NULL;
+    }
+
+    void Lex(Chunk *chunk) {
+        SexprLexer lexer(chunk->begin, chunk->end, true);
+        chunk->ok = lexer.LexAll(&chunk->tokens);
+        chunk->error_pos = lexer.pos();
+        chunk->error = lexer.error();
+    }
+
+    std::vector<Chunk> chunks_;
+    size_t next_;           // To be lexed
+    size_t released_;       // Chunks before it are built
+    size_t max_ahead_;
+    bool stop_;
+    std::vector<pthread_t> threads_;
+    pthread_mutex_t mutex_;
+    pthread_cond_t cond_;
+};
+
+void Append(Handle *last, const Handle &datum) {
+    RawPair *pair = RawPair::Wrap(datum, RawNil::Wrap());
+    last->AsPair().set_cdr(pair);
+    *last = pair;
+}
+
+// The whole input as a list, or NULL if it's empty or has errors.
+RawObject *ReadProgram(SexprReader *reader) {
+    Handle program = RawPair::Wrap(RawNil::Wrap(), RawNil::Wrap());
+    Handle last = program;
+    Handle datum = NULL;
+    SexprReader::Status status;
+    while ((status = reader->Read(&datum)) == SexprReader::kDatum) {
+        Append(&last, datum);
+    }
+    if (status != SexprReader::kEnd) {
+        return NULL;
+    }
+    RawObject *result = program.AsPair().cdr();
+    return result->IsNil() ? NULL : result;
+}
+
+// The same over memory, lexed on num_threads threads.
+RawObject *ReadProgramParallel(const char *data, size_t length,
+                               int num_threads) {
+    ParallelLexer lexer(data, length, num_threads);
+    SexprReader reader(data, length);
+    Handle program = RawPair::Wrap(RawNil::Wrap(), RawNil::Wrap());
+    Handle last = program;
+    Handle datum = NULL;
+    for (size_t i = 0; i < lexer.num_chunks(); ++i) {
+        const ParallelLexer::Chunk &chunk = lexer.Get(i);
+        const SexprToken *token = chunk.tokens.empty() ? NULL
+                                                       : &chunk.tokens[0];
+        const SexprToken *end = token + chunk.tokens.size();
+        SexprReader::Status status;
+        while ((status = reader.ReadTokens(&token, end, &datum)) ==
+                SexprReader::kDatum) {
+            Append(&last, datum);
+        }
+        if (status == SexprReader::kError) {
+            return NULL;
+        }
+        if (!chunk.ok) {
+            reader.Error(chunk.error_pos, chunk.error);
+            return NULL;
+        }
+        lexer.Release(i);
+    }
+    if (!reader.Finish()) {
+        return NULL;
+    }
+    RawObject *result = program.AsPair().cdr();
+    return result->IsNil() ? NULL : result;
+}
+
+}  // namespace
+
+RawObject *sparse_do_string(const char *s) {
+    SexprReader reader(s, strlen(s));
+    return ReadProgram(&reader);
+}
+
+RawObject *sparse_do_file(FILE *fp) {
+    // Regular files are mapped and read in place, from where fp is.
+    int fd = fileno(fp);
+    struct stat file_stat;
+    off_t offset = ftello(fp);
+    if (fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode) &&
+            offset >= 0 && offset < file_stat.st_size) {
+        size_t size = file_stat.st_size;
+        void *addr = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            madvise(addr, size, MADV_SEQUENTIAL);
+            const char *data = (const char *)addr + offset;
+            size_t length = size - offset;
+            long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+            // Symbols are copied into the heap, nothing points into it.
+            RawObject *program;
+            if (length >= kParallelSize && num_cpus > 1) {
+                program = ReadProgramParallel(data, length,
+                                              num_cpus < 8 ? num_cpus : 8);
+            }
+            else {
+                SexprReader reader(data, length);
+                program = ReadProgram(&reader);
+            }
+            munmap(addr, size);
+            return program;
+        }
+    }
+
+    SexprReader reader(fd);
+    return ReadProgram(&reader);
+}
+
+// vim: set ts=4 sw=4 sts=4:
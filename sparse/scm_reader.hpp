@@ -0,0 +1,229 @@
+#ifndef SCM_READER_HPP
+#define SCM_READER_HPP
+#include <vector>
+#include "objectmodel.hpp"
+#include "handle.hpp"
+
+namespace sanya {
+
+/**
+ * @struct SexprToken
+ * @brief A token, pointing into the input.
+ */
+struct SexprToken {
+    enum Kind {
+        kOpen,          // ( or [
+        kOpenVector,    // #(
+        kClose,         // ) or ]
+        kDot,
+
+        // Prefixes that wrap the next datum.
+        kQuote,
+        kQuasiquote,
+        kUnquote,
+        kSplicing,
+
+        kFixnum,
+        kFlonum,
+        kSymbol,
+        kString,        // text is what's between the quotes
+        kTrue,
+        kFalse
+    };
+
+    Kind kind;
+    char close;         // Of kOpen and kClose, ) or ]
+    const char *text;
+    size_t length;
+};
+
+/**
+ * @class SexprLexer
+ * @brief Splits input into tokens.
+ *
+ * It doesn't touch the heap, so lexers can run on other threads. Strings
+ * and comments end at the line, so the input may be split at any newline
+ * and the pieces lexed separately.
+ */
+class SexprLexer {
+public:
+    enum Status {
+        kToken,
+        kEnd,
+        kNeedInput,     // The token may continue past end, if not eof
+        kError
+    };
+
+    SexprLexer(const char *begin, const char *end, bool eof);
+
+    /**
+     * @brief After kNeedInput, the lexer is back at the start of the
+     * token, Rebase it with more input to go on.
+     */
+    Status Next(SexprToken *token);
+
+    /** @brief Go on from begin, where the unread input was moved. */
+    void Rebase(const char *begin, const char *end, bool eof);
+
+    /**
+     * @brief Lex all of [begin, end) into tokens. Returns false on
+     * errors, with pos() and error() telling what it was.
+     */
+    bool LexAll(std::vector<SexprToken> *tokens);
+
+    const char *pos() const {
+        return pos_;
+    }
+
+    void set_pos(const char *pos) {
+        pos_ = pos;
+    }
+
+    const char *error() const {
+        return error_;
+    }
+
+private:
+    // Returns false if a comment may continue past end_.
+    bool SkipAtmosphere();
+
+    Status LexAtom(SexprToken *token);
+    Status LexString(SexprToken *token);
+    Status LexSharp(SexprToken *token);
+
+    // Up to pos_, returns how many.
+    size_t SkipDigits(const char **p) const;
+
+    // True if p ends a symbol or a number. Sets need_input_ if it's not
+    // known yet.
+    bool IsDelimiterAt(const char *p);
+
+    Status Error(const char *why);
+
+    const char *pos_;
+    const char *end_;
+    bool eof_;
+    bool need_input_;
+    const char *error_;
+};
+
+/**
+ * @class SexprReader
+ * @brief Reads toplevel data one at a time, from a file descriptor, from
+ * memory or from tokens lexed beforehand.
+ *
+ * The reader is iterative: open lists and quotes are kept on an explicit
+ * stack, and lists are built front to back through their last pair. That
+ * state is kept between calls, so a datum may span any number of reads
+ * from the descriptor, and only the unread part of the input is buffered.
+ */
+class SexprReader {
+public:
+    enum Status {
+        kDatum,         // A datum was read
+        kEnd,           // No more input
+        kWouldBlock,    // The descriptor is non-blocking and has no data
+        kError          // Syntax or IO error, reported on stderr
+    };
+
+    /** @brief Read from fd, which is not closed. */
+    explicit SexprReader(int fd);
+
+    /** @brief Read from memory, which has to outlive the reader. */
+    SexprReader(const char *data, size_t length);
+
+    /**
+     * @brief Read the next toplevel datum. After kWouldBlock, call again
+     * once fd is readable to continue. After a syntax error, the rest of
+     * the line is skipped and reading starts over from the next one.
+     */
+    Status Read(Handle *datum);
+
+    /**
+     * @brief Read from tokens lexed from the memory given to the
+     * constructor instead. Returns kEnd when they run out, to be called
+     * again with the ones that follow, which may finish the same datum.
+     * Call Finish after the last ones.
+     */
+    Status ReadTokens(const SexprToken **tokens, const SexprToken *end,
+                      Handle *datum);
+
+    /** @brief Returns false, after reporting it, if a datum is open. */
+    bool Finish();
+
+    /** @brief Report a syntax error at pos, with its line. */
+    void Error(const char *pos, const char *why);
+
+private:
+    enum FrameKind {
+        kToplevel,
+        kList,
+        kVector,
+
+        // Wrap the next datum.
+        kQuote,
+        kQuasiquote,
+        kUnquote,
+        kSplicing
+    };
+
+    enum DotState {
+        kNoDot,
+        kAfterDot,      // Expecting the tail
+        kAfterTail      // Expecting the closing parenthesis
+    };
+
+    struct Frame {
+        Frame(FrameKind kind, char close, size_t slot)
+            : kind(kind),
+              close(close),
+              slot(slot),
+              dot(kNoDot),
+              empty(true) { }
+
+        FrameKind kind;
+        char close;
+        size_t slot;    // Of the head in stack_, the last pair follows
+        DotState dot;
+        bool empty;
+    };
+
+    // What building with one token did.
+    enum Step {
+        kContinue,
+        kGotDatum,
+        kFailed
+    };
+
+    Step Build(const SexprToken &token, Handle *datum);
+    void Open(FrameKind kind, char close);
+    Step Close(const SexprToken &token, Handle *datum);
+    Step Dot(const SexprToken &token);
+
+    // Give a complete datum to the innermost frame, which sets *datum if
+    // it's a toplevel one.
+    Step Add(const SexprToken &token, const Handle &value, Handle *datum);
+
+    // Refill the buffer from fd_, keeping the unread part. Returns false
+    // if that would block.
+    bool Fill();
+
+    void Reset();
+
+    int fd_;
+    bool eof_;
+    std::vector<char> buffer_;
+    size_t lines_;      // Before begin_, for error messages
+    const char *begin_;
+    const char *end_;
+    SexprLexer lexer_;
+
+    Handle stack_;
+    std::vector<Frame> frames_;
+};
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
+
+#endif /* SCM_READER_HPP */
@@ -0,0 +1,34 @@
+; Results that are too large to be fixnums are flonums, whether they
+; come from the instructions, jit'ed or not, or from the natives.
+(define max-fixnum 576460752303423487)
+(define min-fixnum -576460752303423488)
+
+(define (add a b) (+ a b))
+(define (sub a b) (- a b))
+(define (mul a b) (* a b))
+(define (show x) (display x) (newline))
+
+(show (add max-fixnum 0))
+(show (add max-fixnum 1))
+(show (add min-fixnum -1))
+(show (sub min-fixnum 0))
+(show (sub min-fixnum 1))
+(show (sub max-fixnum -1))
+(show (mul max-fixnum 1))
+(show (mul max-fixnum 2))
+(show (mul min-fixnum -1))
+(show (mul 1073741824 1073741824))
+
+; Past the first overflow, the natives go on with flonums.
+(show (+ max-fixnum 1 -1))
+(show (- min-fixnum 1 -1))
+(show (* max-fixnum 2 1))
+(show (- min-fixnum))
+
+; Once they are hot enough to be jit'ed.
+(define (count-up x n)
+  (if (= n 0) x (count-up (add x (mul 1 (sub 2 1))) (- n 1))))
+(show (count-up 0 2000))
+(show (add max-fixnum 1))
+(show (sub min-fixnum 1))
+(show (mul max-fixnum 2))
@@ -0,0 +1,38 @@
+#!/bin/sh
+# Runs the programs in tests/ and compares what they print with the .out
+# files next to them: NAME.scm is run as a file, and the forms of
+# NAME.repl are read by the REPL, which prints the value of each one.
+#
+# Usage: tests/run.sh [path/to/main-c]
+
+main=$(cd "$(dirname "${1:-./main-c}")" && pwd)/$(basename "${1:-./main-c}")
+tests=$(cd "$(dirname "$0")" && pwd)
+
+# The .scmc images are written next to the programs, so run them in a
+# scratch directory.
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+failed=0
+for src in "$tests"/*.scm "$tests"/*.repl; do
+    [ -e "$src" ] || continue
+    name=$(basename "$src")
+    expected="${src%.*}.out"
+    cp "$src" "$work/$name"
+    case "$name" in
+        *.scm) "$main" "$work/$name" > "$work/actual" 2>&1 ;;
+        *.repl) "$main" < "$work/$name" > "$work/actual" 2>&1 ;;
+    esac
+    if diff -u "$expected" "$work/actual" > "$work/diff"; then
+        echo "PASS $name"
+    else
+        echo "FAIL $name"
+        cat "$work/diff"
+        failed=$((failed + 1))
+    fi
+done
+
+if [ $failed -ne 0 ]; then
+    echo "$failed failed"
+    exit 1
+fi
@@ -0,0 +1,35 @@
+; Self tail calls are loops, so none of these grow the stack.
+(define (count-down n)
+  (if (= n 0) 'done (count-down (- n 1))))
+(display (count-down 1000000))
+(newline)
+
+(define (sum n acc)
+  (if (= n 0) acc (sum (- n 1) (+ acc n))))
+(display (sum 100000 0))
+(newline)
+
+; The arguments are all evaluated before a parameter is overwritten.
+(define (swap a b n)
+  (if (= n 0) (list a b) (swap b a (- n 1))))
+(display (swap 1 2 3))
+(newline)
+
+; Internal defines and named lets refer to themselves as well.
+(define (factorial n)
+  (define (loop i acc)
+    (if (> i n) acc (loop (+ i 1) (* acc i))))
+  (loop 1 1))
+(display (factorial 10))
+(newline)
+
+(display (let loop ((i 0) (acc '()))
+           (if (= i 3) acc (loop (+ i 1) (cons i acc)))))
+(newline)
+
+; Assigned in the program itself, so the tail call finds the new value.
+(define (f n) (if (= n 0) 'old (f (- n 1))))
+(define g f)
+(set! f (lambda (n) 'new))
+(display (g 3))
+(newline)
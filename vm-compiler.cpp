@@ -1,34 +1,1280 @@
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
 #include "vm-compiler.hpp"
+#include "vm-insn.hpp"
 #include "inlines.hpp"
 
 namespace sanya {
 
 namespace vm_compiler {
 
+using namespace vm_insn;
+
+namespace {
+
+RawObject *Car(RawObject *o) {
+    return ((RawPair *)o)->car();
+}
+
+RawObject *Cdr(RawObject *o) {
+    return ((RawPair *)o)->cdr();
+}
+
+RawObject *Cadr(RawObject *o) {
+    return Car(Cdr(o));
+}
+
+RawObject *Cddr(RawObject *o) {
+    return Cdr(Cdr(o));
+}
+
+bool IsKeyword(RawObject *o, const char *keyword) {
+    return o->IsSymbol() && strcmp(((RawSymbol *)o)->Unwrap(), keyword) == 0;
+}
+
+bool IsForm(RawObject *expr, const char *keyword) {
+    return expr->IsPair() && IsKeyword(Car(expr), keyword);
+}
+
+intptr_t ListLength(RawObject *lis) {
+    intptr_t length = 0;
+    for (; lis->IsPair(); lis = Cdr(lis)) {
+        ++length;
+    }
+    return length;
+}
+
+std::string SymbolName(RawObject *o) {
+    return ((RawSymbol *)o)->Unwrap();
+}
+
+RawObject *Symbol(const char *s) {
+    return ObjSpace::Get().InternSymbol(s);
+}
+
+void BadSyntax(const Handle &expr) {
+    fprintf(stderr, "bad syntax: ");
+    expr.raw()->Write(stderr);
+    fprintf(stderr, "\n");
+    FATAL_ERROR("bad syntax");
+}
+
+/**
+ * @class ListBuilder
+ * @brief Builds a list front-to-back, for desugaring.
+ */
+class ListBuilder {
+public:
+    ListBuilder()
+        : head_(RawNil::Wrap()),
+          tail_(RawNil::Wrap()) { }
+
+    void Append(const Handle &item) {
+        Handle cell = RawPair::Wrap(item, RawNil::Wrap());
+        if (head_.raw()->IsNil()) {
+            head_ = cell;
+        }
+        else {
+            tail_.AsPair().set_cdr(cell.raw());
+        }
+        tail_ = cell;
+    }
+
+    /** @brief Share the given list as the rest, nothing can be appended. */
+    void Splice(const Handle &rest) {
+        if (head_.raw()->IsNil()) {
+            head_ = rest;
+        }
+        else {
+            tail_.AsPair().set_cdr(rest.raw());
+        }
+    }
+
+    RawObject *list() const {
+        return head_.raw();
+    }
+
+private:
+    Handle head_;
+    Handle tail_;
+};
+
+// (define (name . params) body...) or (define name init)
+RawObject *DefineName(RawObject *form) {
+    RawObject *target = Cadr(form);
+    return target->IsPair() ? Car(target) : target;
+}
+
+RawObject *DefineInit(const Handle &form) {
+    Handle target = Cadr(form.raw());
+    if (target.raw()->IsPair()) {
+        Handle lambda_body = RawPair::Wrap(Cdr(target.raw()),
+                                           Cddr(form.raw()));
+        return RawPair::Wrap(Symbol("lambda"), lambda_body);
+    }
+    else if (Cddr(form.raw())->IsPair()) {
+        return Car(Cddr(form.raw()));
+    }
+    else {
+        return RawNil::Wrap();
+    }
+}
+
+// Collect names defined at the toplevel and names being set! anywhere.
+void CollectNames(RawObject *expr, bool toplevel,
+                  std::vector<std::string> &defined,
+                  std::vector<std::string> &assigned) {
+    if (!expr->IsPair() || IsForm(expr, "quote")) {
+        return;
+    }
+    if (toplevel && IsForm(expr, "define") && Cdr(expr)->IsPair()) {
+        defined.push_back(SymbolName(DefineName(expr)));
+    }
+    else if (IsForm(expr, "set!") && Cdr(expr)->IsPair()) {
+        assigned.push_back(SymbolName(Cadr(expr)));
+    }
+    toplevel = toplevel && IsForm(expr, "begin");
+    for (; expr->IsPair(); expr = Cdr(expr)) {
+        CollectNames(Car(expr), toplevel, defined, assigned);
+    }
+}
+
+}  // namespace
+
+RawClosure *Compile(const Handle &program) {
+    Walker walker;
+    Handle proc = walker.CompileToplevel(program);
+    return RawClosure::Wrap(proc);
+}
 
 Walker::Walker(Walker *parent)
     : parent_(parent),
-      insn_list_(NULL) {
+      insn_list_(RawGrowableVector::Wrap()),
+      const_list_(RawGrowableVector::Wrap()),
+      global_vars_(parent ? parent->global_vars_.raw() : RawDict::Wrap()),
+      name_(RawNil::Wrap()),
+      self_global_(false),
+      arity_(0),
+      has_rest_(false),
+      next_slot_(1),
+      frame_size_(1) { }
 
-    insn_list_ = RawGrowableVector::Wrap();
+RawProcedure *Walker::CompileToplevel(const Handle &program) {
+    CollectFixedGlobals(program);
+    name_ = Symbol("toplevel");
+    VisitSequence(program, kTailVisit, kAnyFrameSlot);
+    return MakeProcedure();
 }
 
 Value Walker::visit(const Handle& expr,
                     const VisitFlag flag,
                     const intptr_t return_to) {
+    intptr_t mark = next_slot_;
+    Value result(Value::kFrameSlot);
+
     switch (expr.AsObject().object_type()) {
-        case RawObject::kFixnumType:
         case RawObject::kNilType:
             FATAL_ERROR("illegal empty combination");
-        case RawObject::kBooleanType:
-        case RawObject::kTagType:
         case RawObject::kSymbolType:
+            result = Finish(LoadVariable(expr, return_to), flag);
+            break;
         case RawObject::kPairType:
-        case RawObject::kVectorType:
-        case RawObject::kDictType:
+            result = VisitPair(expr, flag, return_to);
+            break;
         default:
-            FATAL_ERROR("not reached");
+            result = Finish(LoadConstant(expr, return_to), flag);
+            break;
+    }
+
+    // Release the temporaries, but keep the result slot reserved.
+    if (flag == kNormalVisit && return_to == kAnyFrameSlot &&
+            result.index() >= mark) {
+        next_slot_ = result.index() + 1;
+    }
+    else {
+        next_slot_ = mark;
+    }
+    return result;
+}
+
+Value Walker::VisitPair(const Handle &expr, VisitFlag flag,
+                        intptr_t return_to) {
+    RawObject *head = Car(expr.raw());
+    if (!head->IsSymbol()) {
+        return VisitApplication(expr, flag, return_to);
+    }
+
+    if (IsKeyword(head, "quote")) {
+        if (!Cdr(expr.raw())->IsPair()) {
+            BadSyntax(expr);
+        }
+        return Finish(LoadConstant(Cadr(expr.raw()), return_to), flag);
+    }
+    else if (IsKeyword(head, "if")) {
+        return VisitIf(expr, flag, return_to);
+    }
+    else if (IsKeyword(head, "define")) {
+        return VisitDefine(expr, flag, return_to);
+    }
+    else if (IsKeyword(head, "set!")) {
+        return VisitSet(expr, flag, return_to);
+    }
+    else if (IsKeyword(head, "lambda")) {
+        Handle no_name = RawNil::Wrap();
+        return Finish(VisitLambda(expr, no_name, "", false, return_to),
+                      flag);
+    }
+    else if (IsKeyword(head, "begin")) {
+        return VisitSequence(Cdr(expr.raw()), flag, return_to);
+    }
+    else if (IsKeyword(head, "let")) {
+        return VisitLet(expr, flag, return_to);
+    }
+    else if (IsKeyword(head, "let*")) {
+        return VisitLetStar(expr, flag, return_to);
+    }
+    else if (IsKeyword(head, "letrec") || IsKeyword(head, "letrec*")) {
+        // (let () (define var init) ... body...)
+        if (!Cdr(expr.raw())->IsPair()) {
+            BadSyntax(expr);
+        }
+        Handle bindings = Cadr(expr.raw());
+        Handle body = Cddr(expr.raw());
+        ListBuilder let;
+        let.Append(Symbol("let"));
+        let.Append(RawNil::Wrap());
+        for (; bindings.raw()->IsPair(); bindings = Cdr(bindings.raw())) {
+            Handle binding = Car(bindings.raw());
+            Handle define = RawPair::Wrap(Symbol("define"), binding);
+            let.Append(define);
+        }
+        let.Splice(body);
+        Handle let_expr = let.list();
+        return VisitLet(let_expr, flag, return_to);
+    }
+    else if (IsKeyword(head, "cond")) {
+        return VisitCond(expr, flag, return_to);
+    }
+    else if (IsKeyword(head, "and")) {
+        return VisitAnd(expr, flag, return_to);
+    }
+    else if (IsKeyword(head, "or")) {
+        return VisitOr(expr, flag, return_to);
+    }
+    else if (IsKeyword(head, "when") || IsKeyword(head, "unless")) {
+        // (if test (begin body...)) or (if test #f (begin body...))
+        if (!Cdr(expr.raw())->IsPair()) {
+            BadSyntax(expr);
+        }
+        bool is_when = IsKeyword(head, "when");
+        Handle test = Cadr(expr.raw());
+        Handle body = RawPair::Wrap(Symbol("begin"), Cddr(expr.raw()));
+        ListBuilder if_expr;
+        if_expr.Append(Symbol("if"));
+        if_expr.Append(test);
+        if (!is_when) {
+            if_expr.Append(RawBoolean::Wrap(false));
+        }
+        if_expr.Append(body);
+        Handle desugared = if_expr.list();
+        return VisitIf(desugared, flag, return_to);
+    }
+    else {
+        return VisitApplication(expr, flag, return_to);
+    }
+}
+
+Value Walker::VisitIf(const Handle &expr, VisitFlag flag,
+                      intptr_t return_to) {
+    intptr_t length = ListLength(expr.raw());
+    if (length != 3 && length != 4) {
+        BadSyntax(expr);
+    }
+    Handle test = Cadr(expr.raw());
+    Handle then_expr = Car(Cddr(expr.raw()));
+    Handle else_expr = RawNil::Wrap();
+    if (length == 4) {
+        else_expr = Cadr(Cddr(expr.raw()));
+    }
+    else {
+        // A missing else branch evaluates to ().
+        Handle quoted = RawPair::Wrap(RawNil::Wrap(), RawNil::Wrap());
+        Handle quote = Symbol("quote");
+        else_expr = RawPair::Wrap(quote, quoted);
+    }
+
+    intptr_t dst = flag == kTailVisit ? kAnyFrameSlot : Target(return_to);
+    intptr_t mark = next_slot_;
+
+    Value test_value = visit(test);
+    next_slot_ = mark;
+    intptr_t jump_to_else = Emit(PackIType(kBranchIfFalse,
+                                           test_value.index(), 0));
+
+    visit(then_expr, flag, dst);
+    if (flag == kTailVisit) {
+        // The then branch has returned.
+        PatchBranch(jump_to_else, NextPc());
+        return visit(else_expr, flag, dst);
     }
+
+    intptr_t jump_to_end = Emit(PackIType(kBranch, 0, 0));
+    PatchBranch(jump_to_else, NextPc());
+    visit(else_expr, flag, dst);
+    PatchBranch(jump_to_end, NextPc());
+    return Value(Value::kFrameSlot, dst);
+}
+
+Value Walker::VisitDefine(const Handle &expr, VisitFlag flag,
+                          intptr_t return_to) {
+    // Internal defines are handled by VisitBody.
+    if (parent_ || !Cdr(expr.raw())->IsPair() ||
+            !DefineName(expr.raw())->IsSymbol()) {
+        BadSyntax(expr);
+    }
+
+    Handle name = DefineName(expr.raw());
+    Handle init = DefineInit(expr);
+    Value value(Value::kFrameSlot);
+    if (IsForm(init.raw(), "lambda")) {
+        std::string self_name = IsFixedGlobal(name) ?
+            SymbolName(name.raw()) : "";
+        value = VisitLambda(init, name, self_name, true, kAnyFrameSlot);
+    }
+    else {
+        value = visit(init);
+    }
+    Emit(PackIType(kStoreGlobal, value.index(), AddGlobalCache(name)));
+
+    // Evaluates to the name.
+    return Finish(LoadConstant(name, return_to), flag);
+}
+
+Value Walker::VisitSet(const Handle &expr, VisitFlag flag,
+                       intptr_t return_to) {
+    if (ListLength(expr.raw()) != 3 || !Cadr(expr.raw())->IsSymbol()) {
+        BadSyntax(expr);
+    }
+    Handle name = Cadr(expr.raw());
+    Handle init = Car(Cddr(expr.raw()));
+
+    Value var = LookupOrAddGlobal(name);
+    Value value(Value::kFrameSlot, var.index());
+    if (var.IsFrameSlot()) {
+        visit(init, kNormalVisit, var.index());
+    }
+    else {
+        value = visit(init);
+        if (var.IsCell()) {
+            Emit(PackRType(kStoreCell, value.index(), var.index()));
+        }
+        else if (var.IsFreeCell()) {
+            intptr_t cell = AllocSlot();
+            Emit(PackRType(kLoadFree, cell, var.index()));
+            Emit(PackRType(kStoreCell, value.index(), cell));
+        }
+        else if (var.IsGlobal()) {
+            Emit(PackIType(kStoreGlobal, value.index(), var.index()));
+        }
+        else {
+            // Assigned free variables are always boxed.
+            FATAL_ERROR("assigning to an unboxed free variable");
+        }
+    }
+
+    // Evaluates to the new value.
+    if (return_to != kAnyFrameSlot && return_to != value.index()) {
+        Emit(PackRType(kMove, return_to, value.index()));
+        value.set_index(return_to);
+    }
+    return Finish(value, flag);
+}
+
+Value Walker::VisitLambda(const Handle &expr, const Handle &name,
+                          const std::string &self_name, bool self_global,
+                          intptr_t return_to) {
+    if (!Cdr(expr.raw())->IsPair()) {
+        BadSyntax(expr);
+    }
+    Handle params = Cadr(expr.raw());
+    Handle body = Cddr(expr.raw());
+
+    Walker child(this);
+    child.name_ = name.raw()->IsNil() ? Symbol("lambda") : name.raw();
+    child.self_name_ = self_name;
+    child.self_global_ = self_global;
+    child.CompileLambda(params, body);
+    Handle proc = child.MakeProcedure();
+
+    // The free variables are passed like the arguments of a call.
+    intptr_t dst = Target(return_to);
+    intptr_t mark = next_slot_;
+    intptr_t base = dst == next_slot_ - 1 ? dst : AllocSlot();
+    for (size_t i = 0; i < child.free_vars_.size(); ++i) {
+        LoadCaptured(child.free_vars_[i].name, AllocSlot());
+    }
+    Emit(PackIType(kBuildClosure, base, AddConst(proc)));
+    if (base != dst) {
+        Emit(PackRType(kMove, dst, base));
+    }
+    next_slot_ = mark;
+    return Value(Value::kFrameSlot, dst);
+}
+
+Value Walker::VisitLet(const Handle &expr, VisitFlag flag,
+                       intptr_t return_to) {
+    if (!Cdr(expr.raw())->IsPair()) {
+        BadSyntax(expr);
+    }
+    if (Cadr(expr.raw())->IsSymbol()) {
+        return VisitNamedLet(expr, flag, return_to);
+    }
+    Handle bindings = Cadr(expr.raw());
+    Handle body = Cddr(expr.raw());
+
+    intptr_t dst = flag == kTailVisit ? kAnyFrameSlot : Target(return_to);
+    intptr_t mark = next_slot_;
+    size_t depth = scope_.size();
+
+    // Evaluate all the inits before any of the variables is visible.
+    std::vector<intptr_t> slots;
+    Handle it = bindings;
+    for (; it.raw()->IsPair(); it = Cdr(it.raw())) {
+        Handle binding = Car(it.raw());
+        if (ListLength(binding.raw()) != 2) {
+            BadSyntax(expr);
+        }
+        Handle init = Cadr(binding.raw());
+        intptr_t slot = AllocSlot();
+        visit(init, kNormalVisit, slot);
+        slots.push_back(slot);
+    }
+
+    it = bindings;
+    for (size_t i = 0; i < slots.size(); ++i, it = Cdr(it.raw())) {
+        Handle var = Car(Car(it.raw()));
+        intptr_t usage = ScanUsage(body.raw(), &var.AsSymbol(), false);
+        DeclareLocal(var, slots[i], usage == (kAssigned | kCaptured));
+    }
+
+    Value result = VisitBody(body, flag, dst);
+    PopScope(depth);
+    next_slot_ = mark;
+    return flag == kTailVisit ? result : Value(Value::kFrameSlot, dst);
+}
+
+Value Walker::VisitLetStar(const Handle &expr, VisitFlag flag,
+                           intptr_t return_to) {
+    if (!Cdr(expr.raw())->IsPair()) {
+        BadSyntax(expr);
+    }
+    Handle bindings = Cadr(expr.raw());
+    Handle body = Cddr(expr.raw());
+
+    intptr_t dst = flag == kTailVisit ? kAnyFrameSlot : Target(return_to);
+    intptr_t mark = next_slot_;
+    size_t depth = scope_.size();
+
+    // Each variable is visible to the inits that follow it.
+    for (; bindings.raw()->IsPair(); bindings = Cdr(bindings.raw())) {
+        Handle binding = Car(bindings.raw());
+        if (ListLength(binding.raw()) != 2) {
+            BadSyntax(expr);
+        }
+        Handle var = Car(binding.raw());
+        Handle init = Cadr(binding.raw());
+        intptr_t slot = AllocSlot();
+        visit(init, kNormalVisit, slot);
+
+        intptr_t usage =
+            ScanUsage(Cdr(bindings.raw()), &var.AsSymbol(), false) |
+            ScanUsage(body.raw(), &var.AsSymbol(), false);
+        DeclareLocal(var, slot, usage == (kAssigned | kCaptured));
+    }
+
+    Value result = VisitBody(body, flag, dst);
+    PopScope(depth);
+    next_slot_ = mark;
+    return flag == kTailVisit ? result : Value(Value::kFrameSlot, dst);
+}
+
+Value Walker::VisitNamedLet(const Handle &expr, VisitFlag flag,
+                            intptr_t return_to) {
+    // ((letrec ((name (lambda (var...) body...))) name) init...)
+    if (ListLength(expr.raw()) < 3) {
+        BadSyntax(expr);
+    }
+    Handle name = Cadr(expr.raw());
+    Handle bindings = Car(Cddr(expr.raw()));
+    Handle body = Cdr(Cddr(expr.raw()));
+
+    ListBuilder vars;
+    ListBuilder inits;
+    for (; bindings.raw()->IsPair(); bindings = Cdr(bindings.raw())) {
+        Handle binding = Car(bindings.raw());
+        if (ListLength(binding.raw()) != 2) {
+            BadSyntax(expr);
+        }
+        vars.Append(Car(binding.raw()));
+        inits.Append(Cadr(binding.raw()));
+    }
+
+    Handle lambda_rest = RawPair::Wrap(vars.list(), body);
+    Handle lambda = RawPair::Wrap(Symbol("lambda"), lambda_rest);
+    ListBuilder binding;
+    binding.Append(name);
+    binding.Append(lambda);
+    Handle letrec_bindings = RawPair::Wrap(binding.list(), RawNil::Wrap());
+    ListBuilder letrec;
+    letrec.Append(Symbol("letrec"));
+    letrec.Append(letrec_bindings);
+    letrec.Append(name);
+
+    Handle letrec_expr = letrec.list();
+    Handle init_list = inits.list();
+    Handle call = RawPair::Wrap(letrec_expr, init_list);
+    return VisitApplication(call, flag, return_to);
+}
+
+Value Walker::VisitCond(const Handle &expr, VisitFlag flag,
+                        intptr_t return_to) {
+    intptr_t dst = Target(return_to);
+    intptr_t mark = next_slot_;
+    std::vector<intptr_t> jumps_to_end;
+    bool has_else = false;
+
+    Handle clauses = Cdr(expr.raw());
+    for (; clauses.raw()->IsPair(); clauses = Cdr(clauses.raw())) {
+        Handle clause = Car(clauses.raw());
+        if (!clause.raw()->IsPair()) {
+            BadSyntax(expr);
+        }
+        Handle body = Cdr(clause.raw());
+
+        if (IsKeyword(Car(clause.raw()), "else")) {
+            VisitSequence(body, flag, dst);
+            has_else = true;
+            break;
+        }
+
+        visit(Car(clause.raw()), kNormalVisit, dst);
+        intptr_t jump_to_next = Emit(PackIType(kBranchIfFalse, dst, 0));
+        if (body.raw()->IsNil()) {
+            // (cond (test) ...) evaluates to the test.
+            Finish(Value(Value::kFrameSlot, dst), flag);
+        }
+        else {
+            VisitSequence(body, flag, dst);
+        }
+        if (flag != kTailVisit) {
+            jumps_to_end.push_back(Emit(PackIType(kBranch, 0, 0)));
+        }
+        PatchBranch(jump_to_next, NextPc());
+        next_slot_ = mark;
+    }
+
+    if (!has_else) {
+        Finish(LoadConstant(RawNil::Wrap(), dst), flag);
+    }
+    for (size_t i = 0; i < jumps_to_end.size(); ++i) {
+        PatchBranch(jumps_to_end[i], NextPc());
+    }
+    next_slot_ = mark;
+    return Value(Value::kFrameSlot, dst);
+}
+
+Value Walker::VisitAnd(const Handle &expr, VisitFlag flag,
+                       intptr_t return_to) {
+    Handle exprs = Cdr(expr.raw());
+    if (exprs.raw()->IsNil()) {
+        return Finish(LoadConstant(RawBoolean::Wrap(true), return_to), flag);
+    }
+
+    intptr_t dst = Target(return_to);
+    std::vector<intptr_t> jumps_to_false;
+    for (; Cdr(exprs.raw())->IsPair(); exprs = Cdr(exprs.raw())) {
+        visit(Car(exprs.raw()), kNormalVisit, dst);
+        jumps_to_false.push_back(Emit(PackIType(kBranchIfFalse, dst, 0)));
+    }
+    visit(Car(exprs.raw()), flag, dst);
+
+    for (size_t i = 0; i < jumps_to_false.size(); ++i) {
+        PatchBranch(jumps_to_false[i], NextPc());
+    }
+    // The last expression has returned, so the false ones come here.
+    return Finish(Value(Value::kFrameSlot, dst), flag);
+}
+
+Value Walker::VisitOr(const Handle &expr, VisitFlag flag,
+                      intptr_t return_to) {
+    Handle exprs = Cdr(expr.raw());
+    if (exprs.raw()->IsNil()) {
+        return Finish(LoadConstant(RawBoolean::Wrap(false), return_to), flag);
+    }
+
+    intptr_t dst = Target(return_to);
+    std::vector<intptr_t> jumps_to_true;
+    for (; Cdr(exprs.raw())->IsPair(); exprs = Cdr(exprs.raw())) {
+        visit(Car(exprs.raw()), kNormalVisit, dst);
+        Emit(PackIType(kBranchIfFalse, dst, 1));
+        jumps_to_true.push_back(Emit(PackIType(kBranch, 0, 0)));
+    }
+    visit(Car(exprs.raw()), flag, dst);
+
+    for (size_t i = 0; i < jumps_to_true.size(); ++i) {
+        PatchBranch(jumps_to_true[i], NextPc());
+    }
+    return Finish(Value(Value::kFrameSlot, dst), flag);
+}
+
+Value Walker::VisitApplication(const Handle &expr, VisitFlag flag,
+                               intptr_t return_to) {
+    Handle op = Car(expr.raw());
+    Handle args = Cdr(expr.raw());
+    intptr_t argc = ListLength(args.raw());
+
+    if (flag == kTailVisit && IsSelfCall(op, argc)) {
+        return VisitSelfTailCall(args);
+    }
+
+    OpCode arith_op;
+    if (argc == 2 && IsArithmetic(op, &arith_op)) {
+        return VisitArithmetic(arith_op, args, flag, return_to);
+    }
+
+    // The callee and the arguments go into a window at the top, which
+    // can start at the destination if that is the topmost slot.
+    intptr_t dst = flag == kTailVisit ? kAnyFrameSlot : return_to;
+    intptr_t base = dst != kAnyFrameSlot && dst == next_slot_ - 1 ?
+        dst : AllocSlot();
+    visit(op, kNormalVisit, base);
+    for (; args.raw()->IsPair(); args = Cdr(args.raw())) {
+        intptr_t slot = AllocSlot();
+        visit(Car(args.raw()), kNormalVisit, slot);
+        next_slot_ = slot + 1;
+    }
+
+    if (flag == kTailVisit) {
+        Emit(PackRType(kTailCall, base, argc));
+        return Value(Value::kFrameSlot, base);
+    }
+    else if (argc <= kMaxFixedCallArity) {
+        Emit(PackRType(FixedCallOpCode(argc), base));
+    }
+    else {
+        Emit(PackRType(kCall, base, argc));
+    }
+
+    next_slot_ = base + 1;
+    if (dst != kAnyFrameSlot && dst != base) {
+        Emit(PackRType(kMove, dst, base));
+        return Value(Value::kFrameSlot, dst);
+    }
+    return Value(Value::kFrameSlot, base);
+}
+
+Value Walker::VisitArithmetic(OpCode op, const Handle &args, VisitFlag flag,
+                              intptr_t return_to) {
+    intptr_t mark = next_slot_;
+    Value lhs = visit(Car(args.raw()));
+    Value rhs = visit(Cadr(args.raw()));
+    next_slot_ = mark;
+
+    intptr_t dst = Target(flag == kTailVisit ? kAnyFrameSlot : return_to);
+    Emit(PackRType(op, dst, lhs.index(), rhs.index()));
+    return Finish(Value(Value::kFrameSlot, dst), flag);
+}
+
+Value Walker::VisitSelfTailCall(const Handle &args) {
+    // A global may no longer be ourself by the time of the call, which is
+    // then a plain tail call of its new value.
+    intptr_t base = -1;
+    if (self_global_) {
+        base = AllocSlot();
+        Emit(PackIType(kLoadGlobal, base, AddGlobalCache(name_)));
+    }
+
+    // Evaluate all the arguments before overwriting any parameter.
+    std::vector<intptr_t> temps;
+    Handle it = args;
+    for (; it.raw()->IsPair(); it = Cdr(it.raw())) {
+        intptr_t slot = AllocSlot();
+        visit(Car(it.raw()), kNormalVisit, slot);
+        temps.push_back(slot);
+        next_slot_ = slot + 1;
+    }
+    intptr_t jump_to_call = -1;
+    if (self_global_) {
+        jump_to_call = Emit(PackIType(kBranchIfNotSelf, base, 0));
+    }
+    for (size_t i = 0; i < temps.size(); ++i) {
+        Emit(PackRType(kMove, 1 + i, temps[i]));
+    }
+
+    // Back to the prologue, which boxes the parameters if needed.
+    Emit(PackIType(kBranch, 0, -(NextPc() + 1)));
+    if (self_global_) {
+        PatchBranch(jump_to_call, NextPc());
+        Emit(PackRType(kTailCall, base, temps.size()));
+    }
+    return Value(Value::kFrameSlot, 0);
+}
+
+Value Walker::VisitSequence(const Handle &exprs, VisitFlag flag,
+                            intptr_t return_to) {
+    if (!exprs.raw()->IsPair()) {
+        return Finish(LoadConstant(RawNil::Wrap(), return_to), flag);
+    }
+
+    intptr_t mark = next_slot_;
+    Handle it = exprs;
+    for (; Cdr(it.raw())->IsPair(); it = Cdr(it.raw())) {
+        visit(Car(it.raw()));
+        next_slot_ = mark;
+    }
+    return visit(Car(it.raw()), flag, return_to);
+}
+
+Value Walker::VisitBody(const Handle &body, VisitFlag flag,
+                        intptr_t return_to) {
+    bool has_define = false;
+    for (RawObject *it = body.raw(); it->IsPair(); it = Cdr(it)) {
+        if (IsForm(Car(it), "define")) {
+            has_define = true;
+        }
+    }
+    if (!has_define) {
+        return VisitSequence(body, flag, return_to);
+    }
+
+    intptr_t dst = flag == kTailVisit ? kAnyFrameSlot : Target(return_to);
+    intptr_t mark = next_slot_;
+    size_t depth = scope_.size();
+
+    // Internal defines are letrec* bindings. A variable is boxed if it
+    // may be captured before being initialized, unless the capture is
+    // by its own lambda, which refers to itself as R[0].
+    std::vector<bool> self_refs;
+    Handle it = body;
+    for (; it.raw()->IsPair(); it = Cdr(it.raw())) {
+        Handle form = Car(it.raw());
+        if (!IsForm(form.raw(), "define")) {
+            continue;
+        }
+        if (!Cdr(form.raw())->IsPair() ||
+                !DefineName(form.raw())->IsSymbol()) {
+            BadSyntax(form);
+        }
+        Handle var = DefineName(form.raw());
+        bool is_lambda = Cadr(form.raw())->IsPair() ||
+            (Cddr(form.raw())->IsPair() &&
+             IsForm(Car(Cddr(form.raw())), "lambda"));
+
+        intptr_t all_usage = kUnused;
+        intptr_t others_usage = kUnused;
+        for (RawObject *f = body.raw(); f->IsPair(); f = Cdr(f)) {
+            intptr_t usage = ScanExpr(Car(f), &var.AsSymbol(), false);
+            all_usage |= usage;
+            if (Car(f) != form.raw() || !is_lambda) {
+                others_usage |= usage;
+            }
+        }
+        bool assigned = all_usage & kAssigned;
+        bool boxed = assigned ? all_usage & kCaptured
+                              : others_usage & kCaptured;
+        self_refs.push_back(!assigned && is_lambda);
+
+        intptr_t slot = AllocSlot();
+        if (boxed) {
+            Emit(PackRType(kLoadNil, slot));
+        }
+        DeclareLocal(var, slot, boxed);
+    }
+
+    Value result(Value::kFrameSlot, dst);
+    size_t nth_define = 0;
+    intptr_t locals_mark = next_slot_;
+    for (it = body; it.raw()->IsPair(); it = Cdr(it.raw())) {
+        Handle form = Car(it.raw());
+        bool is_last = !Cdr(it.raw())->IsPair();
+
+        if (!IsForm(form.raw(), "define")) {
+            if (is_last) {
+                result = visit(form, flag, dst);
+            }
+            else {
+                visit(form);
+                next_slot_ = locals_mark;
+            }
+            continue;
+        }
+
+        Handle var = DefineName(form.raw());
+        Handle init = DefineInit(form);
+        Value local = Lookup(SymbolName(var.raw()));
+        std::string self_name = self_refs[nth_define++] ?
+            SymbolName(var.raw()) : "";
+        intptr_t to = local.IsCell() ? kAnyFrameSlot : local.index();
+
+        Value value(Value::kFrameSlot);
+        if (IsForm(init.raw(), "lambda")) {
+            value = VisitLambda(init, var, self_name, false, to);
+        }
+        else {
+            value = visit(init, kNormalVisit, to);
+        }
+        if (local.IsCell()) {
+            Emit(PackRType(kStoreCell, value.index(), local.index()));
+        }
+        next_slot_ = locals_mark;
+
+        if (is_last) {
+            result = Finish(LoadConstant(RawNil::Wrap(), dst), flag);
+        }
+    }
+
+    PopScope(depth);
+    next_slot_ = mark;
+    return flag == kTailVisit ? result : Value(Value::kFrameSlot, dst);
+}
+
+Value Walker::LoadVariable(const Handle &symbol, intptr_t return_to) {
+    Value var = LookupOrAddGlobal(symbol);
+    if (var.IsFrameSlot()) {
+        if (return_to == kAnyFrameSlot || return_to == var.index()) {
+            return var;
+        }
+        Emit(PackRType(kMove, return_to, var.index()));
+        return Value(Value::kFrameSlot, return_to);
+    }
+
+    intptr_t dst = Target(return_to);
+    if (var.IsCell()) {
+        Emit(PackRType(kLoadCell, dst, var.index()));
+    }
+    else if (var.IsFree()) {
+        Emit(PackRType(kLoadFree, dst, var.index()));
+    }
+    else if (var.IsFreeCell()) {
+        Emit(PackRType(kLoadFree, dst, var.index()));
+        Emit(PackRType(kLoadCell, dst, dst));
+    }
+    else {
+        Emit(PackIType(kLoadGlobal, dst, var.index()));
+    }
+    return Value(Value::kFrameSlot, dst);
+}
+
+Value Walker::LoadConstant(const Handle &value, intptr_t return_to) {
+    intptr_t dst = Target(return_to);
+    RawObject *o = value.raw();
+    if (o->IsFixnum() && ((RawFixnum *)o)->Unwrap() == (Immediate)
+            ((RawFixnum *)o)->Unwrap()) {
+        Emit(PackIType(kLoadFixnum, dst, ((RawFixnum *)o)->Unwrap()));
+    }
+    else if (o->IsNil()) {
+        Emit(PackRType(kLoadNil, dst));
+    }
+    else if (o->IsBoolean()) {
+        Emit(PackRType(kLoadBool, dst, ((RawBoolean *)o)->Unwrap()));
+    }
+    else {
+        Emit(PackIType(kLoadConst, dst, AddConst(value)));
+    }
+    return Value(Value::kFrameSlot, dst);
+}
+
+void Walker::LoadCaptured(const std::string &name, intptr_t slot) {
+    Value var = Lookup(name);
+    if (var.IsFrameSlot() || var.IsCell()) {
+        Emit(PackRType(kMove, slot, var.index()));
+    }
+    else if (var.IsFree() || var.IsFreeCell()) {
+        Emit(PackRType(kLoadFree, slot, var.index()));
+    }
+    else {
+        FATAL_ERROR("capturing a global variable");
+    }
+}
+
+Value Walker::Finish(Value value, VisitFlag flag) {
+    if (flag == kTailVisit) {
+        Emit(PackRType(kRet, value.index()));
+    }
+    return value;
+}
+
+Value Walker::Lookup(const std::string &name) {
+    for (size_t i = scope_.size(); i-- > 0; ) {
+        if (scope_[i].name == name) {
+            return Value(scope_[i].boxed ? Value::kCell : Value::kFrameSlot,
+                         scope_[i].slot);
+        }
+    }
+    if (!self_name_.empty() && !self_global_ && name == self_name_) {
+        return Value(Value::kFrameSlot, 0);
+    }
+    for (size_t i = 0; i < free_vars_.size(); ++i) {
+        if (free_vars_[i].name == name) {
+            return Value(free_vars_[i].boxed ? Value::kFreeCell
+                                             : Value::kFree, i);
+        }
+    }
+    if (parent_) {
+        Value outer = parent_->Lookup(name);
+        if (!outer.IsGlobal()) {
+            bool boxed = outer.IsCell() || outer.IsFreeCell();
+            free_vars_.push_back(FreeVar(name, boxed));
+            return Value(boxed ? Value::kFreeCell : Value::kFree,
+                         free_vars_.size() - 1);
+        }
+    }
+    return Value(Value::kGlobal, -1);
+}
+
+Value Walker::LookupOrAddGlobal(const Handle &symbol) {
+    Value var = Lookup(SymbolName(symbol.raw()));
+    if (var.IsGlobal()) {
+        var.set_index(AddGlobalCache(symbol));
+    }
+    return var;
+}
+
+bool Walker::IsSelfCall(const Handle &op, intptr_t argc) {
+    if (!op.raw()->IsSymbol() || self_name_.empty() ||
+            SymbolName(op.raw()) != self_name_) {
+        return false;
+    }
+    // Not shadowed by a local.
+    Value var = Lookup(self_name_);
+    if (self_global_ ? !var.IsGlobal()
+                     : !var.IsFrameSlot() || var.index() != 0) {
+        return false;
+    }
+    return argc == arity_ && !has_rest_;
+}
+
+bool Walker::IsArithmetic(const Handle &op, OpCode *arith_op) {
+    if (!op.raw()->IsSymbol() || !Lookup(SymbolName(op.raw())).IsGlobal()) {
+        return false;
+    }
+    for (intptr_t i = kAdd; i <= kNumEq; ++i) {
+        if (!IsKeyword(op.raw(), ArithmeticName((OpCode)i))) {
+            continue;
+        }
+        // Still the native from the prelude, and not redefined by the
+        // program being compiled. Later ones are left to the interpreter.
+        RawObject *value = ObjSpace::Get().LookupGlobal(op)->cdr();
+        if (!IsArithmeticNative((OpCode)i, value) ||
+                global_vars_.AsDict().LookupSymbol(op,
+                    RawDict::kLookupDefault)) {
+            return false;
+        }
+        *arith_op = (OpCode)i;
+        return true;
+    }
+    return false;
+}
+
+void Walker::CompileLambda(const Handle &params, const Handle &body) {
+    Handle it = params;
+    for (; it.raw()->IsPair(); it = Cdr(it.raw())) {
+        if (!Car(it.raw())->IsSymbol()) {
+            BadSyntax(params);
+        }
+        ++arity_;
+    }
+    if (!it.raw()->IsNil()) {
+        if (!it.raw()->IsSymbol()) {
+            BadSyntax(params);
+        }
+        has_rest_ = true;
+    }
+    next_slot_ = 1 + arity_ + has_rest_;
+    frame_size_ = next_slot_;
+
+    // The prologue. A self tail call jumps back here.
+    intptr_t slot = 1;
+    for (it = params; it.raw()->IsPair(); it = Cdr(it.raw()), ++slot) {
+        Handle var = Car(it.raw());
+        intptr_t usage = ScanUsage(body.raw(), &var.AsSymbol(), false);
+        DeclareLocal(var, slot, usage == (kAssigned | kCaptured));
+    }
+    if (has_rest_) {
+        intptr_t usage = ScanUsage(body.raw(), &it.AsSymbol(), false);
+        DeclareLocal(it, slot, usage == (kAssigned | kCaptured));
+    }
+
+    VisitBody(body, kTailVisit, kAnyFrameSlot);
+}
+
+RawProcedure *Walker::MakeProcedure() {
+    FuseInstructions();
+
+    std::vector<CodeWord> words;
+    Assemble(&words);
+    CodeWord *code = (CodeWord *)malloc(words.size() * sizeof(CodeWord));
+    std::copy(words.begin(), words.end(), code);
+
+    size_t num_consts = const_list_.AsGrowableVector().length();
+    Handle consts = RawVector::Wrap(num_consts, RawNil::Wrap());
+    for (size_t i = 0; i < num_consts; ++i) {
+        consts.AsVector().At(i) = const_list_.AsGrowableVector().At(i);
+    }
+
+    return RawProcedure::Wrap(code, words.size(), true, consts, name_,
+                              arity_, has_rest_, frame_size_,
+                              free_vars_.size());
+}
+
+void Walker::FuseInstructions() {
+    RawGrowableVector &insns = insn_list_.AsGrowableVector();
+    for (size_t i = 0; i + 1 < insns.length(); ++i) {
+        Insn first = ToInsn(insns.At(i));
+        OpCode fused = FusedOpCode(UnpackOperator(first),
+                                   UnpackOperator(ToInsn(insns.At(i + 1))));
+        if (fused != kNop) {
+            insns.At(i) = ReplaceOperator(first, fused);
+            // Leave the second one alone.
+            ++i;
+        }
+    }
+}
+
+void Walker::Assemble(std::vector<CodeWord> *words) {
+    if (frame_size_ > kMaxOperand + 1) {
+        FATAL_ERROR("too many registers");
+    }
+
+    // Nothing is allocated here, raw references are fine.
+    RawGrowableVector &insn_list = insn_list_.AsGrowableVector();
+    size_t num_insns = insn_list.length();
+    std::vector<Insn> insns(num_insns);
+    std::vector<bool> wide(num_insns, false);
+    for (size_t i = 0; i < num_insns; ++i) {
+        insns[i] = ToInsn(insn_list.At(i));
+        intptr_t imm = UnpackImmediate(insns[i]);
+        OpCode op = UnfusedOpCode(UnpackOperator(insns[i]));
+        if (HasImmediate(op) && !IsBranch(op) &&
+                (imm < kMinNarrowImmediate || imm > kMaxNarrowImmediate)) {
+            wide[i] = true;
+        }
+    }
+
+    // Branch offsets are in instructions so far. Widening a branch moves
+    // the others' targets, repeat until nothing changes. Branches only
+    // ever get wider, so this terminates.
+    std::vector<intptr_t> pos(num_insns + 1);
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 0; i < num_insns; ++i) {
+            pos[i + 1] = pos[i] + (wide[i] ? kWideLength : 1);
+        }
+        for (size_t i = 0; i < num_insns; ++i) {
+            if (wide[i] || !IsBranch(UnpackOperator(insns[i]))) {
+                continue;
+            }
+            intptr_t to = i + 1 + UnpackImmediate(insns[i]);
+            intptr_t offset = pos[to] - pos[i + 1];
+            if (offset < kMinNarrowImmediate ||
+                    offset > kMaxNarrowImmediate) {
+                wide[i] = true;
+                changed = true;
+            }
+        }
+    }
+
+    // The interpreter expects both halves of a superinstruction to be
+    // one word each.
+    for (size_t i = 0; i + 1 < num_insns; ++i) {
+        OpCode op = UnpackOperator(insns[i]);
+        if (UnfusedOpCode(op) != op && (wide[i] || wide[i + 1])) {
+            insns[i] = ToInsn(ReplaceOperator(insns[i], UnfusedOpCode(op)));
+        }
+    }
+
+    words->reserve(pos[num_insns]);
+    for (size_t i = 0; i < num_insns; ++i) {
+        Insn insn = insns[i];
+        OpCode op = UnpackOperator(insn);
+        intptr_t a = UnpackOperandA(insn);
+        if (a > kMaxOperand) {
+            FATAL_ERROR("too many registers");
+        }
+        if (!HasImmediate(UnfusedOpCode(op))) {
+            intptr_t b = UnpackOperandB(insn);
+            intptr_t c = UnpackOperandC(insn);
+            if (b > kMaxOperand || c > kMaxOperand) {
+                FATAL_ERROR("too many registers");
+            }
+            words->push_back(EncodeRType(op, a, b, c));
+            continue;
+        }
+
+        intptr_t imm = UnpackImmediate(insn);
+        if (IsBranch(op)) {
+            imm = pos[i + 1 + imm] - pos[i + 1];
+        }
+        if (wide[i]) {
+            words->push_back(EncodeRType(kWide, 0));
+            words->push_back(EncodeIType(op, a, 0));
+            words->push_back((CodeWord)imm);
+        }
+        else {
+            words->push_back(EncodeIType(op, a, imm));
+        }
+    }
+}
+
+intptr_t Walker::Emit(RawFixnum *insn) {
+    insn_list_.AsGrowableVector().Append(insn);
+    return insn_list_.AsGrowableVector().length() - 1;
+}
+
+intptr_t Walker::NextPc() {
+    return insn_list_.AsGrowableVector().length();
+}
+
+void Walker::PatchBranch(intptr_t at, intptr_t to) {
+    RawObject *&slot = insn_list_.AsGrowableVector().At(at);
+    Insn insn = ToInsn(slot);
+    slot = PackIType(UnpackOperator(insn), UnpackOperandA(insn),
+                     to - (at + 1));
+}
+
+intptr_t Walker::AddConst(const Handle &value) {
+    RawGrowableVector &consts = const_list_.AsGrowableVector();
+    for (size_t i = 0; i < consts.length(); ++i) {
+        if (consts.At(i) == value.raw()) {
+            return i;
+        }
+    }
+    consts.Append(value);
+    return const_list_.AsGrowableVector().length() - 1;
+}
+
+intptr_t Walker::AddGlobalCache(const Handle &symbol) {
+    RawGrowableVector &consts = const_list_.AsGrowableVector();
+    for (size_t i = 0; i < global_caches_.size(); ++i) {
+        if (((RawPair *)consts.At(global_caches_[i]))->car() == symbol.raw()) {
+            return global_caches_[i];
+        }
+    }
+    Handle cache = NewGlobalCache(symbol);
+    const_list_.AsGrowableVector().Append(cache);
+    global_caches_.push_back(const_list_.AsGrowableVector().length() - 1);
+    return global_caches_.back();
+}
+
+intptr_t Walker::AllocSlot() {
+    intptr_t slot = next_slot_++;
+    if (next_slot_ > frame_size_) {
+        frame_size_ = next_slot_;
+    }
+    return slot;
+}
+
+intptr_t Walker::Target(intptr_t return_to) {
+    return return_to == kAnyFrameSlot ? AllocSlot() : return_to;
+}
+
+intptr_t Walker::DeclareLocal(const Handle &symbol, intptr_t slot,
+                              bool boxed) {
+    scope_.push_back(Binding(SymbolName(symbol.raw()), slot, boxed));
+    if (boxed) {
+        Emit(PackRType(kBuildCell, slot));
+    }
+    return slot;
+}
+
+void Walker::PopScope(size_t depth) {
+    scope_.resize(depth, Binding("", 0, false));
+}
+
+intptr_t Walker::ScanUsage(RawObject *exprs, RawSymbol *var,
+                           bool in_lambda) {
+    intptr_t usage = kUnused;
+    for (; exprs->IsPair(); exprs = Cdr(exprs)) {
+        usage |= ScanExpr(Car(exprs), var, in_lambda);
+    }
+    return usage;
+}
+
+intptr_t Walker::ScanExpr(RawObject *expr, RawSymbol *var,
+                          bool in_lambda) {
+    if (expr == var) {
+        return in_lambda ? kCaptured : kUnused;
+    }
+    if (!expr->IsPair() || IsForm(expr, "quote")) {
+        return kUnused;
+    }
+
+    RawObject *rest = Cdr(expr);
+    if (IsForm(expr, "lambda") && rest->IsPair()) {
+        RawObject *params = Car(rest);
+        for (; params->IsPair(); params = Cdr(params)) {
+            if (Car(params) == var) {
+                return kUnused;
+            }
+        }
+        return params == var ? kUnused : ScanUsage(Cdr(rest), var, true);
+    }
+    if (IsForm(expr, "define") && rest->IsPair() && Car(rest)->IsPair()) {
+        // (define (name . params) body...) is a lambda.
+        return ScanUsage(Cdr(rest), var, true);
+    }
+    if (IsForm(expr, "let") && rest->IsPair() && Car(rest)->IsSymbol() &&
+            Cdr(rest)->IsPair()) {
+        // The body of a named let is a lambda.
+        intptr_t usage = kUnused;
+        for (RawObject *b = Cadr(rest); b->IsPair(); b = Cdr(b)) {
+            usage |= ScanUsage(Car(b), var, in_lambda);
+        }
+        return usage | ScanUsage(Cddr(rest), var, true);
+    }
+
+    intptr_t usage = kUnused;
+    if (IsForm(expr, "set!") && rest->IsPair() && Car(rest) == var) {
+        usage |= in_lambda ? kAssigned | kCaptured : kAssigned;
+    }
+    return usage | ScanUsage(expr, var, in_lambda);
+}
+
+void Walker::CollectFixedGlobals(const Handle &program) {
+    std::vector<std::string> defined;
+    std::vector<std::string> assigned;
+    for (RawObject *it = program.raw(); it->IsPair(); it = Cdr(it)) {
+        CollectNames(Car(it), true, defined, assigned);
+    }
+
+    // Number of definitions, or #f if assigned.
+    RawDict &dict = global_vars_.AsDict();
+    for (size_t i = 0; i < defined.size(); ++i) {
+        Handle symbol = Symbol(defined[i].c_str());
+        RawPair *entry = dict.LookupSymbol(symbol, RawDict::kLookupDefault);
+        if (entry) {
+            entry->set_cdr(RawFixnum::Wrap(
+                        ((RawFixnum *)entry->cdr())->Unwrap() + 1));
+        }
+        else {
+            entry = global_vars_.AsDict().LookupSymbol(symbol,
+                    RawDict::kCreateOnAbsent);
+            entry->set_cdr(RawFixnum::Wrap(1));
+        }
+    }
+    for (size_t i = 0; i < assigned.size(); ++i) {
+        Handle symbol = Symbol(assigned[i].c_str());
+        global_vars_.AsDict().LookupSymbol(symbol, RawDict::kCreateOnAbsent)
+            ->set_cdr(RawBoolean::Wrap(false));
+    }
+}
+
+bool Walker::IsFixedGlobal(const Handle &symbol) {
+    RawPair *entry = global_vars_.AsDict().LookupSymbol(symbol,
+            RawDict::kLookupDefault);
+    return entry && entry->cdr() == RawFixnum::Wrap(1);
 }
 
 }  // namespace vm_compiler
@@ -36,4 +1282,3 @@ Value Walker::visit(const Handle& expr,
 }  // namespace sanya
 
 // vim: set ts=4 sw=4 sts=4:
-
@@ -1,12 +1,21 @@
 #ifndef VM_COMPILER_HPP
 #define VM_COMPILER_HPP
+#include <string>
+#include <vector>
 #include "objectmodel.hpp"
 #include "handle.hpp"
+#include "vm-insn.hpp"
 
 namespace sanya {
 
 namespace vm_compiler {
 
+/**
+ * @brief Compile a list of toplevel forms (as returned by the parser)
+ * into a closure that takes no argument.
+ */
+RawClosure *Compile(const Handle &program);
+
 /**
  * @class Value
  * @brief Compile-time value representation.
@@ -14,15 +23,18 @@ namespace vm_compiler {
 class Value {
 public:
     enum Type {
-        kFrameSlot,
-        kCell,
-        kGlobal,
+        kFrameSlot,  // R[index]
+        kCell,       // Cell in R[index]
+        kFree,       // E[index]
+        kFreeCell,   // Cell in E[index]
+        kGlobal,     // Global named K[index]
         kConst
     };
 
-    Value(Type tp)
+    Value(Type tp, intptr_t index = 0)
         : type_(tp),
-          value_(NULL) { }
+          value_(NULL),
+          index_(index) { }
 
     bool IsFrameSlot() {
         return type_ == kFrameSlot;
@@ -32,6 +44,14 @@ public:
         return type_ == kCell;
     }
 
+    bool IsFree() {
+        return type_ == kFree;
+    }
+
+    bool IsFreeCell() {
+        return type_ == kFreeCell;
+    }
+
     bool IsGlobal() {
         return type_ == kGlobal;
     }
@@ -65,6 +85,11 @@ protected:
 /**
  * @class Walker
  * @brief Visits expressions and calculate the result
+ *
+ * One walker compiles one lambda (or the toplevel). Registers are
+ * allocated as a stack: R[0] is the closure itself, followed by the
+ * arguments, the locals and the temporaries. Calls are compiled into
+ * a window at the top of the used registers (see vm-interp.hpp).
  */
 class Walker {
 public:
@@ -75,15 +100,149 @@ public:
     const static intptr_t kAnyFrameSlot = -1;
 
     Walker(Walker *parent = NULL);
+
+    /**
+     * @brief Compile expr. The result is put into the return_to slot if
+     * given, otherwise the returned slot is reserved until the caller
+     * releases it. In tail position, the result is returned instead.
+     */
     Value visit(const Handle& expr,
                 const VisitFlag flag = kNormalVisit,
                 const intptr_t return_to = kAnyFrameSlot);
 
+    /** @brief Compile a sequence of toplevel forms into a procedure */
+    RawProcedure *CompileToplevel(const Handle &program);
+
 protected:
+    struct Binding {
+        Binding(const std::string &name, intptr_t slot, bool boxed)
+            : name(name),
+              slot(slot),
+              boxed(boxed) { }
+
+        std::string name;
+        intptr_t slot;
+        bool boxed;  // Holds a cell, see ScanUsage
+    };
+
+    struct FreeVar {
+        FreeVar(const std::string &name, bool boxed)
+            : name(name),
+              boxed(boxed) { }
+
+        std::string name;
+        bool boxed;
+    };
+
+    // Results of ScanUsage
+    enum Usage {
+        kUnused   = 0,
+        kAssigned = 1,
+        kCaptured = 2
+    };
+
+    Value VisitPair(const Handle &expr, VisitFlag flag, intptr_t return_to);
+    Value VisitIf(const Handle &expr, VisitFlag flag, intptr_t return_to);
+    Value VisitDefine(const Handle &expr, VisitFlag flag, intptr_t return_to);
+    Value VisitSet(const Handle &expr, VisitFlag flag, intptr_t return_to);
+    Value VisitLambda(const Handle &expr, const Handle &name,
+                      const std::string &self_name, bool self_global,
+                      intptr_t return_to);
+    Value VisitLet(const Handle &expr, VisitFlag flag, intptr_t return_to);
+    Value VisitLetStar(const Handle &expr, VisitFlag flag,
+                       intptr_t return_to);
+    Value VisitNamedLet(const Handle &expr, VisitFlag flag,
+                        intptr_t return_to);
+    Value VisitCond(const Handle &expr, VisitFlag flag, intptr_t return_to);
+    Value VisitAnd(const Handle &expr, VisitFlag flag, intptr_t return_to);
+    Value VisitOr(const Handle &expr, VisitFlag flag, intptr_t return_to);
+    Value VisitApplication(const Handle &expr, VisitFlag flag,
+                           intptr_t return_to);
+
+    // Turn a self tail call into moves and a branch to the start, after
+    // checking that a global still refers to ourself.
+    Value VisitSelfTailCall(const Handle &args);
+
+    // Binary arithmetics and comparisons of the prelude, as instructions.
+    Value VisitArithmetic(vm_insn::OpCode op, const Handle &args,
+                          VisitFlag flag, intptr_t return_to);
+    bool IsArithmetic(const Handle &op, vm_insn::OpCode *arith_op);
+
+    // Like begin.
+    Value VisitSequence(const Handle &exprs, VisitFlag flag,
+                        intptr_t return_to);
+
+    // Lambda or let body, internal defines are letrec* bindings.
+    Value VisitBody(const Handle &body, VisitFlag flag, intptr_t return_to);
+
+    // Load a variable or a constant into a frame slot.
+    Value LoadVariable(const Handle &symbol, intptr_t return_to);
+    Value LoadConstant(const Handle &value, intptr_t return_to);
+
+    // Copy a variable for a closure without unboxing its cell.
+    void LoadCaptured(const std::string &name, intptr_t slot);
+
+    // Emit a return in tail position.
+    Value Finish(Value value, VisitFlag flag);
+
+    // Find a variable from this walker's point of view. Globals are
+    // returned with an index of -1.
+    Value Lookup(const std::string &name);
+    Value LookupOrAddGlobal(const Handle &symbol);
+    bool IsSelfCall(const Handle &op, intptr_t argc);
+
+    // Compile the parameters and body of a lambda.
+    void CompileLambda(const Handle &params, const Handle &body);
+    RawProcedure *MakeProcedure();
+
+    // Peephole pass, turn adjacent pairs into superinstructions.
+    void FuseInstructions();
+
+    // Encode insn_list_ into code words, see vm_insn::CodeWord.
+    void Assemble(std::vector<vm_insn::CodeWord> *words);
+
+    // Emitting code.
+    intptr_t Emit(RawFixnum *insn);
+    intptr_t NextPc();
+    void PatchBranch(intptr_t at, intptr_t to);
+    intptr_t AddConst(const Handle &value);
+
+    // One cache per global variable used in this procedure.
+    intptr_t AddGlobalCache(const Handle &symbol);
+
+    // Register stack.
+    intptr_t AllocSlot();
+    intptr_t Target(intptr_t return_to);
+    intptr_t DeclareLocal(const Handle &symbol, intptr_t slot, bool boxed);
+    void PopScope(size_t depth);
+
+    // How the variable is used in exprs. Shadowing is mostly ignored,
+    // which is safe since we only box more variables than needed.
+    static intptr_t ScanUsage(RawObject *exprs, RawSymbol *var,
+                              bool in_lambda);
+    static intptr_t ScanExpr(RawObject *expr, RawSymbol *var,
+                             bool in_lambda);
+
+    // Find out globals that are defined once and never assigned to,
+    // so that recursive calls to them can be treated as self calls.
+    void CollectFixedGlobals(const Handle &program);
+    bool IsFixedGlobal(const Handle &symbol);
+
     Walker *parent_;
     Handle insn_list_;
     Handle const_list_;
     Handle global_vars_;
+
+    Handle name_;
+    std::string self_name_;  // Binding that refers to ourself
+    bool self_global_;       // Which is a global, never kept in R[0]
+    intptr_t arity_;
+    bool has_rest_;
+    intptr_t next_slot_;
+    intptr_t frame_size_;
+    std::vector<Binding> scope_;
+    std::vector<FreeVar> free_vars_;
+    std::vector<intptr_t> global_caches_;  // Indices into const_list_
 };
 
 }  // namespace vm_compiler
@@ -0,0 +1,583 @@
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "vm-image.hpp"
+#include "vm-insn.hpp"
+#include "objspace.hpp"
+#include "inlines.hpp"
+
+namespace sanya {
+
+namespace vm_image {
+
+using namespace vm_insn;
+
+namespace {
+
+const char kMagic[4] = { 'S', 'N', 'Y', 'I' };
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t num_opcodes;       // vm_insn::kLast
+    uint32_t num_procedures;
+    uint32_t code_offset;       // In bytes, from the start of the file
+    uint32_t code_length;       // In words
+    uint32_t consts_offset;
+    uint32_t consts_length;     // In bytes
+};
+
+// Follows the header. A procedure comes after the ones in its constants,
+// so the toplevel one is the last.
+struct ProcedureEntry {
+    uint32_t code_start;        // In words, from code_offset
+    uint32_t code_length;
+    uint32_t consts_start;      // In bytes, from consts_offset
+    uint32_t num_consts;
+    int32_t arity;
+    int32_t has_rest;
+    int32_t frame_size;
+    int32_t num_free;
+};
+
+// The name of a procedure and its constants are written as a tag and its
+// payload.
+enum DatumTag {
+    kFixnumDatum = 0,   // int64 value
+    kNilDatum,
+    kFalseDatum,
+    kTrueDatum,
+    kSymbolDatum,       // uint32 length, chars
+    kListDatum,         // uint32 n, tail, the n elements from the last
+    kProcedureDatum,    // uint32 index into the procedure table
+    kFlonumDatum,       // double value
+    kStringDatum        // uint32 length, chars
+};
+
+/**
+ * @class Writer
+ * @brief Collects the procedures of an image in memory.
+ *
+ * Nothing is allocated while writing, so raw pointers are fine.
+ */
+class Writer {
+public:
+    bool AddProcedure(RawProcedure *proc);
+    bool WriteFile(const char *path);
+
+private:
+    bool AddDatum(RawObject *datum);
+
+    void Put(const void *data, size_t size) {
+        consts_.append((const char *)data, size);
+    }
+
+    void PutTag(DatumTag tag) {
+        uint8_t byte = tag;
+        Put(&byte, sizeof(byte));
+    }
+
+    void PutU32(uint32_t value) {
+        Put(&value, sizeof(value));
+    }
+
+    std::vector<ProcedureEntry> procedures_;
+    std::vector<CodeWord> code_;
+    std::string consts_;
+    std::map<RawProcedure *, uint32_t> indices_;
+};
+
+bool Writer::AddProcedure(RawProcedure *proc) {
+    RawVector *consts = proc->consts();
+    for (size_t i = 0; i < consts->length(); ++i) {
+        RawObject *value = consts->At(i);
+        if (value->IsProcedure() && !indices_.count((RawProcedure *)value)) {
+            if (!AddProcedure((RawProcedure *)value)) {
+                return false;
+            }
+        }
+    }
+
+    ProcedureEntry entry;
+    entry.code_start = code_.size();
+    entry.code_length = proc->code_length();
+    entry.consts_start = consts_.size();
+    entry.num_consts = consts->length();
+    entry.arity = proc->arity();
+    entry.has_rest = proc->has_rest();
+    entry.frame_size = proc->frame_size();
+    entry.num_free = proc->num_free();
+
+    code_.insert(code_.end(), proc->code(),
+                 proc->code() + proc->code_length());
+    if (!AddDatum(proc->name())) {
+        return false;
+    }
+    for (size_t i = 0; i < consts->length(); ++i) {
+        if (!AddDatum(consts->At(i))) {
+            return false;
+        }
+    }
+
+    indices_[proc] = procedures_.size();
+    procedures_.push_back(entry);
+    return true;
+}
+
+bool Writer::AddDatum(RawObject *datum) {
+    if (datum->IsFixnum()) {
+        int64_t value = ((RawFixnum *)datum)->Unwrap();
+        PutTag(kFixnumDatum);
+        Put(&value, sizeof(value));
+    }
+    else if (datum->IsFlonum()) {
+        double value = ((RawFlonum *)datum)->Unwrap();
+        PutTag(kFlonumDatum);
+        Put(&value, sizeof(value));
+    }
+    else if (datum->IsNil()) {
+        PutTag(kNilDatum);
+    }
+    else if (datum->IsBoolean()) {
+        PutTag(datum->IsTrue() ? kTrueDatum : kFalseDatum);
+    }
+    else if (datum->IsSymbol()) {
+        RawSymbol *symbol = (RawSymbol *)datum;
+        PutTag(kSymbolDatum);
+        PutU32(symbol->length());
+        Put(symbol->Unwrap(), symbol->length());
+    }
+    else if (datum->IsString()) {
+        RawString *str = (RawString *)datum;
+        std::vector<char> chars(str->length() + 1);
+        str->CopyTo(&chars[0]);
+        PutTag(kStringDatum);
+        PutU32(str->length());
+        Put(&chars[0], str->length());
+    }
+    else if (datum->IsPair()) {
+        // Long lists are not written recursively.
+        std::vector<RawObject *> items;
+        while (datum->IsPair()) {
+            items.push_back(((RawPair *)datum)->car());
+            datum = ((RawPair *)datum)->cdr();
+        }
+        PutTag(kListDatum);
+        PutU32(items.size());
+        if (!AddDatum(datum)) {
+            return false;
+        }
+        for (size_t i = items.size(); i > 0; --i) {
+            if (!AddDatum(items[i - 1])) {
+                return false;
+            }
+        }
+    }
+    else if (datum->IsProcedure() &&
+             indices_.count((RawProcedure *)datum)) {
+        PutTag(kProcedureDatum);
+        PutU32(indices_[(RawProcedure *)datum]);
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+bool Writer::WriteFile(const char *path) {
+    Header header;
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.num_opcodes = kLast;
+    header.num_procedures = procedures_.size();
+    header.code_offset = sizeof(Header) +
+        procedures_.size() * sizeof(ProcedureEntry);
+    header.code_length = code_.size();
+    header.consts_offset = header.code_offset +
+        code_.size() * sizeof(CodeWord);
+    header.consts_length = consts_.size();
+
+    // Written aside and renamed, so that a reader never sees half of it.
+    std::string tmp_path = std::string(path) + ".tmp";
+    FILE *fp = fopen(tmp_path.c_str(), "wb");
+    if (!fp) {
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+    if (ok && !procedures_.empty()) {
+        ok = fwrite(&procedures_[0], sizeof(ProcedureEntry),
+                    procedures_.size(), fp) == procedures_.size();
+    }
+    if (ok && !code_.empty()) {
+        ok = fwrite(&code_[0], sizeof(CodeWord), code_.size(), fp) ==
+            code_.size();
+    }
+    if (ok && !consts_.empty()) {
+        ok = fwrite(consts_.data(), 1, consts_.size(), fp) == consts_.size();
+    }
+    ok = fclose(fp) == 0 && ok;
+    if (!ok || rename(tmp_path.c_str(), path) != 0) {
+        remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @class Reader
+ * @brief Reads the data of one procedure, checking the bounds.
+ */
+class Reader {
+public:
+    Reader(const uint8_t *data, size_t length)
+        : pos_(data),
+          end_(data + length),
+          ok_(true) { }
+
+    bool ok() const {
+        return ok_;
+    }
+
+    /**
+     * @brief Read a datum, the procedure table has num_procedures filled
+     * in. Returns nil on errors.
+     */
+    RawObject *ReadDatum(const Handle &procedures, size_t num_procedures);
+
+private:
+    const uint8_t *Get(size_t size) {
+        if (!ok_ || (size_t)(end_ - pos_) < size) {
+            ok_ = false;
+            return NULL;
+        }
+        const uint8_t *data = pos_;
+        pos_ += size;
+        return data;
+    }
+
+    uint32_t GetU32() {
+        uint32_t value = 0;
+        const uint8_t *data = Get(sizeof(value));
+        if (data) {
+            memcpy(&value, data, sizeof(value));
+        }
+        return value;
+    }
+
+    const uint8_t *pos_;
+    const uint8_t *end_;
+    bool ok_;
+};
+
+RawObject *Reader::ReadDatum(const Handle &procedures,
+                             size_t num_procedures) {
+    const uint8_t *tag = Get(1);
+    if (!tag) {
+        return RawNil::Wrap();
+    }
+    switch (*tag) {
+        case kFixnumDatum: {
+            int64_t value = 0;
+            const uint8_t *data = Get(sizeof(value));
+            if (data) {
+                memcpy(&value, data, sizeof(value));
+            }
+            return RawFixnum::Wrap(value);
+        }
+
+        case kFlonumDatum: {
+            double value = 0;
+            const uint8_t *data = Get(sizeof(value));
+            if (data) {
+                memcpy(&value, data, sizeof(value));
+            }
+            return RawFlonum::Wrap(value);
+        }
+
+        case kNilDatum:
+            return RawNil::Wrap();
+
+        case kFalseDatum:
+            return RawBoolean::Wrap(false);
+
+        case kTrueDatum:
+            return RawBoolean::Wrap(true);
+
+        case kSymbolDatum: {
+            uint32_t length = GetU32();
+            const uint8_t *data = Get(length);
+            if (!data) {
+                return RawNil::Wrap();
+            }
+            return ObjSpace::Get().InternSymbol((const char *)data, length);
+        }
+
+        case kStringDatum: {
+            uint32_t length = GetU32();
+            const uint8_t *data = Get(length);
+            if (!data) {
+                return RawNil::Wrap();
+            }
+            return RawString::Wrap((const char *)data, length);
+        }
+
+        case kListDatum: {
+            uint32_t length = GetU32();
+            Handle list = ReadDatum(procedures, num_procedures);
+            for (uint32_t i = 0; i < length && ok_; ++i) {
+                Handle item = ReadDatum(procedures, num_procedures);
+                list = RawPair::Wrap(item, list);
+            }
+            return list.raw();
+        }
+
+        case kProcedureDatum: {
+            uint32_t index = GetU32();
+            if (index >= num_procedures) {
+                ok_ = false;
+                return RawNil::Wrap();
+            }
+            return procedures.AsVector().At(index);
+        }
+
+        default:
+            ok_ = false;
+            return RawNil::Wrap();
+    }
+}
+
+// Whether the operands of an instruction of proc are in range.
+bool AreValidOperands(RawProcedure *proc, OpCode op, CodeWord insn,
+                      intptr_t imm) {
+    intptr_t frame_size = proc->frame_size();
+    intptr_t num_consts = proc->consts()->length();
+    intptr_t a = DecodeA(insn);
+    intptr_t b = DecodeB(insn);
+    switch (op) {
+        case kNop:
+        case kBranch:
+            return true;
+
+        case kLoadConst:
+            return a < frame_size && imm >= 0 && imm < num_consts;
+
+        case kLoadGlobal:
+        case kStoreGlobal: {
+            if (a >= frame_size || imm < 0 || imm >= num_consts) {
+                return false;
+            }
+            // Caches of a snapshot may be resolved already.
+            RawObject *cache = proc->consts()->At(imm);
+            return cache->IsPair() &&
+                GlobalCacheSymbol((RawPair *)cache)->IsSymbol();
+        }
+
+        case kBuildClosure: {
+            if (imm < 0 || imm >= num_consts ||
+                    !proc->consts()->At(imm)->IsProcedure()) {
+                return false;
+            }
+            RawProcedure *child = (RawProcedure *)proc->consts()->At(imm);
+            return a + child->num_free() < frame_size;
+        }
+
+        case kLoadFree:
+            return a < frame_size && b < proc->num_free();
+
+        case kLoadCell:
+        case kMove:
+        case kStoreCell:
+            return a < frame_size && b < frame_size;
+
+        case kCall:
+        case kTailCall:
+            return a + b < frame_size;
+
+        case kCall0:
+        case kCall1:
+        case kCall2:
+        case kCall3:
+            return a + (op - kCall0) < frame_size;
+
+        default:
+            if (IsArithmetic(op)) {
+                return a < frame_size && b < frame_size &&
+                    DecodeC(insn) < frame_size;
+            }
+            // The rest only have R[A], if anything.
+            return a < frame_size;
+    }
+}
+
+}  // namespace
+
+bool IsValidCode(RawProcedure *proc) {
+    const CodeWord *code = proc->code();
+    intptr_t length = proc->code_length();
+    if (proc->arity() < 0 ||
+            proc->frame_size() < 1 + proc->arity() + proc->has_rest()) {
+        return false;
+    }
+
+    std::vector<bool> starts(length, false);
+    for (intptr_t pc = 0; pc < length; ) {
+        starts[pc] = true;
+        if (DecodeOperator(code[pc]) == kWide) {
+            pc += kWideLength;
+        }
+        else {
+            ++pc;
+        }
+    }
+
+    for (intptr_t pc = 0; pc < length; ) {
+        CodeWord insn = code[pc];
+        OpCode op = DecodeOperator(insn);
+        intptr_t imm = DecodeImmediate(insn);
+        intptr_t next = pc + 1;
+        if (op == kWide) {
+            if (pc + kWideLength > length) {
+                return false;
+            }
+            insn = code[pc + 1];
+            op = DecodeOperator(insn);
+            imm = DecodeWideImmediate(code[pc + 2]);
+            next = pc + kWideLength;
+            if (op == kWide || !HasImmediate(UnfusedOpCode(op))) {
+                return false;
+            }
+        }
+        if (op >= kLast ||
+                !AreValidOperands(proc, UnfusedOpCode(op), insn, imm)) {
+            return false;
+        }
+
+        // The second half of a superinstruction is checked on its own,
+        // but it has to be the one that the handler expects.
+        if (op != UnfusedOpCode(op) && (next >= length ||
+                FusedOpCode(UnfusedOpCode(op),
+                            DecodeOperator(code[next])) != op)) {
+            return false;
+        }
+        if (IsBranch(UnfusedOpCode(op)) &&
+                (next + imm < 0 || next + imm >= length ||
+                 !starts[next + imm])) {
+            return false;
+        }
+        pc = next;
+    }
+    return true;
+}
+
+namespace {
+
+RawClosure *LoadMapped(const uint8_t *data, size_t size) {
+    const Header *header = (const Header *)data;
+    if (memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 ||
+            header->version != kVersion ||
+            header->num_opcodes != kLast ||
+            header->num_procedures == 0 ||
+            header->code_offset % sizeof(CodeWord) != 0 ||
+            header->code_offset < sizeof(Header) +
+                (uint64_t)header->num_procedures * sizeof(ProcedureEntry) ||
+            header->consts_offset < header->code_offset +
+                (uint64_t)header->code_length * sizeof(CodeWord) ||
+            header->consts_offset + (uint64_t)header->consts_length > size) {
+        return NULL;
+    }
+
+    const ProcedureEntry *entries =
+        (const ProcedureEntry *)(data + sizeof(Header));
+    const CodeWord *code = (const CodeWord *)(data + header->code_offset);
+    const uint8_t *consts_data = data + header->consts_offset;
+
+    Handle procedures = RawVector::Wrap(header->num_procedures,
+                                        RawNil::Wrap());
+    for (size_t i = 0; i < header->num_procedures; ++i) {
+        const ProcedureEntry &entry = entries[i];
+        if (entry.code_start + (uint64_t)entry.code_length >
+                header->code_length ||
+                entry.consts_start > header->consts_length) {
+            return NULL;
+        }
+
+        Reader reader(consts_data + entry.consts_start,
+                      header->consts_length - entry.consts_start);
+        Handle name = reader.ReadDatum(procedures, i);
+        Handle consts = RawVector::Wrap(entry.num_consts, RawNil::Wrap());
+        for (size_t j = 0; j < entry.num_consts && reader.ok(); ++j) {
+            RawObject *value = reader.ReadDatum(procedures, i);
+            consts.AsVector().Set(j, value);
+        }
+        if (!reader.ok()) {
+            return NULL;
+        }
+
+        // The code stays in the mapping, which is never unmapped.
+        RawProcedure *proc = RawProcedure::Wrap(
+                const_cast<CodeWord *>(code + entry.code_start),
+                entry.code_length, false, consts, name, entry.arity,
+                entry.has_rest, entry.frame_size, entry.num_free);
+        if (!IsValidCode(proc)) {
+            return NULL;
+        }
+        procedures.AsVector().Set(i, proc);
+    }
+
+    Handle toplevel = procedures.AsVector().At(header->num_procedures - 1);
+    return RawClosure::Wrap(toplevel);
+}
+
+bool IsNewer(const struct stat &lhs, const struct stat &rhs) {
+    return lhs.st_mtim.tv_sec != rhs.st_mtim.tv_sec ?
+        lhs.st_mtim.tv_sec > rhs.st_mtim.tv_sec :
+        lhs.st_mtim.tv_nsec > rhs.st_mtim.tv_nsec;
+}
+
+}  // namespace
+
+bool Save(const char *path, const Handle &closure) {
+    Writer writer;
+    return writer.AddProcedure(closure.AsClosure().proc()) &&
+        writer.WriteFile(path);
+}
+
+RawClosure *Load(const char *path, const char *source_path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat image_stat;
+    struct stat source_stat;
+    if (fstat(fd, &image_stat) != 0 ||
+            image_stat.st_size < (off_t)sizeof(Header) ||
+            (source_path && (stat(source_path, &source_stat) != 0 ||
+                             IsNewer(source_stat, image_stat)))) {
+        close(fd);
+        return NULL;
+    }
+
+    size_t size = image_stat.st_size;
+    void *addr = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return NULL;
+    }
+    RawClosure *closure = LoadMapped((const uint8_t *)addr, size);
+    if (!closure) {
+        munmap(addr, size);
+    }
+    return closure;
+}
+
+}  // namespace vm_image
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
@@ -0,0 +1,57 @@
+#ifndef VM_IMAGE_HPP
+#define VM_IMAGE_HPP
+#include "objectmodel.hpp"
+#include "handle.hpp"
+
+namespace sanya {
+
+namespace vm_image {
+
+/**
+ * A compiled image holds the procedures of a program, as returned by
+ * vm_compiler::Compile, so that it can be run again without parsing and
+ * compiling the source.
+ *
+ * The file starts with a header, followed by a table of procedures, the
+ * code of all procedures and their constants. The code is used in place
+ * from a read-only mapping of the file. Constants are rebuilt on the heap
+ * when the image is loaded; global variables are still bound lazily by
+ * the global caches (see vm_insn::NewGlobalCache) on first use.
+ *
+ * Images are only valid on the machine that wrote them, and are rejected
+ * if kVersion or the instruction set has changed since. Every instruction
+ * is checked as the image is loaded, and any register, constant or branch
+ * target that is out of range rejects it as well.
+ */
+const uint32_t kVersion = 1;
+
+/**
+ * @brief Write the compiled closure into path. Returns false on IO
+ * errors or if the closure contains something that can't be saved. The
+ * closure must not have been run yet, since that fills in its global
+ * caches.
+ */
+bool Save(const char *path, const Handle &closure);
+
+/**
+ * @brief Load the image at path. Returns NULL if there is none, if it's
+ * older than source_path (unless that's NULL) or if it's not valid.
+ */
+RawClosure *Load(const char *path, const char *source_path);
+
+/**
+ * @brief Checks every instruction of proc once, so that neither the
+ * interpreter nor vm_jit has to: the registers are in the frame, the
+ * constants and the free variables exist, and branches go to the start
+ * of an instruction. Also used for the procedures of a snapshot (see
+ * snapshot.hpp).
+ */
+bool IsValidCode(RawProcedure *proc);
+
+}  // namespace vm_image
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
+
+#endif /* VM_IMAGE_HPP */
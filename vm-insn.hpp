@@ -1,6 +1,7 @@
 #ifndef VM_INSN_HPP
 #define VM_INSN_HPP
 #include <inttypes.h>
+#include <string.h>
 #include "objectmodel.hpp"
 #include "inlines.hpp"
 
@@ -8,46 +9,114 @@ namespace sanya {
 
 namespace vm_insn {
 
+/**
+ * R[x] is the x-th register of the current frame, R[0] being the closure
+ * that is running. K[x] is the x-th constant of the current procedure and
+ * E[x] is the x-th free variable of the running closure.
+ * Branch offsets are relative to the next instruction.
+ */
 enum OpCode {
     kHalt = 0,
     kNop,
+    kWide,              // Prefix, see CodeWord
 
-    kLoadFixnum,
-    kLoadNil,
-    kLoadBool,
-    kLoadConst,
-    kLoadCell,
-    kLoadGlobal,
-    kBuildClosure,
+    kLoadFixnum,        // A sBx    R[A] = sBx
+    kLoadNil,           // A        R[A] = ()
+    kLoadBool,          // A B      R[A] = B ? #t : #f
+    kLoadConst,         // A Bx     R[A] = K[Bx]
+    kLoadCell,          // A B      R[A] = cell-ref(R[B])
+    kLoadFree,          // A B      R[A] = E[B]
+    kLoadGlobal,        // A Bx     R[A] = global cached in K[Bx]
+    kBuildCell,         // A        R[A] = make-cell(R[A])
+    kBuildClosure,      // A Bx     R[A] = closure(K[Bx], E = R[A+1]...)
 
-    kMove,
-    kStoreCell,
-    kStoreGlobal,
+    kMove,              // A B      R[A] = R[B]
+    kStoreCell,         // A B      cell-set!(R[B], R[A])
+    kStoreGlobal,       // A Bx     global cached in K[Bx] = R[A]
 
-    kBranch,
-    kBranchIfFalse,
-    kCall,
-    kTailCall,
-    kRet,
+    kBranch,            // sBx      pc += sBx
+    kBranchIfFalse,     // A sBx    if R[A] is #f then pc += sBx
+    kBranchIfNotSelf,   // A sBx    if R[A] is not R[0] then pc += sBx
+
+    // Calls use a sliding register window: the callee's R[0] is the
+    // caller's R[A], so arguments R[A+1]... are already in place and the
+    // result is left in R[A].
+    kCall,              // A B      R[A] = R[A](R[A+1], ..., R[A+B])
+    kCall0,             // A        R[A] = R[A]()
+    kCall1,             // A        R[A] = R[A](R[A+1])
+    kCall2,             // A        R[A] = R[A](R[A+1], R[A+2])
+    kCall3,             // A        R[A] = R[A](R[A+1], R[A+2], R[A+3])
+    kTailCall,          // A B      return R[A](R[A+1], ..., R[A+B])
+    kRet,               // A        return R[A]
+
+    // Fixnum fast paths, anything else goes to the natives in vm-prelude.
+    // Once one of those globals is no longer the native, they all call
+    // the globals instead (see ArithmeticName).
+    kAdd,               // A B C    R[A] = R[B] + R[C]
+    kSub,               // A B C    R[A] = R[B] - R[C]
+    kMul,               // A B C    R[A] = R[B] * R[C]
+    kLt,                // A B C    R[A] = R[B] < R[C]
+    kLe,                // A B C    R[A] = R[B] <= R[C]
+    kGt,                // A B C    R[A] = R[B] > R[C]
+    kGe,                // A B C    R[A] = R[B] >= R[C]
+    kNumEq,             // A B C    R[A] = R[B] = R[C]
+
+    // Superinstructions, selected by FusedOpCode. Each one replaces the
+    // opcode of the first instruction of a pair and keeps its operands.
+    // The second instruction is left untouched, so branching to it still
+    // works, and the fused handler executes it and skips over it.
+    kLoadGlobalMove,    // load-global; move
+    kLoadFixnumCall,    // load-fixnum; call0..call3
+    kMoveLoadFixnum,    // move; load-fixnum
+    kMoveMove,          // move; move
+    kMoveBranch,        // move; branch
 
     kLast
 };
 
+/**
+ * Global variables are accessed through a cache in the constant pool,
+ * which is a pair of (symbol . -1) until the first access fills it in
+ * as (entry . version): entry is the (symbol . value) pair from the
+ * global table, which stays the same as long as ObjSpace's global
+ * version does.
+ */
+inline RawPair *NewGlobalCache(const Handle &symbol) {
+    return RawPair::Wrap(symbol, RawFixnum::Wrap(-1));
+}
+
+inline RawObject *GlobalCacheSymbol(RawPair *cache) {
+    RawObject *car = cache->car();
+    return car->IsPair() ? ((RawPair *)car)->car() : car;
+}
+
+/** @brief Number of arguments of the fixed-arity call opcodes */
+const intptr_t kMaxFixedCallArity = 3;
+
+// The compiler's format: packed fixnums that can be kept in a vector on
+// the heap while a procedure is being compiled. Branch offsets are in
+// instructions.
+typedef uint64_t Insn;
 typedef uint16_t Operand;
 typedef int32_t Immediate;
 
 inline RawFixnum *PackRType(OpCode op, Operand a,
                             Operand b = 0, Operand c = 0) {
-    return (((uint16_t)op) << RawObject::kNonHeapTypeShift) |
-        RawObject::kFixnumType | (a << 16) | (b << 32) | (c << 48);
+    return (RawFixnum *)((((Insn)op) << RawObject::kNonHeapTypeShift) |
+        RawObject::kFixnumType | ((Insn)a << 16) | ((Insn)b << 32) |
+        ((Insn)c << 48));
 }
 
 inline RawFixnum *PackIType(OpCode op, Operand a, Immediate bx) {
-    return (((uint16_t)op) << RawObject::kNonHeapTypeShift) |
-        RawObject::kFixnumType | (a << 16) | (bx << 32);
+    return (RawFixnum *)((((Insn)op) << RawObject::kNonHeapTypeShift) |
+        RawObject::kFixnumType | ((Insn)a << 16) | ((Insn)(uint32_t)bx << 32));
+}
+
+inline Insn ToInsn(RawObject *packed) {
+    return (Insn)packed;
 }
 
-inline OpCode UnpackOperator(RawFixnum *insn) {
+inline OpCode UnpackOperator(Insn insn) {
     return (OpCode)((insn & 0xffff) >> RawObject::kNonHeapTypeShift);
 }
 
@@ -64,7 +133,166 @@ inline Operand UnpackOperandC(Insn insn) {
 }
 
 inline Immediate UnpackImmediate(Insn insn) {
-    return (insn >> 32) & 0xffffffffL;
+    return (Immediate)((insn >> 32) & 0xffffffffL);
+}
+
+/**
+ * Compiled code is an array of 32-bit words that doesn't move, and each
+ * instruction is one word: op:8 A:8 B:8 C:8, or op:8 A:8 sBx:16. If the
+ * immediate doesn't fit, the instruction is prefixed with kWide and
+ * followed by a word that holds the immediate, so it takes three words.
+ * Branch offsets are in words. Registers and argument counts have to
+ * fit in a byte.
+ *
+ * The compiler's Insn are turned into words by Walker::Assemble.
+ */
+typedef uint32_t CodeWord;
+
+const intptr_t kMaxOperand = 0xff;
+const intptr_t kMinNarrowImmediate = INT16_MIN;
+const intptr_t kMaxNarrowImmediate = INT16_MAX;
+const intptr_t kWideLength = 3;
+
+inline CodeWord EncodeRType(OpCode op, uint8_t a, uint8_t b = 0,
+                            uint8_t c = 0) {
+    return op | (a << 8) | (b << 16) | ((CodeWord)c << 24);
+}
+
+inline CodeWord EncodeIType(OpCode op, uint8_t a, int16_t sbx) {
+    return op | (a << 8) | ((CodeWord)(uint16_t)sbx << 16);
+}
+
+inline OpCode DecodeOperator(CodeWord insn) {
+    return (OpCode)(insn & 0xff);
+}
+
+inline intptr_t DecodeA(CodeWord insn) {
+    return (insn >> 8) & 0xff;
+}
+
+inline intptr_t DecodeB(CodeWord insn) {
+    return (insn >> 16) & 0xff;
+}
+
+inline intptr_t DecodeC(CodeWord insn) {
+    return insn >> 24;
+}
+
+inline intptr_t DecodeImmediate(CodeWord insn) {
+    return (int16_t)(insn >> 16);
+}
+
+inline intptr_t DecodeWideImmediate(CodeWord ext) {
+    return (int32_t)ext;
+}
+
+inline const char *OpCodeName(OpCode op) {
+    static const char *names[] = {
+        "halt", "nop", "wide",
+        "load-fixnum", "load-nil", "load-bool", "load-const", "load-cell",
+        "load-free", "load-global", "build-cell", "build-closure",
+        "move", "store-cell", "store-global",
+        "branch", "branch-if-false", "branch-if-not-self",
+        "call", "call0", "call1", "call2", "call3", "tail-call", "ret",
+        "add", "sub", "mul", "lt", "le", "gt", "ge", "num-eq",
+        "load-global+move", "load-fixnum+call", "move+load-fixnum",
+        "move+move", "move+branch"
+    };
+    return op < kLast ? names[op] : "?";
+}
+
+inline bool IsArithmetic(OpCode op) {
+    return op >= kAdd && op <= kNumEq;
+}
+
+/** @brief The global of the prelude that an arithmetic opcode stands for */
+inline const char *ArithmeticName(OpCode op) {
+    static const char *names[] = {
+        "+", "-", "*", "<", "<=", ">", ">=", "="
+    };
+    return names[op - kAdd];
+}
+
+/** @brief Whether value is the native that the arithmetic opcode stands for */
+inline bool IsArithmeticNative(OpCode op, RawObject *value) {
+    return value->IsNative() &&
+        strcmp(((RawNative *)value)->name(), ArithmeticName(op)) == 0;
+}
+
+/** @brief kCall0 + n for n <= kMaxFixedCallArity */
+inline OpCode FixedCallOpCode(intptr_t argc) {
+    return (OpCode)(kCall0 + argc);
+}
+
+/** @brief Whether the (unfused) opcode takes an sBx operand */
+inline bool HasImmediate(OpCode op) {
+    switch (op) {
+        case kLoadFixnum:
+        case kLoadConst:
+        case kLoadGlobal:
+        case kBuildClosure:
+        case kStoreGlobal:
+        case kBranch:
+        case kBranchIfFalse:
+        case kBranchIfNotSelf:
+            return true;
+        default:
+            return false;
+    }
+}
+
+inline bool IsBranch(OpCode op) {
+    return op == kBranch || op == kBranchIfFalse || op == kBranchIfNotSelf;
+}
+
+/** @brief Replace the opcode, keeping the operands */
+inline RawFixnum *ReplaceOperator(Insn insn, OpCode op) {
+    return (RawFixnum *)((insn & ~(Insn)0xffff) |
+        ((Insn)op << RawObject::kNonHeapTypeShift) | RawObject::kFixnumType);
+}
+
+/** @brief The opcode of the first half of a superinstruction */
+inline OpCode UnfusedOpCode(OpCode op) {
+    switch (op) {
+        case kLoadGlobalMove:
+            return kLoadGlobal;
+        case kLoadFixnumCall:
+            return kLoadFixnum;
+        case kMoveLoadFixnum:
+        case kMoveMove:
+        case kMoveBranch:
+            return kMove;
+        default:
+            return op;
+    }
+}
+
+/**
+ * @brief The superinstruction for the pair of opcodes, or kNop if there
+ * is none. The pairs were picked from the most frequent ones reported by
+ * Interp::DumpOpcodeProfile.
+ */
+inline OpCode FusedOpCode(OpCode first, OpCode second) {
+    switch (first) {
+        case kLoadGlobal:
+            return second == kMove ? kLoadGlobalMove : kNop;
+        case kLoadFixnum:
+            return second >= kCall0 && second <= kCall3 ? kLoadFixnumCall
+                                                        : kNop;
+        case kMove:
+            switch (second) {
+                case kLoadFixnum:
+                    return kMoveLoadFixnum;
+                case kMove:
+                    return kMoveMove;
+                case kBranch:
+                    return kMoveBranch;
+                default:
+                    return kNop;
+            }
+        default:
+            return kNop;
+    }
 }
 
 }  // namespace vm_insn
@@ -0,0 +1,909 @@
+#include <algorithm>
+#include "vm-interp.hpp"
+#include "vm-insn.hpp"
+#include "vm-prelude.hpp"
+#include "vm-jit.hpp"
+#include "vm-profile.hpp"
+#include "inlines.hpp"
+
+namespace sanya {
+
+namespace vm_interp {
+
+using namespace vm_insn;
+
+__thread Interp *Interp::running_s = NULL;
+
+Interp::Interp()
+    : stack_(RawVector::Wrap(kInitStackSize, RawNil::Wrap())),
+      base_(0),
+      parent_(RawNil::Wrap()),
+      run_queue_head_(RawNil::Wrap()),
+      run_queue_tail_(RawNil::Wrap()),
+      task_(0),
+      last_task_(0),
+      switches_(0),
+      control_(kNoControl),
+      arith_version_(-1),
+      arith_redefined_(false),
+      wait_op_(vm_io::kReadLine),
+      wait_port_(RawNil::Wrap()),
+      wait_arg_(RawNil::Wrap()),
+      wait_events_(0) {
+#ifdef SANYA_OPCODE_PROFILE
+    pair_counts_.resize(kLast * kLast, 0);
+#endif
+}
+
+void Interp::ReserveStack(size_t size) {
+    size_t length = stack_.AsVector().length();
+    if (size <= length) {
+        return;
+    }
+    while (length < size) {
+        length <<= 1;
+    }
+
+    // Don't use the copying Wrap since the old stack may move.
+    Handle new_stack = RawVector::Wrap(length, RawNil::Wrap());
+    RawVector &old_stack = stack_.AsVector();
+    std::copy(&old_stack.At(0), &old_stack.At(0) + old_stack.length(),
+              &new_stack.AsVector().At(0));
+    stack_ = new_stack;
+}
+
+void Interp::PrepareFrame(intptr_t base, intptr_t argc) {
+    RawProcedure *proc = ((RawClosure *)stack_.AsVector().At(base))->proc();
+    intptr_t arity = proc->arity();
+    bool has_rest = proc->has_rest();
+    if (argc < arity || (argc > arity && !has_rest)) {
+        FATAL_ERROR("wrong number of arguments");
+    }
+
+    ReserveStack(base + proc->frame_size());
+    if (has_rest) {
+        Handle rest = RawNil::Wrap();
+        for (intptr_t i = argc; i > arity; --i) {
+            rest = RawPair::Wrap(stack_.AsVector().At(base + i), rest);
+        }
+        stack_.AsVector().At(base + arity + 1) = rest.raw();
+    }
+}
+
+RawObject *Interp::CallNative(RawNative *native, intptr_t argc,
+                              RawObject **argv) {
+    if (native->arity() != RawNative::kVariadic && native->arity() != argc) {
+        fprintf(stderr, "%s: expects %ld arguments, given %ld\n",
+                native->name(), native->arity(), argc);
+        FATAL_ERROR("wrong number of arguments");
+    }
+    return native->Call(argc, argv);
+}
+
+void Interp::ResolveGlobal(RawPair *cache) {
+    Handle cache_h = cache;
+    Handle symbol = GlobalCacheSymbol(cache);
+    RawPair *entry = ObjSpace::Get().LookupGlobal(symbol);
+    cache_h.AsPair().set_car(entry);
+    cache_h.AsPair().set_cdr(
+            RawFixnum::Wrap(ObjSpace::Get().global_version()));
+}
+
+RawObject *Interp::ArithSlowPath(OpCode op, RawObject *lhs, RawObject *rhs) {
+    RawObject *argv[] = { lhs, rhs };
+    switch (op) {
+        case kAdd:
+            return vm_prelude::Add(2, argv);
+        case kSub:
+            return vm_prelude::Sub(2, argv);
+        case kMul:
+            return vm_prelude::Mul(2, argv);
+        case kLt:
+            return vm_prelude::NumLt(2, argv);
+        case kLe:
+            return vm_prelude::NumLe(2, argv);
+        case kGt:
+            return vm_prelude::NumGt(2, argv);
+        case kGe:
+            return vm_prelude::NumGe(2, argv);
+        case kNumEq:
+            return vm_prelude::NumEq(2, argv);
+        default:
+            FATAL_ERROR("not an arithmetic opcode");
+    }
+}
+
+RawPair *Interp::ArithmeticGlobal(OpCode op) {
+    Handle symbol = ObjSpace::Get().InternSymbol(ArithmeticName(op));
+    return ObjSpace::Get().LookupGlobal(symbol);
+}
+
+bool Interp::ArithmeticRedefined() {
+    intptr_t version = ObjSpace::Get().global_version();
+    if (arith_version_ == version) {
+        return arith_redefined_;
+    }
+    arith_version_ = version;
+    arith_redefined_ = false;
+    for (intptr_t i = kAdd; i <= kNumEq; ++i) {
+        if (!IsArithmeticNative((OpCode)i,
+                                ArithmeticGlobal((OpCode)i)->cdr())) {
+            arith_redefined_ = true;
+        }
+    }
+    return arith_redefined_;
+}
+
+void Interp::UnboundGlobal(RawPair *entry) {
+    fprintf(stderr, "unbound variable: %s\n",
+            ((RawSymbol *)entry->car())->Unwrap());
+    FATAL_ERROR("unbound variable");
+}
+
+void Interp::TakeSample(intptr_t base) {
+    RawVector &stack = stack_.AsVector();
+    sample_names_.clear();
+    for (size_t i = 0; i < frames_.size(); ++i) {
+        RawClosure *caller = (RawClosure *)stack.At(frames_[i].base);
+        sample_names_.push_back(caller->proc()->name());
+    }
+    sample_names_.push_back(((RawClosure *)stack.At(base))->proc()->name());
+    vm_profile::Record(&sample_names_[0], sample_names_.size());
+}
+
+bool Interp::RunningProcedure(std::string *name) {
+    if (!running_s) {
+        return false;
+    }
+    RawObject *closure = running_s->stack_.AsVector().At(running_s->base_);
+    RawObject *proc_name = ((RawClosure *)closure)->proc()->name();
+    if (!proc_name->IsSymbol()) {
+        return false;
+    }
+    name->assign(((RawSymbol *)proc_name)->Unwrap(),
+                 ((RawSymbol *)proc_name)->length());
+    return true;
+}
+
+RawObject *Interp::Spawn(intptr_t argc, RawObject **argv) {
+    if (!argv[0]->IsClosure()) {
+        FATAL_ERROR("not applicable");
+    }
+    Handle thunk = argv[0];
+    Handle stack = RawVector::Wrap(kTaskStackSize, RawNil::Wrap());
+    stack.AsVector().At(0) = thunk.raw();
+    Handle nil = RawNil::Wrap();
+    intptr_t task = ++running_s->last_task_;
+    running_s->Enqueue(RawContinuation::Wrap(stack, nil, nil,
+                                             RawContinuation::kStart,
+                                             0, 0, -1, task));
+    return RawFixnum::Wrap(task);
+}
+
+RawObject *Interp::Yield(intptr_t argc, RawObject **argv) {
+    // Unless there's nothing to switch to.
+    if (!running_s->run_queue_head_.raw()->IsNil() ||
+            running_s->poller_.waiting()) {
+        running_s->control_ = kYield;
+    }
+    return RawNil::Wrap();
+}
+
+RawObject *Interp::CallCC(intptr_t argc, RawObject **argv) {
+    if (!argv[0]->IsClosure()) {
+        FATAL_ERROR("not applicable");
+    }
+    running_s->control_ = kCallCC;
+    return argv[0];
+}
+
+void Interp::Wait(vm_io::Op op, const Handle &port, const Handle &arg,
+                  uint32_t events) {
+    running_s->control_ = kWait;
+    running_s->wait_op_ = op;
+    running_s->wait_port_ = port;
+    running_s->wait_arg_ = arg;
+    running_s->wait_events_ = events;
+}
+
+void Interp::PortClosed(int fd) {
+    std::vector<Handle> ready;
+    running_s->poller_.Closed(fd, &ready);
+    running_s->EnqueueReady(&ready);
+}
+
+RawContinuation *Interp::Suspend(intptr_t base, intptr_t pc,
+                                 intptr_t slot) {
+    // The stack is written without the barrier while it's running.
+    Heap::Get().RecordWrites(stack_.raw());
+    Handle frames = RawVector::Wrap(frames_.size() * 2, RawNil::Wrap());
+    for (size_t i = 0; i < frames_.size(); ++i) {
+        frames.AsVector().At(i * 2) = RawFixnum::Wrap(frames_[i].base);
+        frames.AsVector().At(i * 2 + 1) = RawFixnum::Wrap(frames_[i].pc);
+    }
+    return RawContinuation::Wrap(stack_, frames, parent_,
+                                 slot < 0 ? RawContinuation::kReturn
+                                          : RawContinuation::kCall,
+                                 base, pc, slot, task_);
+}
+
+bool Interp::Resume(RawContinuation *k, RawObject *value, intptr_t *base,
+                    intptr_t *pc) {
+    RawContinuation::State state = k->state();
+    if (state == RawContinuation::kResumed) {
+        FATAL_ERROR("continuation resumed twice");
+    }
+    stack_ = k->stack();
+    Heap::Get().RecordWrites(stack_.raw());
+    parent_ = k->parent();
+    task_ = k->task();
+    *base = k->base();
+    *pc = k->pc();
+    frames_.clear();
+    if (state != RawContinuation::kStart) {
+        RawVector *frames = k->frames();
+        for (size_t i = 0; i < frames->length(); i += 2) {
+            frames_.push_back(Frame(
+                    ((RawFixnum *)frames->At(i))->Unwrap(),
+                    ((RawFixnum *)frames->At(i + 1))->Unwrap()));
+        }
+    }
+    intptr_t slot = k->slot();
+    k->MarkResumed();
+
+    switch (state) {
+        case RawContinuation::kStart:
+            PrepareFrame(0, 0);
+            return false;
+        case RawContinuation::kCall:
+            stack_.AsVector().At(slot) = value;
+            return false;
+        default:
+            return true;
+    }
+}
+
+void Interp::CallWithContinuation(RawObject *proc, intptr_t base,
+                                  intptr_t pc, intptr_t slot) {
+    Handle proc_h = proc;
+    Handle k = Suspend(base, pc, slot);
+    stack_ = RawVector::Wrap(kTaskStackSize, RawNil::Wrap());
+    stack_.AsVector().At(0) = proc_h.raw();
+    stack_.AsVector().At(1) = k.raw();
+    frames_.clear();
+    parent_ = k;
+    PrepareFrame(0, 1);
+}
+
+void Interp::CallWithArguments(intptr_t window, intptr_t argc,
+                               intptr_t base, intptr_t pc, intptr_t slot) {
+    Handle k = Suspend(base, pc, slot);
+    Handle caller_stack = stack_;
+    stack_ = RawVector::Wrap(std::max((intptr_t)kTaskStackSize, argc + 1),
+                             RawNil::Wrap());
+    for (intptr_t i = 0; i <= argc; ++i) {
+        stack_.AsVector().At(i) =
+            caller_stack.AsVector().At(base + window + i);
+    }
+    frames_.clear();
+    parent_ = k;
+    PrepareFrame(0, argc);
+}
+
+void Interp::Enqueue(RawContinuation *k) {
+    if (run_queue_head_.raw()->IsNil()) {
+        run_queue_head_ = k;
+    }
+    else {
+        ((RawContinuation *)run_queue_tail_.raw())->set_next(k);
+    }
+    run_queue_tail_ = k;
+}
+
+RawContinuation *Interp::Dequeue() {
+    if (run_queue_head_.raw()->IsNil()) {
+        return NULL;
+    }
+    RawContinuation *k = (RawContinuation *)run_queue_head_.raw();
+    run_queue_head_ = k->next();
+    k->set_next(RawNil::Wrap());
+    if (run_queue_head_.raw()->IsNil()) {
+        run_queue_tail_ = RawNil::Wrap();
+    }
+    return k;
+}
+
+RawContinuation *Interp::NextTask() {
+    if (poller_.waiting()) {
+        std::vector<Handle> ready;
+        if (!run_queue_head_.raw()->IsNil()) {
+            if (++switches_ % kPollInterval == 0) {
+                poller_.Poll(0, &ready);
+            }
+        }
+        else {
+            while (ready.empty() && poller_.waiting()) {
+                poller_.Poll(-1, &ready);
+            }
+        }
+        EnqueueReady(&ready);
+    }
+    return Dequeue();
+}
+
+void Interp::EnqueueReady(std::vector<Handle> *ready) {
+    for (size_t i = 0; i < ready->size(); ++i) {
+        Enqueue((RawContinuation *)(*ready)[i].raw());
+    }
+}
+
+RawObject *Interp::Run(const Handle &closure) {
+    intptr_t base = 0;
+    intptr_t pc = 0;
+    size_t stack_size;
+    RawObject **regs;
+    const CodeWord *code;
+    RawClosure *self;
+    vm_jit::Entry jit;
+    RawObject **consts;
+
+    CodeWord insn;
+    OpCode op;
+    intptr_t imm;
+#ifdef SANYA_OPCODE_PROFILE
+    OpCode prev_op = kNop;
+#endif
+    intptr_t a, argc, slot;
+    RawObject *callee;
+    RawObject *result;
+    Handle main_result = RawNil::Wrap();
+    bool main_done = false;
+    RawPair *cache;
+    RawObject *lhs, *rhs;
+    RawFixnum *fixnum;
+    bool arith_redefined;
+
+    if (!closure.raw()->IsClosure()) {
+        FATAL_ERROR("not applicable");
+    }
+    frames_.clear();
+    stack_.AsVector().At(0) = closure.raw();
+    base_ = 0;
+    parent_ = RawNil::Wrap();
+    task_ = 0;
+    running_s = this;
+    PrepareFrame(base, 0);
+    arith_redefined = ArithmeticRedefined();
+
+    // Point cache at the filled-in global cache K[index].
+#define LOAD_GLOBAL_CACHE(index) \
+    do { \
+        cache = (RawPair *)self->proc()->consts()->At(index); \
+        if (cache->cdr() != \
+                RawFixnum::Wrap(ObjSpace::Get().global_version())) { \
+            ResolveGlobal(cache); \
+            RELOAD(); \
+            cache = (RawPair *)self->proc()->consts()->At(index); \
+        } \
+    } while (0)
+
+    // Refresh the cached raw pointers after allocation or frame change.
+#define RELOAD() \
+    do { \
+        base_ = base; \
+        stack_size = stack_.AsVector().length(); \
+        regs = &stack_.AsVector().At(base); \
+        self = (RawClosure *)regs[0]; \
+        code = self->proc()->code(); \
+        jit = arith_redefined ? NULL : \
+            (vm_jit::Entry)self->proc()->jit_code(); \
+        consts = jit && self->proc()->consts()->length() ? \
+            &self->proc()->consts()->At(0) : NULL; \
+    } while (0)
+
+    // On calls and backward branches, compile the procedure once it's
+    // hot enough, and take the profiler sample that SIGPROF asked for.
+#define COUNT_HOTNESS() \
+    do { \
+        if (!jit && self->proc()->IncreaseHotness() == \
+                vm_jit::kHotnessThreshold && \
+                vm_jit::Compile(self->proc())) { \
+            RELOAD(); \
+        } \
+        if (vm_profile::sample_pending) { \
+            TakeSample(base); \
+        } \
+    } while (0)
+
+    RELOAD();
+
+    while (true) {
+        if (jit) {
+            pc = jit(regs, pc, consts);
+        }
+        insn = code[pc++];
+        op = DecodeOperator(insn);
+        imm = DecodeImmediate(insn);
+    dispatch:
+#ifdef SANYA_OPCODE_PROFILE
+        ++pair_counts_[prev_op * kLast + op];
+        prev_op = op;
+#endif
+        switch (op) {
+        case kHalt:
+            frames_.clear();
+            running_s = NULL;
+            return regs[DecodeA(insn)];
+
+        case kNop:
+            break;
+
+        // The instruction follows, then its immediate.
+        case kWide:
+            insn = code[pc++];
+            op = DecodeOperator(insn);
+            imm = DecodeWideImmediate(code[pc++]);
+            goto dispatch;
+
+        case kLoadFixnum:
+            regs[DecodeA(insn)] = RawFixnum::Wrap(imm);
+            break;
+
+        case kLoadNil:
+            regs[DecodeA(insn)] = RawNil::Wrap();
+            break;
+
+        case kLoadBool:
+            regs[DecodeA(insn)] =
+                RawBoolean::Wrap(DecodeB(insn));
+            break;
+
+        case kLoadConst:
+            regs[DecodeA(insn)] =
+                self->proc()->consts()->At(imm);
+            break;
+
+        case kLoadCell:
+            regs[DecodeA(insn)] =
+                ((RawCell *)regs[DecodeB(insn)])->value();
+            break;
+
+        case kLoadFree:
+            regs[DecodeA(insn)] = self->At(DecodeB(insn));
+            break;
+
+        case kLoadGlobal:
+            LOAD_GLOBAL_CACHE(imm);
+            result = ((RawPair *)cache->car())->cdr();
+            if (result == RawTag::Wrap(RawTag::kUnbound)) {
+                UnboundGlobal((RawPair *)cache->car());
+            }
+            regs[DecodeA(insn)] = result;
+            break;
+
+        case kBuildCell: {
+            a = DecodeA(insn);
+            result = RawCell::Wrap(regs[a]);
+            RELOAD();
+            regs[a] = result;
+            break;
+        }
+
+        case kBuildClosure: {
+            a = DecodeA(insn);
+            Handle proc = self->proc()->consts()->At(imm);
+            RawClosure *new_closure = RawClosure::Wrap(proc);
+            RELOAD();
+            for (intptr_t i = 0; i < proc.AsProcedure().num_free(); ++i) {
+                new_closure->At(i) = regs[a + 1 + i];
+            }
+            regs[a] = new_closure;
+            break;
+        }
+
+        case kMove:
+            regs[DecodeA(insn)] = regs[DecodeB(insn)];
+            break;
+
+        case kStoreCell:
+            ((RawCell *)regs[DecodeB(insn)])->set_value(
+                    regs[DecodeA(insn)]);
+            break;
+
+        case kStoreGlobal:
+            LOAD_GLOBAL_CACHE(imm);
+            ObjSpace::Get().SetGlobal((RawPair *)cache->car(),
+                                      regs[DecodeA(insn)]);
+            if (!arith_redefined && ArithmeticRedefined()) {
+                arith_redefined = true;
+                RELOAD();
+            }
+            break;
+
+        case kBranch:
+            pc += imm;
+            if (imm < 0) {
+                COUNT_HOTNESS();
+            }
+            break;
+
+        case kBranchIfFalse:
+            if (!regs[DecodeA(insn)]->IsTrue()) {
+                pc += imm;
+            }
+            break;
+
+        case kBranchIfNotSelf:
+            if (regs[DecodeA(insn)] != regs[0]) {
+                pc += imm;
+            }
+            break;
+
+        case kCall0:
+        case kCall1:
+        case kCall2:
+        case kCall3: {
+        fixed_call:
+            a = DecodeA(insn);
+            argc = op - kCall0;
+            callee = regs[a];
+
+            // Fast path: exact arity, nothing to check or collect.
+            if (callee->IsClosure()) {
+                RawProcedure *proc = ((RawClosure *)callee)->proc();
+                if (proc->arity() == argc && !proc->has_rest()) {
+                    frames_.push_back(Frame(base, pc));
+                    base += a;
+                    pc = 0;
+                    if (base + proc->frame_size() > (intptr_t)stack_size) {
+                        ReserveStack(base + proc->frame_size());
+                    }
+                    RELOAD();
+                    COUNT_HOTNESS();
+                    break;
+                }
+            }
+            goto call;
+        }
+
+        case kCall:
+            a = DecodeA(insn);
+            argc = DecodeB(insn);
+            callee = regs[a];
+        call:
+            if (callee->IsClosure()) {
+                frames_.push_back(Frame(base, pc));
+                base += a;
+                pc = 0;
+                PrepareFrame(base, argc);
+                RELOAD();
+                COUNT_HOTNESS();
+            }
+            else if (callee->IsNative()) {
+                result = CallNative((RawNative *)callee, argc, regs + a + 1);
+                RELOAD();
+                regs[a] = result;
+                if (control_ != kNoControl) {
+                    slot = base + a;
+                    goto control;
+                }
+            }
+            else if (callee->IsContinuation()) {
+                goto throw_to;
+            }
+            else {
+                FATAL_ERROR("not applicable");
+            }
+            break;
+
+        case kTailCall:
+            a = DecodeA(insn);
+            argc = DecodeB(insn);
+            callee = regs[a];
+            if (callee->IsClosure()) {
+                // Slide the callee and arguments down to reuse this frame.
+                std::copy(regs + a, regs + a + argc + 1, regs);
+                pc = 0;
+                PrepareFrame(base, argc);
+                RELOAD();
+                COUNT_HOTNESS();
+                break;
+            }
+            else if (callee->IsNative()) {
+                result = CallNative((RawNative *)callee, argc, regs + a + 1);
+                RELOAD();
+                if (control_ != kNoControl) {
+                    slot = -1;
+                    goto control;
+                }
+                goto ret;
+            }
+            else if (callee->IsContinuation()) {
+                goto throw_to;
+            }
+            else {
+                FATAL_ERROR("not applicable");
+            }
+
+        // The running task is dropped, unless it's resumed by another
+        // continuation that it made.
+        throw_to:
+            if (argc > 1) {
+                FATAL_ERROR("wrong number of arguments");
+            }
+            result = argc ? regs[a + 1] : RawNil::Wrap();
+            goto resume;
+
+        // A native asked for the running task to be suspended, at pc of
+        // the frame at base, with its value going into slot.
+        control:
+            if (control_ == kYield) {
+                control_ = kNoControl;
+                Enqueue(Suspend(base, pc, slot));
+                goto next_task;
+            }
+            if (control_ == kWait) {
+                control_ = kNoControl;
+                poller_.Wait(Suspend(base, pc, slot), wait_op_, wait_port_,
+                             wait_arg_, wait_events_);
+                wait_port_ = RawNil::Wrap();
+                wait_arg_ = RawNil::Wrap();
+                goto next_task;
+            }
+            control_ = kNoControl;
+            CallWithContinuation(result, base, pc, slot);
+            base = 0;
+            pc = 0;
+            RELOAD();
+            COUNT_HOTNESS();
+            break;
+
+        resume:
+            if (Resume((RawContinuation *)callee, result, &base, &pc)) {
+                RELOAD();
+                goto ret;
+            }
+            RELOAD();
+            break;
+
+        case kRet:
+            result = regs[DecodeA(insn)];
+        ret:
+            if (frames_.empty()) {
+                // Back into the continuation of call/cc,
+                if (!parent_.raw()->IsNil()) {
+                    callee = parent_.raw();
+                    goto resume;
+                }
+
+                // or the task is done.
+                if (task_ == 0) {
+                    main_result = result;
+                    main_done = true;
+                }
+            next_task:
+                callee = NextTask();
+                if (callee) {
+                    result = ((RawContinuation *)callee)->value();
+                    goto resume;
+                }
+                if (!main_done) {
+                    FATAL_ERROR("no task to run");
+                }
+                running_s = NULL;
+                return main_result.raw();
+            }
+            // Our slot 0 is the callee slot of the caller.
+            regs[0] = result;
+            base = frames_.back().base;
+            pc = frames_.back().pc;
+            frames_.pop_back();
+            RELOAD();
+            break;
+
+        case kAdd:
+            lhs = regs[DecodeB(insn)];
+            rhs = regs[DecodeC(insn)];
+            if (!arith_redefined && RawFixnum::BothFixnums(lhs, rhs) &&
+                    RawFixnum::Add((RawFixnum *)lhs, (RawFixnum *)rhs,
+                                   &fixnum)) {
+                regs[DecodeA(insn)] = fixnum;
+                break;
+            }
+            goto arith_slow_path;
+
+        case kSub:
+            lhs = regs[DecodeB(insn)];
+            rhs = regs[DecodeC(insn)];
+            if (!arith_redefined && RawFixnum::BothFixnums(lhs, rhs) &&
+                    RawFixnum::Sub((RawFixnum *)lhs, (RawFixnum *)rhs,
+                                   &fixnum)) {
+                regs[DecodeA(insn)] = fixnum;
+                break;
+            }
+            goto arith_slow_path;
+
+        case kMul:
+            lhs = regs[DecodeB(insn)];
+            rhs = regs[DecodeC(insn)];
+            if (!arith_redefined && RawFixnum::BothFixnums(lhs, rhs) &&
+                    RawFixnum::Mul((RawFixnum *)lhs, (RawFixnum *)rhs,
+                                   &fixnum)) {
+                regs[DecodeA(insn)] = fixnum;
+                break;
+            }
+            goto arith_slow_path;
+
+        // Tagged fixnums compare like their values.
+        case kLt:
+            lhs = regs[DecodeB(insn)];
+            rhs = regs[DecodeC(insn)];
+            if (!arith_redefined && RawFixnum::BothFixnums(lhs, rhs)) {
+                regs[DecodeA(insn)] =
+                    RawBoolean::Wrap((intptr_t)lhs < (intptr_t)rhs);
+                break;
+            }
+            goto arith_slow_path;
+
+        case kLe:
+            lhs = regs[DecodeB(insn)];
+            rhs = regs[DecodeC(insn)];
+            if (!arith_redefined && RawFixnum::BothFixnums(lhs, rhs)) {
+                regs[DecodeA(insn)] =
+                    RawBoolean::Wrap((intptr_t)lhs <= (intptr_t)rhs);
+                break;
+            }
+            goto arith_slow_path;
+
+        case kGt:
+            lhs = regs[DecodeB(insn)];
+            rhs = regs[DecodeC(insn)];
+            if (!arith_redefined && RawFixnum::BothFixnums(lhs, rhs)) {
+                regs[DecodeA(insn)] =
+                    RawBoolean::Wrap((intptr_t)lhs > (intptr_t)rhs);
+                break;
+            }
+            goto arith_slow_path;
+
+        case kGe:
+            lhs = regs[DecodeB(insn)];
+            rhs = regs[DecodeC(insn)];
+            if (!arith_redefined && RawFixnum::BothFixnums(lhs, rhs)) {
+                regs[DecodeA(insn)] =
+                    RawBoolean::Wrap((intptr_t)lhs >= (intptr_t)rhs);
+                break;
+            }
+            goto arith_slow_path;
+
+        case kNumEq:
+            lhs = regs[DecodeB(insn)];
+            rhs = regs[DecodeC(insn)];
+            if (!arith_redefined && RawFixnum::BothFixnums(lhs, rhs)) {
+                regs[DecodeA(insn)] = RawBoolean::Wrap(lhs == rhs);
+                break;
+            }
+            goto arith_slow_path;
+
+        arith_slow_path:
+            if (arith_redefined) {
+                goto arith_call;
+            }
+            result = ArithSlowPath(op, lhs, rhs);
+            RELOAD();
+            regs[DecodeA(insn)] = result;
+            break;
+
+        // The global is called instead, from a window past the top of the
+        // frame, and its value goes into R[A].
+        arith_call:
+            a = self->proc()->frame_size();
+            argc = 2;
+            slot = base + DecodeA(insn);
+            ReserveStack(base + a + argc + 1);
+            cache = ArithmeticGlobal(op);
+            RELOAD();
+            callee = cache->cdr();
+            regs[a] = callee;
+            regs[a + 1] = regs[DecodeB(insn)];
+            regs[a + 2] = regs[DecodeC(insn)];
+            if (callee->IsClosure()) {
+                CallWithArguments(a, argc, base, pc, slot);
+                base = 0;
+                pc = 0;
+                RELOAD();
+                COUNT_HOTNESS();
+            }
+            else if (callee->IsNative()) {
+                result = CallNative((RawNative *)callee, argc, regs + a + 1);
+                RELOAD();
+                regs[DecodeA(insn)] = result;
+                if (control_ != kNoControl) {
+                    goto control;
+                }
+            }
+            else if (callee == RawTag::Wrap(RawTag::kUnbound)) {
+                UnboundGlobal(cache);
+            }
+            else {
+                FATAL_ERROR("not applicable");
+            }
+            break;
+
+        // The second instruction of a superinstruction is never fused
+        // itself, so its opcode is the plain one.
+        case kLoadGlobalMove:
+            LOAD_GLOBAL_CACHE(imm);
+            result = ((RawPair *)cache->car())->cdr();
+            if (result == RawTag::Wrap(RawTag::kUnbound)) {
+                UnboundGlobal((RawPair *)cache->car());
+            }
+            regs[DecodeA(insn)] = result;
+            insn = code[pc++];
+            regs[DecodeA(insn)] = regs[DecodeB(insn)];
+            break;
+
+        case kLoadFixnumCall:
+            regs[DecodeA(insn)] = RawFixnum::Wrap(imm);
+            insn = code[pc++];
+            op = DecodeOperator(insn);
+            goto fixed_call;
+
+        case kMoveLoadFixnum:
+            regs[DecodeA(insn)] = regs[DecodeB(insn)];
+            insn = code[pc++];
+            regs[DecodeA(insn)] = RawFixnum::Wrap(DecodeImmediate(insn));
+            break;
+
+        case kMoveMove:
+            regs[DecodeA(insn)] = regs[DecodeB(insn)];
+            insn = code[pc++];
+            regs[DecodeA(insn)] = regs[DecodeB(insn)];
+            break;
+
+        case kMoveBranch:
+            regs[DecodeA(insn)] = regs[DecodeB(insn)];
+            insn = code[pc++];
+            imm = DecodeImmediate(insn);
+            pc += imm;
+            if (imm < 0) {
+                COUNT_HOTNESS();
+            }
+            break;
+
+        default:
+            FATAL_ERROR("unknown opcode");
+        }
+    }
+
+#undef COUNT_HOTNESS
+#undef LOAD_GLOBAL_CACHE
+#undef RELOAD
+}
+
+#ifdef SANYA_OPCODE_PROFILE
+void Interp::DumpOpcodeProfile(FILE *stream, size_t top) const {
+    std::vector<std::pair<uint64_t, size_t> > pairs;
+    uint64_t total = 0;
+    for (size_t i = 0; i < pair_counts_.size(); ++i) {
+        total += pair_counts_[i];
+        if (pair_counts_[i]) {
+            pairs.push_back(std::make_pair(pair_counts_[i], i));
+        }
+    }
+    std::sort(pairs.rbegin(), pairs.rend());
+
+    fprintf(stream, ";; %" PRIu64 " dispatches\n", total);
+    for (size_t i = 0; i < pairs.size() && i < top; ++i) {
+        fprintf(stream, "%12" PRIu64 " %5.1f%%  %s, %s\n", pairs[i].first,
+                100.0 * pairs[i].first / total,
+                OpCodeName((OpCode)(pairs[i].second / kLast)),
+                OpCodeName((OpCode)(pairs[i].second % kLast)));
+    }
+}
+#endif
+
+}  // namespace vm_interp
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
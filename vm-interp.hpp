@@ -0,0 +1,213 @@
+#ifndef VM_INTERP_HPP
+#define VM_INTERP_HPP
+#include <string>
+#include <vector>
+#include "objectmodel.hpp"
+#include "handle.hpp"
+#include "vm-insn.hpp"
+#include "vm-io.hpp"
+
+namespace sanya {
+
+namespace vm_interp {
+
+/**
+ * @class Interp
+ * @brief Runs compiled closures (see vm-insn.hpp for the instruction set).
+ *
+ * Every frame is a window into one value stack that lives on the heap,
+ * starting with the running closure at slot 0, followed by the arguments
+ * and then the locals. A call slides the window up to the callee slot of
+ * the caller, so calling does not copy the arguments, and a tail call
+ * moves the callee and its arguments down to the current window so
+ * the frame is reused in place. Nothing is allocated per call unless
+ * the stack needs to grow or there are rest arguments.
+ *
+ * Raw pointers into the stack are invalidated by any allocation. The
+ * stack is written without the write barrier, so the heap is told when
+ * one starts or stops running (see Heap::RecordWrites).
+ *
+ * Tasks are green threads that each have a stack of their own, which
+ * starts small and grows as the first one does. A task that yields is
+ * suspended into a one-shot continuation (see RawContinuation) that takes
+ * over its stack, so switching copies only the (base, pc) of its frames,
+ * and waits in the run queue. call/cc suspends the running task in the
+ * same way, and calls the procedure on a new stack, which returns into
+ * the continuation once the procedure returns.
+ *
+ * Tasks that wait on ports are kept by a vm_io::Poller, which is polled
+ * every kPollInterval switches, and waited on once the run queue is
+ * empty.
+ *
+ * The arithmetic instructions assume that their globals are the natives
+ * of the prelude. Once one is redefined, which changes the global version
+ * (see ObjSpace::SetGlobal), they call the globals instead, and the
+ * jit'ed code, which doesn't check, is no longer entered.
+ */
+class Interp {
+public:
+    static const size_t kInitStackSize = 256;
+    static const size_t kTaskStackSize = 16;
+    static const uint64_t kPollInterval = 64;
+
+    Interp();
+
+    /**
+     * @brief Call a closure with no arguments and return its result,
+     * once every task that it spawned is done as well.
+     */
+    RawObject *Run(const Handle &closure);
+
+    /** @brief (spawn thunk), queue a new task and return its number. */
+    static RawObject *Spawn(intptr_t argc, RawObject **argv);
+
+    /** @brief (yield), let the tasks in the run queue go first. */
+    static RawObject *Yield(intptr_t argc, RawObject **argv);
+
+    /**
+     * @brief (call/cc proc), call proc with the continuation of the call,
+     * which may be resumed once. proc must be a closure.
+     */
+    static RawObject *CallCC(intptr_t argc, RawObject **argv);
+
+    /**
+     * @brief For the natives of vm_io: suspend the running task once the
+     * native returns, until the poller has done op.
+     */
+    static void Wait(vm_io::Op op, const Handle &port, const Handle &arg,
+                     uint32_t events);
+
+    /** @brief Wake the tasks that wait on fd, which was closed. */
+    static void PortClosed(int fd);
+
+    /**
+     * @brief The name of the procedure that is running, for the
+     * allocation profile (see allocprofile.hpp).
+     */
+    static bool RunningProcedure(std::string *name);
+
+#ifdef SANYA_OPCODE_PROFILE
+    /**
+     * @brief Print the most frequently dispatched pairs of adjacent
+     * opcodes, as candidates for superinstructions.
+     */
+    void DumpOpcodeProfile(FILE *stream, size_t top = 20) const;
+#endif
+
+protected:
+    struct Frame {
+        Frame(intptr_t base, intptr_t pc)
+            : base(base),
+              pc(pc) { }
+
+        intptr_t base;  // Of the caller's window
+        intptr_t pc;    // To return to
+    };
+
+    // Set by the natives that switch stacks, and done by Run once they
+    // return.
+    enum Control {
+        kNoControl,
+        kYield,
+        kCallCC,
+        kWait
+    };
+
+    // Make sure that stack slots [0, size) are usable.
+    void ReserveStack(size_t size);
+
+    // Check the number of arguments of the closure at slot base, collect
+    // the rest arguments into a list and reserve the stack for the frame.
+    void PrepareFrame(intptr_t base, intptr_t argc);
+
+    // Check the number of arguments and call it.
+    RawObject *CallNative(RawNative *native, intptr_t argc, RawObject **argv);
+
+    // Arithmetic instructions on anything other than fixnums, or that
+    // overflow.
+    RawObject *ArithSlowPath(vm_insn::OpCode op, RawObject *lhs,
+                             RawObject *rhs);
+
+    // The entry of the global that an arithmetic instruction stands for,
+    // and whether one of them is no longer the native, which is checked
+    // again only if the global version has changed.
+    RawPair *ArithmeticGlobal(vm_insn::OpCode op);
+    bool ArithmeticRedefined();
+
+    // Fill in the cache of a global access site, may allocate.
+    void ResolveGlobal(RawPair *cache);
+    void UnboundGlobal(RawPair *entry);
+
+    // Record the procedures on the stack for vm_profile, the running
+    // one is at base.
+    void TakeSample(intptr_t base);
+
+    // Suspend the running task at pc of the frame at base, to be resumed
+    // by storing the value into slot, or returning it if slot is -1.
+    RawContinuation *Suspend(intptr_t base, intptr_t pc, intptr_t slot);
+
+    // Take over the stack and the frames of k. Returns true if the value
+    // is to be returned from the frame at *base.
+    bool Resume(RawContinuation *k, RawObject *value, intptr_t *base,
+                intptr_t *pc);
+
+    // Suspend the running task as Suspend does, and call proc with it on
+    // a new stack, at base 0.
+    void CallWithContinuation(RawObject *proc, intptr_t base, intptr_t pc,
+                              intptr_t slot);
+
+    // Likewise for the closure at slot window of the frame at base, which
+    // is called with the argc arguments that follow it.
+    void CallWithArguments(intptr_t window, intptr_t argc, intptr_t base,
+                           intptr_t pc, intptr_t slot);
+
+    void Enqueue(RawContinuation *k);
+
+    // Returns NULL if the run queue is empty.
+    RawContinuation *Dequeue();
+
+    // Dequeue, after letting in the tasks that are done waiting. Returns
+    // NULL if no task is left.
+    RawContinuation *NextTask();
+    void EnqueueReady(std::vector<Handle> *ready);
+
+    // Of the calling thread.
+    static __thread Interp *running_s;
+
+    Handle stack_;
+    std::vector<Frame> frames_;
+    std::vector<RawObject *> sample_names_;
+    intptr_t base_;     // Of the running frame, kept by Run
+
+    Handle parent_;     // The continuation the bottom frame returns into
+    Handle run_queue_head_;
+    Handle run_queue_tail_;
+    intptr_t task_;     // The running one, 0 is the one that Run started
+    intptr_t last_task_;
+    uint64_t switches_;
+    Control control_;
+
+    // What ArithmeticRedefined found, as of arith_version_.
+    intptr_t arith_version_;
+    bool arith_redefined_;
+
+    // What kWait waits for.
+    vm_io::Op wait_op_;
+    Handle wait_port_;
+    Handle wait_arg_;
+    uint32_t wait_events_;
+    vm_io::Poller poller_;
+
+#ifdef SANYA_OPCODE_PROFILE
+    // [previous * kLast + current]
+    std::vector<uint64_t> pair_counts_;
+#endif
+};
+
+}  // namespace vm_interp
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
+
+#endif /* VM_INTERP_HPP */
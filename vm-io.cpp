@@ -0,0 +1,498 @@
+#include <algorithm>
+#include <cerrno>
+#include <string>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "vm-io.hpp"
+#include "vm-interp.hpp"
+#include "inlines.hpp"
+
+namespace sanya {
+
+namespace vm_io {
+
+namespace {
+
+enum Status {
+    kOk,
+    kWouldBlock,
+    kEnd
+};
+
+// Read more into the input buffer, which is compacted first. kOk if
+// anything was read or the buffer is full.
+Status Fill(RawPort *port) {
+    char *buffer = port->in_buffer();
+    size_t start = port->in_start();
+    size_t end = port->in_end();
+    if (start > 0) {
+        memmove(buffer, buffer + start, end - start);
+        end -= start;
+        port->set_in_start(0);
+        port->set_in_end(end);
+    }
+    if (end == RawPort::kBufferSize) {
+        return kOk;
+    }
+    while (true) {
+        ssize_t count = read(port->fd(), buffer + end,
+                             RawPort::kBufferSize - end);
+        if (count > 0) {
+            port->set_in_end(end + count);
+            return kOk;
+        }
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return kWouldBlock;
+        }
+        // Errors such as a reset connection end the input as well.
+        port->set_eof(true);
+        return kEnd;
+    }
+}
+
+// Write out the output buffer, kOk once it's empty. The output is
+// dropped if the peer is gone.
+Status Drain(RawPort *port) {
+    char *buffer = port->out_buffer();
+    while (port->out_end()) {
+        size_t end = port->out_end();
+        ssize_t count = send(port->fd(), buffer, end, MSG_NOSIGNAL);
+        if (count >= 0) {
+            memmove(buffer, buffer + count, end - count);
+            port->set_out_end(end - count);
+            continue;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return kWouldBlock;
+        }
+        port->set_out_end(0);
+        return kEnd;
+    }
+    return kOk;
+}
+
+RawObject *DoReadLine(const Handle &port_h, uint32_t *events) {
+    while (true) {
+        RawPort *port = &port_h.AsPort();
+        char *buffer = port->in_buffer();
+        size_t start = port->in_start();
+        size_t end = port->in_end();
+        char *newline = (char *)memchr(buffer + start, '\n', end - start);
+        if (newline || (end > start && (port->eof() ||
+                (start == 0 && end == RawPort::kBufferSize)))) {
+            size_t length = newline ? newline - (buffer + start)
+                                    : end - start;
+            port->set_in_start(start + length + (newline ? 1 : 0));
+
+            // Copied out first, the port may move.
+            std::string line(buffer + start, length);
+            return RawString::Wrap(line.data(), line.size());
+        }
+        if (port->eof()) {
+            return RawTag::Wrap(RawTag::kEof);
+        }
+        if (Fill(port) == kWouldBlock) {
+            *events = EPOLLIN;
+            return NULL;
+        }
+    }
+}
+
+RawObject *DoReadString(const Handle &port_h, size_t limit,
+                        uint32_t *events) {
+    while (true) {
+        RawPort *port = &port_h.AsPort();
+        size_t start = port->in_start();
+        size_t end = port->in_end();
+        if (end > start) {
+            size_t length = std::min(limit, end - start);
+            port->set_in_start(start + length);
+            std::string chars(port->in_buffer() + start, length);
+            return RawString::Wrap(chars.data(), chars.size());
+        }
+        if (port->eof()) {
+            return RawTag::Wrap(RawTag::kEof);
+        }
+        if (Fill(port) == kWouldBlock) {
+            *events = EPOLLIN;
+            return NULL;
+        }
+    }
+}
+
+RawObject *DoWriteString(const Handle &port_h, Handle *str,
+                         uint32_t *events) {
+    while (true) {
+        size_t length = str->AsString().length();
+        RawPort *port = &port_h.AsPort();
+        size_t end = port->out_end();
+        if (end == RawPort::kBufferSize) {
+            if (Drain(port) == kWouldBlock) {
+                *events = EPOLLOUT;
+                return NULL;
+            }
+            continue;
+        }
+        size_t count = std::min(length, RawPort::kBufferSize - end);
+        str->AsString().CopyRange(port->out_buffer() + end, 0, count);
+        port->set_out_end(end + count);
+        if (count == length) {
+            return RawNil::Wrap();
+        }
+        *str = RawString::Substring(*str, count, length);
+    }
+}
+
+RawObject *DoAccept(const Handle &port_h, uint32_t *events) {
+    while (true) {
+        int fd = accept4(port_h.AsPort().fd(), NULL, NULL,
+                         SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd >= 0) {
+            // Writes are buffered by the port already.
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            return RawPort::Wrap(fd, RawPort::kStream);
+        }
+        if (errno == EINTR || errno == ECONNABORTED) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            *events = EPOLLIN;
+            return NULL;
+        }
+        return RawBoolean::Wrap(false);
+    }
+}
+
+void Close(RawPort *port) {
+    close(port->fd());
+    port->set_fd(-1);
+}
+
+RawPort *PortArg(RawObject *o, const char *who, RawPort::Kind kind) {
+    if (!o->IsPort()) {
+        fprintf(stderr, "%s: not a port: ", who);
+        o->Write(stderr);
+        fprintf(stderr, "\n");
+        FATAL_ERROR("wrong type of argument");
+    }
+    RawPort *port = (RawPort *)o;
+    if (port->fd() < 0) {
+        fprintf(stderr, "%s: closed port\n", who);
+        FATAL_ERROR("port is closed");
+    }
+    if (port->kind() != kind) {
+        fprintf(stderr, "%s: wrong kind of port\n", who);
+        FATAL_ERROR("wrong type of argument");
+    }
+    return port;
+}
+
+// Try op, or have the running task wait for the port.
+RawObject *Perform(Op op, const Handle &port, const Handle &arg) {
+    Handle arg_h = arg;
+    uint32_t events = 0;
+    int fd = port.AsPort().fd();
+    RawObject *result = Try(op, port, &arg_h, &events);
+    if (!result) {
+        vm_interp::Interp::Wait(op, port, arg_h, events);
+        return RawNil::Wrap();
+    }
+    if (port.AsPort().fd() < 0) {
+        vm_interp::Interp::PortClosed(fd);
+    }
+    return result;
+}
+
+int NewSocket() {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd >= 0) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    return fd;
+}
+
+}  // namespace
+
+RawObject *Try(Op op, const Handle &port, Handle *arg, uint32_t *events) {
+    switch (op) {
+        case kReadLine:
+            return DoReadLine(port, events);
+        case kReadString:
+            return DoReadString(port, ((RawFixnum *)arg->raw())->Unwrap(),
+                                events);
+        case kWriteString:
+            return DoWriteString(port, arg, events);
+        case kFlush:
+        case kClose:
+            if (port.AsPort().kind() == RawPort::kStream &&
+                    Drain(&port.AsPort()) == kWouldBlock) {
+                *events = EPOLLOUT;
+                return NULL;
+            }
+            if (op == kClose) {
+                Close(&port.AsPort());
+            }
+            return RawNil::Wrap();
+        case kAccept:
+            return DoAccept(port, events);
+        case kConnect: {
+            int error = 0;
+            socklen_t length = sizeof(error);
+            getsockopt(port.AsPort().fd(), SOL_SOCKET, SO_ERROR, &error,
+                       &length);
+            if (error) {
+                Close(&port.AsPort());
+                return RawBoolean::Wrap(false);
+            }
+            return port.raw();
+        }
+        default:
+            FATAL_ERROR("unknown port operation");
+    }
+}
+
+Poller::Poller()
+    : epoll_fd_(epoll_create1(EPOLL_CLOEXEC)),
+      waiting_(0) {
+    if (epoll_fd_ < 0) {
+        FATAL_ERROR("can't create the epoll instance");
+    }
+}
+
+Poller::~Poller() {
+    close(epoll_fd_);
+}
+
+void Poller::Wait(RawContinuation *k, Op op, const Handle &port,
+                  const Handle &arg, uint32_t events) {
+    Handle k_h = k;
+    int fd = port.AsPort().fd();
+    std::map<int, Entry>::iterator it = entries_.find(fd);
+    if (it == entries_.end()) {
+        epoll_event event;
+        event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        event.data.fd = fd;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+            FATAL_ERROR("can't add the port to epoll");
+        }
+        it = entries_.insert(std::make_pair(fd, Entry())).first;
+    }
+
+    Waiter *waiter = events == EPOLLIN ? &it->second.reader
+                                       : &it->second.writer;
+    if (!waiter->k.raw()->IsNil()) {
+        FATAL_ERROR("another task waits on the port");
+    }
+    waiter->k = k_h;
+    waiter->port = port;
+    waiter->arg = arg;
+    waiter->op = op;
+    ++waiting_;
+}
+
+void Poller::Poll(int timeout, std::vector<Handle> *ready) {
+    epoll_event events[kMaxEvents];
+    int count = epoll_wait(epoll_fd_, events, kMaxEvents, timeout);
+    if (count < 0) {
+        // Such as SIGPROF from the profiler.
+        if (errno == EINTR) {
+            return;
+        }
+        FATAL_ERROR("epoll_wait failed");
+    }
+
+    for (int i = 0; i < count; ++i) {
+        int fd = events[i].data.fd;
+        if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+            std::map<int, Entry>::iterator it = entries_.find(fd);
+            if (it != entries_.end()) {
+                Retry(fd, &it->second.reader, ready);
+            }
+        }
+        // The reader may have closed it.
+        if (events[i].events & (EPOLLOUT | EPOLLHUP | EPOLLERR)) {
+            std::map<int, Entry>::iterator it = entries_.find(fd);
+            if (it != entries_.end()) {
+                Retry(fd, &it->second.writer, ready);
+            }
+        }
+    }
+}
+
+void Poller::Closed(int fd, std::vector<Handle> *ready) {
+    std::map<int, Entry>::iterator it = entries_.find(fd);
+    if (it == entries_.end()) {
+        return;
+    }
+    Wake(&it->second.reader, RawTag::Wrap(RawTag::kEof), ready);
+    Wake(&it->second.writer, RawTag::Wrap(RawTag::kEof), ready);
+    entries_.erase(it);
+}
+
+void Poller::Retry(int fd, Waiter *waiter, std::vector<Handle> *ready) {
+    if (waiter->k.raw()->IsNil()) {
+        return;
+    }
+    Handle port = waiter->port;
+    uint32_t events = 0;
+    RawObject *result = Try(waiter->op, port, &waiter->arg, &events);
+    if (!result) {
+        return;
+    }
+    Wake(waiter, result, ready);
+    if (port.AsPort().fd() < 0) {
+        Closed(fd, ready);
+    }
+}
+
+void Poller::Wake(Waiter *waiter, RawObject *value,
+                  std::vector<Handle> *ready) {
+    if (waiter->k.raw()->IsNil()) {
+        return;
+    }
+    ((RawContinuation *)waiter->k.raw())->set_value(value);
+    ready->push_back(waiter->k);
+    waiter->k = RawNil::Wrap();
+    waiter->port = RawNil::Wrap();
+    waiter->arg = RawNil::Wrap();
+    --waiting_;
+}
+
+RawObject *TcpListen(intptr_t argc, RawObject **argv) {
+    if (!argv[0]->IsFixnum()) {
+        FATAL_ERROR("wrong type of argument");
+    }
+    int fd = NewSocket();
+    if (fd < 0) {
+        return RawBoolean::Wrap(false);
+    }
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(((RawFixnum *)argv[0])->Unwrap());
+    if (bind(fd, (sockaddr *)&addr, sizeof(addr)) < 0 ||
+            listen(fd, SOMAXCONN) < 0) {
+        close(fd);
+        return RawBoolean::Wrap(false);
+    }
+    return RawPort::Wrap(fd, RawPort::kListener);
+}
+
+RawObject *TcpAccept(intptr_t argc, RawObject **argv) {
+    PortArg(argv[0], "tcp-accept", RawPort::kListener);
+    Handle port = argv[0];
+    return Perform(kAccept, port, RawNil::Wrap());
+}
+
+RawObject *TcpConnect(intptr_t argc, RawObject **argv) {
+    if (!argv[0]->IsString() || !argv[1]->IsFixnum()) {
+        FATAL_ERROR("wrong type of argument");
+    }
+    intptr_t port_number = ((RawFixnum *)argv[1])->Unwrap();
+    Handle host_h = argv[0];
+    std::string host(RawString::Chars(host_h),
+                     host_h.AsString().length());
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port_number);
+    if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+        return RawBoolean::Wrap(false);
+    }
+    int fd = NewSocket();
+    if (fd < 0) {
+        return RawBoolean::Wrap(false);
+    }
+    if (connect(fd, (sockaddr *)&addr, sizeof(addr)) == 0) {
+        return RawPort::Wrap(fd, RawPort::kStream);
+    }
+    if (errno != EINPROGRESS) {
+        close(fd);
+        return RawBoolean::Wrap(false);
+    }
+
+    // Connected once it's writable.
+    Handle port = RawPort::Wrap(fd, RawPort::kStream);
+    Handle nil = RawNil::Wrap();
+    vm_interp::Interp::Wait(kConnect, port, nil, EPOLLOUT);
+    return RawNil::Wrap();
+}
+
+RawObject *ReadLine(intptr_t argc, RawObject **argv) {
+    PortArg(argv[0], "read-line", RawPort::kStream);
+    Handle port = argv[0];
+    return Perform(kReadLine, port, RawNil::Wrap());
+}
+
+RawObject *ReadString(intptr_t argc, RawObject **argv) {
+    if (!argv[0]->IsFixnum() || ((RawFixnum *)argv[0])->Unwrap() <= 0) {
+        FATAL_ERROR("wrong type of argument");
+    }
+    PortArg(argv[1], "read-string", RawPort::kStream);
+    Handle port = argv[1];
+    return Perform(kReadString, port, argv[0]);
+}
+
+RawObject *WriteString(intptr_t argc, RawObject **argv) {
+    if (!argv[0]->IsString()) {
+        FATAL_ERROR("wrong type of argument");
+    }
+    PortArg(argv[1], "write-string", RawPort::kStream);
+    Handle port = argv[1];
+    return Perform(kWriteString, port, argv[0]);
+}
+
+RawObject *FlushOutputPort(intptr_t argc, RawObject **argv) {
+    PortArg(argv[0], "flush-output-port", RawPort::kStream);
+    Handle port = argv[0];
+    return Perform(kFlush, port, RawNil::Wrap());
+}
+
+RawObject *ClosePort(intptr_t argc, RawObject **argv) {
+    // Of either kind, and closing twice is fine.
+    if (argv[0]->IsPort()) {
+        if (((RawPort *)argv[0])->fd() < 0) {
+            return RawNil::Wrap();
+        }
+        Handle port = argv[0];
+        return Perform(kClose, port, RawNil::Wrap());
+    }
+    PortArg(argv[0], "close-port", RawPort::kStream);
+    return RawNil::Wrap();
+}
+
+RawObject *PortP(intptr_t argc, RawObject **argv) {
+    return RawBoolean::Wrap(argv[0]->IsPort());
+}
+
+RawObject *EofObject(intptr_t argc, RawObject **argv) {
+    return RawTag::Wrap(RawTag::kEof);
+}
+
+RawObject *EofObjectP(intptr_t argc, RawObject **argv) {
+    return RawBoolean::Wrap(argv[0] == RawTag::Wrap(RawTag::kEof));
+}
+
+}  // namespace vm_io
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
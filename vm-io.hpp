@@ -0,0 +1,137 @@
+#ifndef VM_IO_HPP
+#define VM_IO_HPP
+#include <map>
+#include <vector>
+#include <stdint.h>
+#include "objectmodel.hpp"
+
+namespace sanya {
+
+/**
+ * @brief Non-blocking ports (see RawPort) for the tasks of the
+ * interpreter (see vm-interp.hpp).
+ *
+ * A task that does something on a port that isn't ready is suspended
+ * until epoll says it's ready, so while it waits the other tasks run, and
+ * the interpreter only blocks in epoll_wait once none of them can. The
+ * natives are:
+ *
+ * - (tcp-listen port-number), a listening port on every address, or #f.
+ * - (tcp-accept listener), the port of the next connection, or #f.
+ * - (tcp-connect "a.b.c.d" port-number), a port, or #f.
+ * - (read-line port), without the newline. Longer lines than
+ *   RawPort::kBufferSize are split.
+ * - (read-string k port), of 1 to k characters, as soon as there are any.
+ * - (write-string string port), which is buffered until the buffer is
+ *   full, or (flush-output-port port).
+ * - (close-port port), which flushes first. The tasks that wait on it
+ *   get the eof object.
+ * - (port? obj), (eof-object) and (eof-object? obj).
+ *
+ * Reading after the end of the input gives the eof object.
+ */
+namespace vm_io {
+
+/** @brief What a task waits to do on a port. */
+enum Op {
+    kReadLine,
+    kReadString,    // arg is the most characters to read
+    kWriteString,   // arg is what's left to write
+    kFlush,
+    kClose,
+    kAccept,
+    kConnect        // Only once the port is writable
+};
+
+/**
+ * @brief Do op on port. Returns the result, or NULL if it has to wait for
+ * the port to be ready for *events (EPOLLIN or EPOLLOUT) first, in which
+ * case *arg is what's left to do.
+ */
+RawObject *Try(Op op, const Handle &port, Handle *arg, uint32_t *events);
+
+/**
+ * @class Poller
+ * @brief The continuations of the tasks that wait on ports, at most one
+ * reader and one writer per port.
+ *
+ * Ports are added to epoll as edge-triggered once something waits on
+ * them, and stay until they are closed. Since a task waits only after
+ * Try ran into EAGAIN, no edge is missed.
+ */
+class Poller {
+public:
+    Poller();
+    ~Poller();
+
+    /** @brief If any task waits. */
+    bool waiting() const { return waiting_ > 0; }
+
+    /** @brief k waits to do op once port is ready for events. */
+    void Wait(RawContinuation *k, Op op, const Handle &port,
+              const Handle &arg, uint32_t events);
+
+    /**
+     * @brief Wait for up to timeout milliseconds, or until a port is
+     * ready if -1, and try the ops again. The continuations of those
+     * that are done get the result as their value (see
+     * RawContinuation::value), and are appended to ready.
+     */
+    void Poll(int timeout, std::vector<Handle> *ready);
+
+    /**
+     * @brief fd was closed, the continuations that waited on it get the
+     * eof object and are appended to ready.
+     */
+    void Closed(int fd, std::vector<Handle> *ready);
+
+private:
+    static const int kMaxEvents = 256;
+
+    struct Waiter {
+        Waiter()
+            : k(RawNil::Wrap()),
+              port(RawNil::Wrap()),
+              arg(RawNil::Wrap()),
+              op(kReadLine) { }
+
+        Handle k;       // nil unless waiting
+        Handle port;
+        Handle arg;
+        Op op;
+    };
+
+    struct Entry {
+        Waiter reader;
+        Waiter writer;
+    };
+
+    // Try the op of waiter again, and append it to ready if it's done.
+    void Retry(int fd, Waiter *waiter, std::vector<Handle> *ready);
+    void Wake(Waiter *waiter, RawObject *value, std::vector<Handle> *ready);
+
+    int epoll_fd_;
+    size_t waiting_;
+    std::map<int, Entry> entries_;
+};
+
+// The natives, see above.
+RawObject *TcpListen(intptr_t argc, RawObject **argv);
+RawObject *TcpAccept(intptr_t argc, RawObject **argv);
+RawObject *TcpConnect(intptr_t argc, RawObject **argv);
+RawObject *ReadLine(intptr_t argc, RawObject **argv);
+RawObject *ReadString(intptr_t argc, RawObject **argv);
+RawObject *WriteString(intptr_t argc, RawObject **argv);
+RawObject *FlushOutputPort(intptr_t argc, RawObject **argv);
+RawObject *ClosePort(intptr_t argc, RawObject **argv);
+RawObject *PortP(intptr_t argc, RawObject **argv);
+RawObject *EofObject(intptr_t argc, RawObject **argv);
+RawObject *EofObjectP(intptr_t argc, RawObject **argv);
+
+}  // namespace vm_io
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
+
+#endif /* VM_IO_HPP */
@@ -0,0 +1,590 @@
+#include <algorithm>
+#include <vector>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "vm-jit.hpp"
+#include "vm-insn.hpp"
+#include "vm-perf.hpp"
+#include "inlines.hpp"
+
+namespace sanya {
+
+namespace vm_jit {
+
+CodeArena::CodeArena()
+    : top_(NULL),
+      end_(NULL) { }
+
+CodeArena::~CodeArena() {
+    for (size_t i = 0; i < chunks_.size(); ++i) {
+        munmap(chunks_[i].first, chunks_[i].second);
+    }
+}
+
+uint8_t *CodeArena::Allocate(size_t size) {
+    size = (size + kAlignment - 1) / kAlignment * kAlignment;
+    if (size > (size_t)(end_ - top_)) {
+        // The rest of the current chunk is left unused.
+        size_t page_size = sysconf(_SC_PAGESIZE);
+        size_t chunk_size = std::max(kChunkSize,
+                (size + page_size - 1) / page_size * page_size);
+        void *addr = mmap(NULL, chunk_size, PROT_READ | PROT_EXEC,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (addr == MAP_FAILED) {
+            return NULL;
+        }
+        chunks_.push_back(std::make_pair((uint8_t *)addr, chunk_size));
+        top_ = (uint8_t *)addr;
+        end_ = top_ + chunk_size;
+    }
+    if (!SetProtection(top_, size, PROT_READ | PROT_WRITE)) {
+        return NULL;
+    }
+    uint8_t *code = top_;
+    top_ += size;
+    return code;
+}
+
+bool CodeArena::Protect(uint8_t *code, size_t size) {
+    return SetProtection(code, size, PROT_READ | PROT_EXEC);
+}
+
+bool CodeArena::SetProtection(uint8_t *start, size_t size, int prot) {
+    // The code of the other procedures that shares the first and the last
+    // page isn't running while one is being compiled.
+    uintptr_t page_size = sysconf(_SC_PAGESIZE);
+    uintptr_t first = (uintptr_t)start / page_size * page_size;
+    uintptr_t last = ((uintptr_t)start + size + page_size - 1) /
+        page_size * page_size;
+    return mprotect((void *)first, last - first, prot) == 0;
+}
+
+#if defined(__x86_64__)
+
+using namespace vm_insn;
+
+namespace {
+
+enum Register {
+    kRax = 0, kRcx, kRdx, kRbx, kRsp, kRbp, kRsi, kRdi,
+    kR8, kR9, kR10, kR11, kR12, kR13, kR14, kR15
+};
+
+enum Condition {
+    kOverflow = 0x0,
+    kEqual = 0x4,
+    kNotEqual = 0x5,
+    kLess = 0xc,
+    kGreaterEqual = 0xd,
+    kLessEqual = 0xe,
+    kGreater = 0xf
+};
+
+// The arguments of Entry.
+const Register kRegs = kRdi;
+const Register kPc = kRsi;
+const Register kConsts = kRdx;
+
+/**
+ * @class Assembler
+ * @brief Emits the few x86-64 instructions that the templates need.
+ *
+ * Only 64-bit operations on registers and [base + disp32] operands,
+ * where base is never rsp or r12 (which would need a SIB byte).
+ */
+class Assembler {
+public:
+    size_t offset() const {
+        return code_.size();
+    }
+
+    std::vector<uint8_t> &code() {
+        return code_;
+    }
+
+    void MovRegMem(Register dst, Register base, int32_t disp) {
+        Rex(dst, base);
+        Byte(0x8b);
+        ModRmDisp32(dst, base, disp);
+    }
+
+    void MovMemReg(Register base, int32_t disp, Register src) {
+        Rex(src, base);
+        Byte(0x89);
+        ModRmDisp32(src, base, disp);
+    }
+
+    void MovRegImm64(Register dst, intptr_t imm) {
+        Rex(kRax, dst);
+        Byte(0xb8 + (dst & 7));
+        Int64(imm);
+    }
+
+    // The upper half of rax is cleared.
+    void MovEaxImm32(int32_t imm) {
+        Byte(0xb8);
+        Int32(imm);
+    }
+
+    void MovRegReg(Register dst, Register src) {
+        Alu(0x89, dst, src);
+    }
+
+    void AddRegReg(Register dst, Register src) {
+        Alu(0x01, dst, src);
+    }
+
+    void SubRegReg(Register dst, Register src) {
+        Alu(0x29, dst, src);
+    }
+
+    void OrRegReg(Register dst, Register src) {
+        Alu(0x09, dst, src);
+    }
+
+    void CmpRegReg(Register lhs, Register rhs) {
+        Alu(0x39, lhs, rhs);
+    }
+
+    void ImulRegReg(Register dst, Register src) {
+        Rex(dst, src);
+        Byte(0x0f);
+        Byte(0xaf);
+        ModRmReg(dst, src);
+    }
+
+    void OrRegImm8(Register dst, int8_t imm) {
+        Group1Imm8(1, dst, imm);
+    }
+
+    void SubRegImm8(Register dst, int8_t imm) {
+        Group1Imm8(5, dst, imm);
+    }
+
+    void CmpMemImm8(Register base, int32_t disp, int8_t imm) {
+        Rex(kRax, base);
+        Byte(0x83);
+        ModRmDisp32((Register)7, base, disp);
+        Byte(imm);
+    }
+
+    void TestRegImm32(Register dst, int32_t imm) {
+        Rex(kRax, dst);
+        Byte(0xf7);
+        ModRmReg((Register)0, dst);
+        Int32(imm);
+    }
+
+    void ShlRegImm8(Register dst, uint8_t imm) {
+        Rex(kRax, dst);
+        Byte(0xc1);
+        ModRmReg((Register)4, dst);
+        Byte(imm);
+    }
+
+    void SarRegImm8(Register dst, uint8_t imm) {
+        Rex(kRax, dst);
+        Byte(0xc1);
+        ModRmReg((Register)7, dst);
+        Byte(imm);
+    }
+
+    // dst = cond ? 1 : 0
+    void SetccMovzx(Condition cond, Register dst) {
+        Byte(0x40 | ((dst >> 3) & 1));
+        Byte(0x0f);
+        Byte(0x90 + cond);
+        ModRmReg((Register)0, dst);
+        Byte(0x40 | (((dst >> 3) & 1) << 2) | ((dst >> 3) & 1));
+        Byte(0x0f);
+        Byte(0xb6);
+        ModRmReg(dst, dst);
+    }
+
+    // Returns the position of the rel32 to be patched.
+    size_t Jcc(Condition cond) {
+        Byte(0x0f);
+        Byte(0x80 + cond);
+        Int32(0);
+        return offset() - 4;
+    }
+
+    size_t Jmp() {
+        Byte(0xe9);
+        Int32(0);
+        return offset() - 4;
+    }
+
+    // jmp [table + pc * 8], with table at a rip-relative position.
+    size_t JmpTable(Register index) {
+        Byte(0x48);
+        Byte(0x8d);
+        Byte(0x05);  // lea rax, [rip + disp32]
+        Int32(0);
+        size_t fixup = offset() - 4;
+        Byte(0xff);
+        Byte(0x24);
+        Byte(0xc0 | ((index & 7) << 3));  // [rax + index * 8]
+        return fixup;
+    }
+
+    void Ret() {
+        Byte(0xc3);
+    }
+
+    void PushReg(Register src) {
+        if (src >= kR8) {
+            Byte(0x41);
+        }
+        Byte(0x50 + (src & 7));
+    }
+
+    void PopReg(Register dst) {
+        if (dst >= kR8) {
+            Byte(0x41);
+        }
+        Byte(0x58 + (dst & 7));
+    }
+
+    void PatchRel32(size_t at, size_t target) {
+        int32_t rel = target - (at + 4);
+        memcpy(&code_[at], &rel, sizeof(rel));
+    }
+
+    void Align(size_t alignment) {
+        while (offset() % alignment) {
+            Byte(0xcc);
+        }
+    }
+
+    void Int64(int64_t value) {
+        uint8_t *bytes = (uint8_t *)&value;
+        code_.insert(code_.end(), bytes, bytes + sizeof(value));
+    }
+
+private:
+    void Byte(uint8_t b) {
+        code_.push_back(b);
+    }
+
+    void Int32(int32_t value) {
+        uint8_t *bytes = (uint8_t *)&value;
+        code_.insert(code_.end(), bytes, bytes + sizeof(value));
+    }
+
+    // REX.W with the high bits of the reg and rm fields.
+    void Rex(Register reg, Register rm) {
+        Byte(0x48 | (((reg >> 3) & 1) << 2) | ((rm >> 3) & 1));
+    }
+
+    void ModRmReg(Register reg, Register rm) {
+        Byte(0xc0 | ((reg & 7) << 3) | (rm & 7));
+    }
+
+    void ModRmDisp32(Register reg, Register base, int32_t disp) {
+        Byte(0x80 | ((reg & 7) << 3) | (base & 7));
+        Int32(disp);
+    }
+
+    // op r/m64, r64
+    void Alu(uint8_t op, Register dst, Register src) {
+        Rex(src, dst);
+        Byte(op);
+        ModRmReg(src, dst);
+    }
+
+    void Group1Imm8(int ext, Register dst, int8_t imm) {
+        Rex(kRax, dst);
+        Byte(0x83);
+        ModRmReg((Register)ext, dst);
+        Byte(imm);
+    }
+
+    std::vector<uint8_t> code_;
+};
+
+int32_t Slot(intptr_t index) {
+    return index * sizeof(RawObject *);
+}
+
+/**
+ * @class Translator
+ * @brief Stitches the templates for a procedure together.
+ */
+class Translator {
+public:
+    explicit Translator(RawProcedure *proc)
+        : proc_(proc),
+          labels_(proc->code_length() + 1) { }
+
+    /** @brief Returns the code, and the size of its instructions. */
+    void *Translate(size_t *code_size);
+
+private:
+    struct Fixup {
+        Fixup(size_t at, intptr_t pc)
+            : at(at),
+              pc(pc) { }
+
+        size_t at;
+        intptr_t pc;
+    };
+
+    // The instruction at pc, and the one after it at next. imm is the
+    // decoded immediate, wide or not.
+    void TranslateInsn(intptr_t pc, intptr_t next, CodeWord insn,
+                       intptr_t imm);
+
+    // Exit to the interpreter at pc.
+    void Exit(intptr_t pc);
+
+    // Jump to the exit at pc if the condition holds.
+    void ExitIf(Condition cond, intptr_t pc);
+
+    // Load R[B] to rax and R[C] to rcx, and exit if any is not a fixnum.
+    // Leaves R[C] - 1 in r9.
+    void LoadFixnumOperands(intptr_t pc, CodeWord insn);
+
+    void Arithmetic(intptr_t pc, CodeWord insn, OpCode op);
+    void Compare(intptr_t pc, CodeWord insn, Condition cond);
+
+    RawProcedure *proc_;
+    Assembler masm_;
+    std::vector<size_t> labels_;
+    std::vector<Fixup> branches_;
+    std::vector<Fixup> exits_;
+};
+
+void *Translator::Translate(size_t *code_size) {
+    // A frame, so that profilers that follow the frame pointers still
+    // see the interpreter that called us.
+    masm_.PushReg(kRbp);
+    masm_.MovRegReg(kRbp, kRsp);
+    size_t table_fixup = masm_.JmpTable(kPc);
+
+    const CodeWord *insns = proc_->code();
+    intptr_t length = proc_->code_length();
+    for (intptr_t pc = 0; pc < length; ) {
+        labels_[pc] = masm_.offset();
+        if (DecodeOperator(insns[pc]) == kWide) {
+            // Never entered in the middle, but the table needs something.
+            labels_[pc + 1] = labels_[pc + 2] = labels_[pc];
+            TranslateInsn(pc, pc + kWideLength, insns[pc + 1],
+                          DecodeWideImmediate(insns[pc + 2]));
+            pc += kWideLength;
+        }
+        else {
+            TranslateInsn(pc, pc + 1, insns[pc], DecodeImmediate(insns[pc]));
+            ++pc;
+        }
+    }
+    // Falling off the end never happens, but exit anyway.
+    labels_[length] = masm_.offset();
+    Exit(length);
+
+    for (size_t i = 0; i < branches_.size(); ++i) {
+        masm_.PatchRel32(branches_[i].at, labels_[branches_[i].pc]);
+    }
+    for (size_t i = 0; i < exits_.size(); ++i) {
+        masm_.PatchRel32(exits_[i].at, masm_.offset());
+        Exit(exits_[i].pc);
+    }
+
+    // The entry table, filled in with absolute addresses below.
+    *code_size = masm_.offset();
+    masm_.Align(sizeof(void *));
+    size_t table = masm_.offset();
+    masm_.PatchRel32(table_fixup, table);
+    for (intptr_t pc = 0; pc <= length; ++pc) {
+        masm_.Int64(0);
+    }
+
+    std::vector<uint8_t> &code = masm_.code();
+    CodeArena &arena = Isolate::Current()->code_arena();
+    uint8_t *base = arena.Allocate(code.size());
+    if (!base) {
+        return NULL;
+    }
+    memcpy(base, &code[0], code.size());
+    for (intptr_t pc = 0; pc <= length; ++pc) {
+        uint8_t *target = base + labels_[pc];
+        memcpy(base + table + pc * sizeof(void *), &target, sizeof(target));
+    }
+    if (!arena.Protect(base, code.size())) {
+        return NULL;
+    }
+    return base;
+}
+
+void Translator::TranslateInsn(intptr_t pc, intptr_t next, CodeWord insn,
+                               intptr_t imm) {
+    intptr_t a = DecodeA(insn);
+
+    // The second half of a superinstruction is translated on its own.
+    switch (UnfusedOpCode(DecodeOperator(insn))) {
+        case kNop:
+            break;
+
+        case kLoadFixnum:
+            masm_.MovRegImm64(kRax, (intptr_t)RawFixnum::Wrap(imm));
+            masm_.MovMemReg(kRegs, Slot(a), kRax);
+            break;
+
+        case kLoadNil:
+            masm_.MovRegImm64(kRax, (intptr_t)RawNil::Wrap());
+            masm_.MovMemReg(kRegs, Slot(a), kRax);
+            break;
+
+        case kLoadBool:
+            masm_.MovRegImm64(kRax,
+                    (intptr_t)RawBoolean::Wrap(DecodeB(insn)));
+            masm_.MovMemReg(kRegs, Slot(a), kRax);
+            break;
+
+        case kLoadConst:
+            masm_.MovRegMem(kRax, kConsts, Slot(imm));
+            masm_.MovMemReg(kRegs, Slot(a), kRax);
+            break;
+
+        case kMove:
+            masm_.MovRegMem(kRax, kRegs, Slot(DecodeB(insn)));
+            masm_.MovMemReg(kRegs, Slot(a), kRax);
+            break;
+
+        case kBranch:
+            branches_.push_back(Fixup(masm_.Jmp(), next + imm));
+            break;
+
+        case kBranchIfFalse:
+            masm_.CmpMemImm8(kRegs, Slot(a),
+                             (intptr_t)RawBoolean::Wrap(false));
+            branches_.push_back(Fixup(masm_.Jcc(kEqual), next + imm));
+            break;
+
+        case kBranchIfNotSelf:
+            masm_.MovRegMem(kRax, kRegs, Slot(a));
+            masm_.MovRegMem(kRcx, kRegs, Slot(0));
+            masm_.CmpRegReg(kRax, kRcx);
+            branches_.push_back(Fixup(masm_.Jcc(kNotEqual), next + imm));
+            break;
+
+        case kAdd:
+        case kSub:
+        case kMul:
+            Arithmetic(pc, insn, DecodeOperator(insn));
+            break;
+
+        case kLt:
+            Compare(pc, insn, kLess);
+            break;
+
+        case kLe:
+            Compare(pc, insn, kLessEqual);
+            break;
+
+        case kGt:
+            Compare(pc, insn, kGreater);
+            break;
+
+        case kGe:
+            Compare(pc, insn, kGreaterEqual);
+            break;
+
+        case kNumEq:
+            Compare(pc, insn, kEqual);
+            break;
+
+        default:
+            Exit(pc);
+            break;
+    }
+}
+
+void Translator::Exit(intptr_t pc) {
+    masm_.PopReg(kRbp);
+    masm_.MovEaxImm32(pc);
+    masm_.Ret();
+}
+
+void Translator::ExitIf(Condition cond, intptr_t pc) {
+    exits_.push_back(Fixup(masm_.Jcc(cond), pc));
+}
+
+void Translator::LoadFixnumOperands(intptr_t pc, CodeWord insn) {
+    masm_.MovRegMem(kRax, kRegs, Slot(DecodeB(insn)));
+    masm_.MovRegMem(kRcx, kRegs, Slot(DecodeC(insn)));
+
+    // See RawFixnum::BothFixnums.
+    masm_.MovRegReg(kR9, kRcx);
+    masm_.SubRegImm8(kR9, RawObject::kFixnumType);
+    masm_.MovRegReg(kR8, kRax);
+    masm_.SubRegImm8(kR8, RawObject::kFixnumType);
+    masm_.OrRegReg(kR8, kR9);
+    masm_.TestRegImm32(kR8, RawObject::kNonHeapTypeMask);
+    ExitIf(kNotEqual, pc);
+}
+
+// See RawFixnum::Add, Sub and Mul.
+void Translator::Arithmetic(intptr_t pc, CodeWord insn, OpCode op) {
+    LoadFixnumOperands(pc, insn);
+    switch (op) {
+        case kAdd:
+            masm_.MovRegReg(kR8, kRax);
+            masm_.AddRegReg(kR8, kR9);
+            ExitIf(kOverflow, pc);
+            break;
+
+        case kSub:
+            masm_.MovRegReg(kR8, kRax);
+            masm_.SubRegReg(kR8, kR9);
+            ExitIf(kOverflow, pc);
+            break;
+
+        default:
+            masm_.MovRegReg(kR8, kRax);
+            masm_.SubRegImm8(kR8, RawObject::kFixnumType);
+            masm_.SarRegImm8(kRcx, RawObject::kNonHeapTypeShift);
+            masm_.ImulRegReg(kR8, kRcx);
+            ExitIf(kOverflow, pc);
+            masm_.OrRegImm8(kR8, RawObject::kFixnumType);
+            break;
+    }
+    masm_.MovMemReg(kRegs, Slot(DecodeA(insn)), kR8);
+}
+
+void Translator::Compare(intptr_t pc, CodeWord insn, Condition cond) {
+    LoadFixnumOperands(pc, insn);
+    masm_.CmpRegReg(kRax, kRcx);
+    masm_.SetccMovzx(cond, kR8);
+    masm_.ShlRegImm8(kR8, RawObject::kNonHeapTypeShift);
+    masm_.OrRegImm8(kR8, RawObject::kBooleanType);
+    masm_.MovMemReg(kRegs, Slot(DecodeA(insn)), kR8);
+}
+
+}  // namespace
+
+bool Compile(RawProcedure *proc) {
+    Translator translator(proc);
+    size_t code_size;
+    void *code = translator.Translate(&code_size);
+    if (!code) {
+        return false;
+    }
+    proc->set_jit_code(code);
+    vm_perf::CodeLoaded(proc->name(), code, code_size);
+    return true;
+}
+
+#else  // !defined(__x86_64__)
+
+bool Compile(RawProcedure *proc) {
+    return false;
+}
+
+#endif
+
+}  // namespace vm_jit
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
@@ -0,0 +1,70 @@
+#ifndef VM_JIT_HPP
+#define VM_JIT_HPP
+#include <vector>
+#include "objectmodel.hpp"
+
+namespace sanya {
+
+namespace vm_jit {
+
+/**
+ * @brief Machine code of a procedure.
+ *
+ * It runs on the interpreter's register window, starting from the
+ * instruction at pc, and returns the pc of the first instruction that
+ * it doesn't handle: calls, returns, anything that allocates and the
+ * slow paths of arithmetics. The interpreter executes that one and then
+ * enters the code again, so the two can switch at any instruction.
+ */
+typedef intptr_t (*Entry)(RawObject **regs, intptr_t pc,
+                          RawObject **consts);
+
+/** @brief Procedures are compiled once they are this hot. */
+const intptr_t kHotnessThreshold = 1000;
+
+/**
+ * @class CodeArena
+ * @brief Where the code of an isolate's procedures goes (see
+ * Isolate::code_arena), bump allocated from chunks of pages so that
+ * procedures share pages. The chunks are executable and only writable
+ * while code is copied in, and are unmapped with the isolate.
+ */
+class CodeArena {
+public:
+    CodeArena();
+    ~CodeArena();
+
+    /**
+     * @brief Room for size bytes of code, which is writable until
+     * Protect is called on it, or NULL if no memory is left.
+     */
+    uint8_t *Allocate(size_t size);
+
+    /** @brief Make the code from Allocate executable. */
+    bool Protect(uint8_t *code, size_t size);
+
+private:
+    static const size_t kChunkSize = 256 * 1024;
+    static const size_t kAlignment = 16;
+
+    // Change the protection of the pages that [start, start + size) is in.
+    bool SetProtection(uint8_t *start, size_t size, int prot);
+
+    std::vector<std::pair<uint8_t *, size_t> > chunks_;
+    uint8_t *top_;
+    uint8_t *end_;
+};
+
+/**
+ * @brief Compile the procedure and set its jit_code. Returns false if
+ * the platform is not supported.
+ */
+bool Compile(RawProcedure *proc);
+
+}  // namespace vm_jit
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
+
+#endif /* VM_JIT_HPP */
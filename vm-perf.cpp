@@ -0,0 +1,185 @@
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "vm-perf.hpp"
+#include "inlines.hpp"
+
+namespace sanya {
+
+namespace vm_perf {
+
+namespace {
+
+// See tools/perf/Documentation/jitdump-specification.txt in Linux.
+const uint32_t kJitdumpMagic = 0x4a695444;
+const uint32_t kJitdumpVersion = 1;
+const uint32_t kElfMachX86_64 = 62;
+
+enum RecordType {
+    kCodeLoad = 0,
+    kCodeClose = 3
+};
+
+struct JitdumpHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t total_size;
+    uint32_t elf_mach;
+    uint32_t pad1;
+    uint32_t pid;
+    uint64_t timestamp;
+    uint64_t flags;
+};
+
+struct RecordHeader {
+    uint32_t id;
+    uint32_t total_size;    // With the header
+    uint64_t timestamp;
+};
+
+// Followed by the name with its NUL, and then the code.
+struct CodeLoadRecord {
+    RecordHeader header;
+    uint32_t pid;
+    uint32_t tid;
+    uint64_t vma;
+    uint64_t code_addr;
+    uint64_t code_size;
+    uint64_t code_index;
+};
+
+// Isolates compile on their own threads.
+pthread_mutex_t mutex_s = PTHREAD_MUTEX_INITIALIZER;
+
+FILE *perf_map_s = NULL;
+FILE *jitdump_s = NULL;
+void *jitdump_marker_s = NULL;
+uint64_t code_index_s = 0;
+
+uint64_t Timestamp() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+bool OpenJitdump(const char *dir) {
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/jit-%d.dump", dir, (int)getpid());
+    int fd = open(path, O_CREAT | O_TRUNC | O_RDWR, 0666);
+    if (fd < 0) {
+        perror(path);
+        return false;
+    }
+    // perf finds the file through this executable mapping of it.
+    jitdump_marker_s = mmap(NULL, sysconf(_SC_PAGESIZE),
+                            PROT_READ | PROT_EXEC, MAP_PRIVATE, fd, 0);
+    if (jitdump_marker_s == MAP_FAILED) {
+        perror(path);
+        jitdump_marker_s = NULL;
+        close(fd);
+        return false;
+    }
+    jitdump_s = fdopen(fd, "w");
+
+    JitdumpHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = kJitdumpMagic;
+    header.version = kJitdumpVersion;
+    header.total_size = sizeof(header);
+    header.elf_mach = kElfMachX86_64;
+    header.pid = getpid();
+    header.timestamp = Timestamp();
+    fwrite(&header, sizeof(header), 1, jitdump_s);
+    fflush(jitdump_s);
+    return true;
+}
+
+}  // namespace
+
+bool Start(bool perf_map, const char *jitdump_dir) {
+    if (perf_map && !perf_map_s) {
+        char path[64];
+        snprintf(path, sizeof(path), "/tmp/perf-%d.map", (int)getpid());
+        perf_map_s = fopen(path, "w");
+        if (!perf_map_s) {
+            perror(path);
+            return false;
+        }
+    }
+    if (jitdump_dir && !jitdump_s && !OpenJitdump(jitdump_dir)) {
+        return false;
+    }
+    return true;
+}
+
+void CodeLoaded(RawObject *name, const void *code, size_t size) {
+    if (!perf_map_s && !jitdump_s) {
+        return;
+    }
+    std::string text = "scheme:";
+    if (name->IsSymbol()) {
+        text.append(((RawSymbol *)name)->Unwrap(),
+                    ((RawSymbol *)name)->length());
+    }
+    else {
+        text.append("?");
+    }
+
+    // Written right away, the process may not exit normally.
+    pthread_mutex_lock(&mutex_s);
+    if (perf_map_s) {
+        fprintf(perf_map_s, "%lx %zx %s\n", (unsigned long)code, size,
+                text.c_str());
+        fflush(perf_map_s);
+    }
+    if (jitdump_s) {
+        CodeLoadRecord record;
+        memset(&record, 0, sizeof(record));
+        record.header.id = kCodeLoad;
+        record.header.total_size = sizeof(record) + text.size() + 1 + size;
+        record.header.timestamp = Timestamp();
+        record.pid = getpid();
+        record.tid = syscall(SYS_gettid);
+        record.vma = (uintptr_t)code;
+        record.code_addr = (uintptr_t)code;
+        record.code_size = size;
+        record.code_index = code_index_s++;
+        fwrite(&record, sizeof(record), 1, jitdump_s);
+        fwrite(text.c_str(), text.size() + 1, 1, jitdump_s);
+        fwrite(code, size, 1, jitdump_s);
+        fflush(jitdump_s);
+    }
+    pthread_mutex_unlock(&mutex_s);
+}
+
+void Stop() {
+    pthread_mutex_lock(&mutex_s);
+    if (perf_map_s) {
+        fclose(perf_map_s);
+        perf_map_s = NULL;
+    }
+    if (jitdump_s) {
+        RecordHeader record;
+        record.id = kCodeClose;
+        record.total_size = sizeof(record);
+        record.timestamp = Timestamp();
+        fwrite(&record, sizeof(record), 1, jitdump_s);
+        fclose(jitdump_s);
+        jitdump_s = NULL;
+        munmap(jitdump_marker_s, sysconf(_SC_PAGESIZE));
+        jitdump_marker_s = NULL;
+    }
+    pthread_mutex_unlock(&mutex_s);
+}
+
+}  // namespace vm_perf
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
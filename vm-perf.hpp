@@ -0,0 +1,42 @@
+#ifndef VM_PERF_HPP
+#define VM_PERF_HPP
+#include <cstddef>
+#include "objectmodel.hpp"
+
+namespace sanya {
+
+/**
+ * @brief Tells perf about the code that the jit generates.
+ *
+ * The perf map, /tmp/perf-<pid>.map, is read by perf report as is. The
+ * jitdump, <dir>/jit-<pid>.dump, also has the code itself, and is merged
+ * into the profile with perf inject --jit, which needs perf record -k 1
+ * since its timestamps are from CLOCK_MONOTONIC.
+ *
+ * Procedures are named "scheme:<name>". The interpreter and the jit'ed
+ * code keep frame pointers, so perf record -g can unwind through them.
+ */
+namespace vm_perf {
+
+/**
+ * @brief Start writing the perf map if perf_map, and the jitdump into
+ * jitdump_dir unless it's NULL. Returns false on IO errors.
+ */
+bool Start(bool perf_map, const char *jitdump_dir);
+
+/**
+ * @brief Record the code of a procedure named name (a symbol), does
+ * nothing unless started.
+ */
+void CodeLoaded(RawObject *name, const void *code, size_t size);
+
+/** @brief Close the files. */
+void Stop();
+
+}  // namespace vm_perf
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
+
+#endif /* VM_PERF_HPP */
@@ -0,0 +1,617 @@
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "vm-prelude.hpp"
+#include "vm-interp.hpp"
+#include "vm-io.hpp"
+#include "inlines.hpp"
+
+namespace sanya {
+
+namespace vm_prelude {
+
+namespace {
+
+using vm_interp::Interp;
+
+intptr_t FixnumArg(RawObject *o, const char *who) {
+    if (!o->IsFixnum()) {
+        fprintf(stderr, "%s: not a fixnum: ", who);
+        o->Write(stderr);
+        fprintf(stderr, "\n");
+        FATAL_ERROR("wrong type of argument");
+    }
+    return ((RawFixnum *)o)->Unwrap();
+}
+
+double FlonumArg(RawObject *o, const char *who) {
+    if (o->IsFlonum()) {
+        return ((RawFlonum *)o)->Unwrap();
+    }
+    if (!o->IsFixnum()) {
+        fprintf(stderr, "%s: not a number: ", who);
+        o->Write(stderr);
+        fprintf(stderr, "\n");
+        FATAL_ERROR("wrong type of argument");
+    }
+    return ((RawFixnum *)o)->Unwrap();
+}
+
+RawPair *PairArg(RawObject *o, const char *who) {
+    if (!o->IsPair()) {
+        fprintf(stderr, "%s: not a pair: ", who);
+        o->Write(stderr);
+        fprintf(stderr, "\n");
+        FATAL_ERROR("wrong type of argument");
+    }
+    return (RawPair *)o;
+}
+
+RawString *StringArg(RawObject *o, const char *who) {
+    if (!o->IsString()) {
+        fprintf(stderr, "%s: not a string: ", who);
+        o->Write(stderr);
+        fprintf(stderr, "\n");
+        FATAL_ERROR("wrong type of argument");
+    }
+    return (RawString *)o;
+}
+
+RawVector *VectorArg(RawObject *o, const char *who) {
+    if (!o->IsVector()) {
+        fprintf(stderr, "%s: not a vector: ", who);
+        o->Write(stderr);
+        fprintf(stderr, "\n");
+        FATAL_ERROR("wrong type of argument");
+    }
+    return (RawVector *)o;
+}
+
+intptr_t IndexArg(RawVector *vec, RawObject *o, const char *who) {
+    intptr_t index = FixnumArg(o, who);
+    if (index < 0 || (size_t)index >= vec->length()) {
+        FATAL_ERROR("index out of range");
+    }
+    return index;
+}
+
+RawObject *Bool(bool b) {
+    return RawBoolean::Wrap(b);
+}
+
+bool Eqv(RawObject *lhs, RawObject *rhs) {
+    if (lhs->IsFlonum() && rhs->IsFlonum()) {
+        return lhs->Hash() == rhs->Hash();
+    }
+    return lhs == rhs;
+}
+
+bool Equal(RawObject *lhs, RawObject *rhs) {
+    if (Eqv(lhs, rhs)) {
+        return true;
+    }
+    else if (lhs->IsPair() && rhs->IsPair()) {
+        return Equal(((RawPair *)lhs)->car(), ((RawPair *)rhs)->car()) &&
+            Equal(((RawPair *)lhs)->cdr(), ((RawPair *)rhs)->cdr());
+    }
+    else if (lhs->IsVector() && rhs->IsVector()) {
+        RawVector *lvec = (RawVector *)lhs;
+        RawVector *rvec = (RawVector *)rhs;
+        if (lvec->length() != rvec->length()) {
+            return false;
+        }
+        for (size_t i = 0; i < lvec->length(); ++i) {
+            if (!Equal(lvec->At(i), rvec->At(i))) {
+                return false;
+            }
+        }
+        return true;
+    }
+    else if (lhs->IsString() && rhs->IsString()) {
+        return RawString::Equal((RawString *)lhs, (RawString *)rhs);
+    }
+    return false;
+}
+
+// Pairs
+
+RawObject *Cons(intptr_t argc, RawObject **argv) {
+    Handle car = argv[0];
+    Handle cdr = argv[1];
+    return RawPair::Wrap(car, cdr);
+}
+
+RawObject *Car(intptr_t argc, RawObject **argv) {
+    return PairArg(argv[0], "car")->car();
+}
+
+RawObject *Cdr(intptr_t argc, RawObject **argv) {
+    return PairArg(argv[0], "cdr")->cdr();
+}
+
+RawObject *SetCar(intptr_t argc, RawObject **argv) {
+    PairArg(argv[0], "set-car!")->set_car(argv[1]);
+    return RawNil::Wrap();
+}
+
+RawObject *SetCdr(intptr_t argc, RawObject **argv) {
+    PairArg(argv[0], "set-cdr!")->set_cdr(argv[1]);
+    return RawNil::Wrap();
+}
+
+RawObject *List(intptr_t argc, RawObject **argv) {
+    // argv may move, so copy the arguments out first.
+    std::vector<Handle> args(argv, argv + argc);
+    Handle result = RawNil::Wrap();
+    for (intptr_t i = argc - 1; i >= 0; --i) {
+        result = RawPair::Wrap(args[i], result);
+    }
+    return result.raw();
+}
+
+RawObject *Length(intptr_t argc, RawObject **argv) {
+    intptr_t length = 0;
+    RawObject *it = argv[0];
+    for (; it->IsPair(); it = ((RawPair *)it)->cdr()) {
+        ++length;
+    }
+    if (!it->IsNil()) {
+        FATAL_ERROR("length: not a proper list");
+    }
+    return RawFixnum::Wrap(length);
+}
+
+// Predicates
+
+RawObject *NullP(intptr_t argc, RawObject **argv) {
+    return Bool(argv[0]->IsNil());
+}
+
+RawObject *PairP(intptr_t argc, RawObject **argv) {
+    return Bool(argv[0]->IsPair());
+}
+
+RawObject *SymbolP(intptr_t argc, RawObject **argv) {
+    return Bool(argv[0]->IsSymbol());
+}
+
+RawObject *StringP(intptr_t argc, RawObject **argv) {
+    return Bool(argv[0]->IsString());
+}
+
+RawObject *ProcedureP(intptr_t argc, RawObject **argv) {
+    return Bool(argv[0]->IsClosure() || argv[0]->IsNative() ||
+                argv[0]->IsContinuation());
+}
+
+RawObject *EqP(intptr_t argc, RawObject **argv) {
+    return Bool(argv[0] == argv[1]);
+}
+
+RawObject *EqvP(intptr_t argc, RawObject **argv) {
+    return Bool(Eqv(argv[0], argv[1]));
+}
+
+RawObject *EqualP(intptr_t argc, RawObject **argv) {
+    return Bool(Equal(argv[0], argv[1]));
+}
+
+RawObject *Not(intptr_t argc, RawObject **argv) {
+    return Bool(!argv[0]->IsTrue());
+}
+
+intptr_t DivisorArg(RawObject *o, const char *who) {
+    intptr_t divisor = FixnumArg(o, who);
+    if (divisor == 0) {
+        FATAL_ERROR("division by zero");
+    }
+    return divisor;
+}
+
+RawObject *Quotient(intptr_t argc, RawObject **argv) {
+    intptr_t divisor = DivisorArg(argv[1], "quotient");
+    return RawFixnum::Wrap(FixnumArg(argv[0], "quotient") / divisor);
+}
+
+RawObject *Remainder(intptr_t argc, RawObject **argv) {
+    intptr_t divisor = DivisorArg(argv[1], "remainder");
+    return RawFixnum::Wrap(FixnumArg(argv[0], "remainder") % divisor);
+}
+
+RawObject *Modulo(intptr_t argc, RawObject **argv) {
+    intptr_t divisor = DivisorArg(argv[1], "modulo");
+    intptr_t result = FixnumArg(argv[0], "modulo") % divisor;
+    if (result != 0 && (result < 0) != (divisor < 0)) {
+        result += divisor;
+    }
+    return RawFixnum::Wrap(result);
+}
+
+RawObject *ZeroP(intptr_t argc, RawObject **argv) {
+    if (argv[0]->IsFlonum()) {
+        return Bool(FlonumArg(argv[0], "zero?") == 0);
+    }
+    return Bool(FixnumArg(argv[0], "zero?") == 0);
+}
+
+RawFixnum *CheckedFixnum(RawObject *o, const char *who) {
+    FixnumArg(o, who);
+    return (RawFixnum *)o;
+}
+
+enum Comparison {
+    kEq, kLt, kGt, kLe, kGe
+};
+
+bool CompareFlonums(Comparison cmp, double lhs, double rhs) {
+    switch (cmp) {
+        case kEq: return lhs == rhs;
+        case kLt: return lhs < rhs;
+        case kGt: return lhs > rhs;
+        case kLe: return lhs <= rhs;
+        default:  return lhs >= rhs;
+    }
+}
+
+RawObject *Compare(Comparison cmp, const char *who,
+                   intptr_t argc, RawObject **argv) {
+    for (intptr_t i = 0; i + 1 < argc; ++i) {
+        if (argv[i]->IsFlonum() || argv[i + 1]->IsFlonum()) {
+            if (!CompareFlonums(cmp, FlonumArg(argv[i], who),
+                                FlonumArg(argv[i + 1], who))) {
+                return Bool(false);
+            }
+            continue;
+        }
+        intptr_t lhs = FixnumArg(argv[i], who);
+        intptr_t rhs = FixnumArg(argv[i + 1], who);
+        bool ok;
+        switch (cmp) {
+            case kEq: ok = lhs == rhs; break;
+            case kLt: ok = lhs < rhs; break;
+            case kGt: ok = lhs > rhs; break;
+            case kLe: ok = lhs <= rhs; break;
+            default:  ok = lhs >= rhs; break;
+        }
+        if (!ok) {
+            return Bool(false);
+        }
+    }
+    return Bool(true);
+}
+
+}  // namespace
+
+// Fixnum arithmetic, which goes on with flonums from the first flonum
+// argument on, or from the first result that is too large to be a fixnum
+// on, as numbers that are too large to be read as fixnums are.
+
+RawObject *Add(intptr_t argc, RawObject **argv) {
+    RawFixnum *result = RawFixnum::Wrap(0);
+    intptr_t i = 0;
+    for (; i < argc && !argv[i]->IsFlonum(); ++i) {
+        if (!RawFixnum::Add(result, CheckedFixnum(argv[i], "+"), &result)) {
+            break;
+        }
+    }
+    if (i == argc) {
+        return result;
+    }
+    double sum = result->Unwrap();
+    for (; i < argc; ++i) {
+        sum += FlonumArg(argv[i], "+");
+    }
+    return RawFlonum::Wrap(sum);
+}
+
+RawObject *Sub(intptr_t argc, RawObject **argv) {
+    if (argc == 0) {
+        FATAL_ERROR("-: expects at least 1 argument");
+    }
+    if (argv[0]->IsFlonum() || (argc > 1 && argv[1]->IsFlonum())) {
+        double difference = FlonumArg(argv[0], "-");
+        if (argc == 1) {
+            return RawFlonum::Wrap(-difference);
+        }
+        for (intptr_t i = 1; i < argc; ++i) {
+            difference -= FlonumArg(argv[i], "-");
+        }
+        return RawFlonum::Wrap(difference);
+    }
+    RawFixnum *result = CheckedFixnum(argv[0], "-");
+    if (argc == 1) {
+        RawFixnum *negated;
+        if (!RawFixnum::Sub(RawFixnum::Wrap(0), result, &negated)) {
+            return RawFlonum::Wrap(-(double)result->Unwrap());
+        }
+        return negated;
+    }
+    intptr_t i = 1;
+    for (; i < argc && !argv[i]->IsFlonum(); ++i) {
+        if (!RawFixnum::Sub(result, CheckedFixnum(argv[i], "-"), &result)) {
+            break;
+        }
+    }
+    if (i == argc) {
+        return result;
+    }
+    double difference = result->Unwrap();
+    for (; i < argc; ++i) {
+        difference -= FlonumArg(argv[i], "-");
+    }
+    return RawFlonum::Wrap(difference);
+}
+
+RawObject *Mul(intptr_t argc, RawObject **argv) {
+    RawFixnum *result = RawFixnum::Wrap(1);
+    intptr_t i = 0;
+    for (; i < argc && !argv[i]->IsFlonum(); ++i) {
+        if (!RawFixnum::Mul(result, CheckedFixnum(argv[i], "*"), &result)) {
+            break;
+        }
+    }
+    if (i == argc) {
+        return result;
+    }
+    double product = result->Unwrap();
+    for (; i < argc; ++i) {
+        product *= FlonumArg(argv[i], "*");
+    }
+    return RawFlonum::Wrap(product);
+}
+
+// A fixnum if all the arguments are and it divides evenly, since there
+// are no rationals.
+RawObject *Div(intptr_t argc, RawObject **argv) {
+    if (argc == 0) {
+        FATAL_ERROR("/: expects at least 1 argument");
+    }
+    // (/ x) is (/ 1 x).
+    RawObject *dividend = argc == 1 ? RawFixnum::Wrap(1) : argv[0];
+    RawObject **divisors = argc == 1 ? argv : argv + 1;
+    intptr_t num_divisors = argc == 1 ? 1 : argc - 1;
+
+    if (dividend->IsFixnum()) {
+        intptr_t quotient = ((RawFixnum *)dividend)->Unwrap();
+        intptr_t i = 0;
+        for (; i < num_divisors && divisors[i]->IsFixnum(); ++i) {
+            intptr_t divisor = ((RawFixnum *)divisors[i])->Unwrap();
+            if (divisor == 0 || quotient % divisor != 0) {
+                break;
+            }
+            quotient /= divisor;
+        }
+        if (i == num_divisors) {
+            return RawFixnum::Wrap(quotient);
+        }
+    }
+    double quotient = FlonumArg(dividend, "/");
+    for (intptr_t i = 0; i < num_divisors; ++i) {
+        quotient /= FlonumArg(divisors[i], "/");
+    }
+    return RawFlonum::Wrap(quotient);
+}
+
+RawObject *NumEq(intptr_t argc, RawObject **argv) {
+    return Compare(kEq, "=", argc, argv);
+}
+
+RawObject *NumLt(intptr_t argc, RawObject **argv) {
+    return Compare(kLt, "<", argc, argv);
+}
+
+RawObject *NumGt(intptr_t argc, RawObject **argv) {
+    return Compare(kGt, ">", argc, argv);
+}
+
+RawObject *NumLe(intptr_t argc, RawObject **argv) {
+    return Compare(kLe, "<=", argc, argv);
+}
+
+RawObject *NumGe(intptr_t argc, RawObject **argv) {
+    return Compare(kGe, ">=", argc, argv);
+}
+
+namespace {
+
+// Vectors
+
+RawObject *MakeVector(intptr_t argc, RawObject **argv) {
+    if (argc != 1 && argc != 2) {
+        FATAL_ERROR("make-vector: expects 1 or 2 arguments");
+    }
+    intptr_t length = FixnumArg(argv[0], "make-vector");
+    if (length < 0) {
+        FATAL_ERROR("make-vector: negative length");
+    }
+    Handle fill = argc == 2 ? argv[1] : (RawObject *)RawNil::Wrap();
+    return RawVector::Wrap(length, fill);
+}
+
+RawObject *VectorRef(intptr_t argc, RawObject **argv) {
+    RawVector *vec = VectorArg(argv[0], "vector-ref");
+    return vec->At(IndexArg(vec, argv[1], "vector-ref"));
+}
+
+RawObject *VectorSet(intptr_t argc, RawObject **argv) {
+    RawVector *vec = VectorArg(argv[0], "vector-set!");
+    vec->Set(IndexArg(vec, argv[1], "vector-set!"), argv[2]);
+    return RawNil::Wrap();
+}
+
+RawObject *VectorLength(intptr_t argc, RawObject **argv) {
+    return RawFixnum::Wrap(VectorArg(argv[0], "vector-length")->length());
+}
+
+// Strings
+
+RawObject *StringLength(intptr_t argc, RawObject **argv) {
+    return RawFixnum::Wrap(StringArg(argv[0], "string-length")->length());
+}
+
+RawObject *Substring(intptr_t argc, RawObject **argv) {
+    intptr_t length = StringArg(argv[0], "substring")->length();
+    intptr_t start = FixnumArg(argv[1], "substring");
+    intptr_t end = FixnumArg(argv[2], "substring");
+    if (start < 0 || end < start || end > length) {
+        FATAL_ERROR("substring: index out of range");
+    }
+    Handle str = argv[0];
+    return RawString::Substring(str, start, end);
+}
+
+RawObject *StringAppend(intptr_t argc, RawObject **argv) {
+    for (intptr_t i = 0; i < argc; ++i) {
+        StringArg(argv[i], "string-append");
+    }
+    // argv may move, so copy the arguments out first.
+    std::vector<Handle> args(argv, argv + argc);
+    Handle result = RawString::Wrap("", 0);
+    for (intptr_t i = 0; i < argc; ++i) {
+        result = RawString::Append(result, args[i]);
+    }
+    return result.raw();
+}
+
+RawObject *StringEq(intptr_t argc, RawObject **argv) {
+    return Bool(RawString::Equal(StringArg(argv[0], "string=?"),
+                                 StringArg(argv[1], "string=?")));
+}
+
+RawObject *SymbolToString(intptr_t argc, RawObject **argv) {
+    if (!argv[0]->IsSymbol()) {
+        FATAL_ERROR("symbol->string: not a symbol");
+    }
+    // The name may move when the string is allocated.
+    RawSymbol *symbol = (RawSymbol *)argv[0];
+    std::string name(symbol->Unwrap(), symbol->length());
+    return RawString::Wrap(name.data(), name.size());
+}
+
+RawObject *StringToSymbol(intptr_t argc, RawObject **argv) {
+    // Interning may allocate, so the characters are copied out first.
+    RawString *str = StringArg(argv[0], "string->symbol");
+    std::vector<char> chars(str->length() + 1);
+    str->CopyTo(&chars[0]);
+    return ObjSpace::Get().InternSymbol(&chars[0], str->length());
+}
+
+// Output
+
+RawObject *Display(intptr_t argc, RawObject **argv) {
+    if (argv[0]->IsString()) {
+        ((RawString *)argv[0])->Display(stdout);
+    }
+    else {
+        argv[0]->Write(stdout);
+    }
+    return RawNil::Wrap();
+}
+
+RawObject *Write(intptr_t argc, RawObject **argv) {
+    argv[0]->Write(stdout);
+    return RawNil::Wrap();
+}
+
+RawObject *Newline(intptr_t argc, RawObject **argv) {
+    fprintf(stdout, "\n");
+    return RawNil::Wrap();
+}
+
+struct NativeEntry {
+    const char *name;
+    RawNative::Function fn;
+    intptr_t arity;
+};
+
+const NativeEntry kNatives[] = {
+    { "cons",           Cons,           2 },
+    { "car",            Car,            1 },
+    { "cdr",            Cdr,            1 },
+    { "set-car!",       SetCar,         2 },
+    { "set-cdr!",       SetCdr,         2 },
+    { "list",           List,           RawNative::kVariadic },
+    { "length",         Length,         1 },
+    { "null?",          NullP,          1 },
+    { "pair?",          PairP,          1 },
+    { "symbol?",        SymbolP,        1 },
+    { "string?",        StringP,        1 },
+    { "procedure?",     ProcedureP,     1 },
+    { "eq?",            EqP,            2 },
+    { "eqv?",           EqvP,           2 },
+    { "equal?",         EqualP,         2 },
+    { "not",            Not,            1 },
+    { "+",              Add,            RawNative::kVariadic },
+    { "-",              Sub,            RawNative::kVariadic },
+    { "*",              Mul,            RawNative::kVariadic },
+    { "/",              Div,            RawNative::kVariadic },
+    { "quotient",       Quotient,       2 },
+    { "remainder",      Remainder,      2 },
+    { "modulo",         Modulo,         2 },
+    { "=",              NumEq,          RawNative::kVariadic },
+    { "<",              NumLt,          RawNative::kVariadic },
+    { ">",              NumGt,          RawNative::kVariadic },
+    { "<=",             NumLe,          RawNative::kVariadic },
+    { ">=",             NumGe,          RawNative::kVariadic },
+    { "zero?",          ZeroP,          1 },
+    { "make-vector",    MakeVector,     RawNative::kVariadic },
+    { "vector-ref",     VectorRef,      2 },
+    { "vector-set!",    VectorSet,      3 },
+    { "vector-length",  VectorLength,   1 },
+    { "string-length",  StringLength,   1 },
+    { "substring",      Substring,      3 },
+    { "string-append",  StringAppend,   RawNative::kVariadic },
+    { "string=?",       StringEq,       2 },
+    { "symbol->string", SymbolToString, 1 },
+    { "string->symbol", StringToSymbol, 1 },
+    { "display",        Display,        1 },
+    { "write",          Write,          1 },
+    { "newline",        Newline,        0 },
+
+    // Tasks and continuations, the interpreter switches stacks once
+    // these return.
+    { "spawn",          Interp::Spawn,  1 },
+    { "yield",          Interp::Yield,  0 },
+    { "call/cc",        Interp::CallCC, 1 },
+    { "call-with-current-continuation", Interp::CallCC, 1 },
+
+    // Ports, which suspend the running task until they are ready.
+    { "tcp-listen",         vm_io::TcpListen,       1 },
+    { "tcp-accept",         vm_io::TcpAccept,       1 },
+    { "tcp-connect",        vm_io::TcpConnect,      2 },
+    { "read-line",          vm_io::ReadLine,        1 },
+    { "read-string",        vm_io::ReadString,      2 },
+    { "write-string",       vm_io::WriteString,     2 },
+    { "flush-output-port",  vm_io::FlushOutputPort, 1 },
+    { "close-port",         vm_io::ClosePort,       1 },
+    { "port?",              vm_io::PortP,           1 },
+    { "eof-object",         vm_io::EofObject,       0 },
+    { "eof-object?",        vm_io::EofObjectP,      1 },
+    { NULL,             NULL,           0 }
+};
+
+}  // namespace
+
+void Install() {
+    for (const NativeEntry *entry = kNatives; entry->name; ++entry) {
+        Handle symbol = ObjSpace::Get().InternSymbol(entry->name);
+        Handle native = RawNative::Wrap(entry->fn, entry->arity, entry->name);
+        ObjSpace::Get().LookupGlobal(symbol)->set_cdr(native.raw());
+    }
+}
+
+bool IsBuiltin(RawNative::Function fn, intptr_t arity, const char *name) {
+    for (const NativeEntry *entry = kNatives; entry->name; ++entry) {
+        if (entry->fn == fn && entry->arity == arity &&
+                entry->name == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace vm_prelude
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
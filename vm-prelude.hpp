@@ -0,0 +1,34 @@
+#ifndef VM_PRELUDE_HPP
+#define VM_PRELUDE_HPP
+#include "objectmodel.hpp"
+
+namespace sanya {
+
+namespace vm_prelude {
+
+/** @brief Define the builtin natives as global variables. */
+void Install();
+
+/**
+ * @brief Whether fn, arity and name are those of a builtin native, such
+ * as one that is restored from a snapshot (see snapshot.hpp).
+ */
+bool IsBuiltin(RawNative::Function fn, intptr_t arity, const char *name);
+
+// Also the slow paths of the arithmetic instructions.
+RawObject *Add(intptr_t argc, RawObject **argv);
+RawObject *Sub(intptr_t argc, RawObject **argv);
+RawObject *Mul(intptr_t argc, RawObject **argv);
+RawObject *NumEq(intptr_t argc, RawObject **argv);
+RawObject *NumLt(intptr_t argc, RawObject **argv);
+RawObject *NumGt(intptr_t argc, RawObject **argv);
+RawObject *NumLe(intptr_t argc, RawObject **argv);
+RawObject *NumGe(intptr_t argc, RawObject **argv);
+
+}  // namespace vm_prelude
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
+
+#endif /* VM_PRELUDE_HPP */
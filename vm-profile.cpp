@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include <sys/time.h>
+#include "vm-profile.hpp"
+#include "inlines.hpp"
+
+namespace sanya {
+
+namespace vm_profile {
+
+__thread volatile sig_atomic_t sample_pending = 0;
+
+namespace {
+
+// In words. A sample is its depth followed by the ids of its names.
+const size_t kRingSize = 1 << 16;
+const size_t kRingMask = kRingSize - 1;
+
+// How often the samples are counted, in nanoseconds.
+const long kDrainInterval = 10 * 1000 * 1000;
+
+uint32_t ring_s[kRingSize];
+size_t head_s = 0;      // Only moved by Record
+size_t tail_s = 0;      // Only moved by Drain
+
+// Only used by Record, until Stop.
+std::map<std::string, uint32_t> ids_s;
+std::vector<std::string> names_s;
+uint64_t dropped_s = 0;
+
+// Only used by the drain thread, until Stop.
+std::map<std::vector<uint32_t>, uint64_t> counts_s;
+
+bool running_s = false;
+bool stopping_s = false;
+pthread_t drainer_s;
+pthread_t sampled_s;    // Which called Start
+
+void HandleSignal(int) {
+    if (pthread_equal(pthread_self(), sampled_s)) {
+        sample_pending = 1;
+    }
+    else {
+        pthread_kill(sampled_s, SIGPROF);
+    }
+}
+
+uint32_t TextId(const std::string &text) {
+    std::map<std::string, uint32_t>::iterator it = ids_s.find(text);
+    if (it != ids_s.end()) {
+        return it->second;
+    }
+    names_s.push_back(text);
+    ids_s[text] = names_s.size() - 1;
+    return names_s.size() - 1;
+}
+
+uint32_t NameId(RawObject *name) {
+    if (!name->IsSymbol()) {
+        return TextId("?");
+    }
+    std::string text(((RawSymbol *)name)->Unwrap(),
+                     ((RawSymbol *)name)->length());
+    // Which would split the frame in the folded format.
+    std::replace(text.begin(), text.end(), ';', ':');
+    return TextId(text);
+}
+
+void Drain() {
+    size_t tail = tail_s;
+    size_t head = __atomic_load_n(&head_s, __ATOMIC_ACQUIRE);
+    while (tail != head) {
+        uint32_t depth = ring_s[tail & kRingMask];
+        std::vector<uint32_t> stack(depth);
+        for (uint32_t i = 0; i < depth; ++i) {
+            stack[i] = ring_s[(tail + 1 + i) & kRingMask];
+        }
+        ++counts_s[stack];
+        tail += depth + 1;
+    }
+    __atomic_store_n(&tail_s, tail, __ATOMIC_RELEASE);
+}
+
+void *RunDrainer(void *) {
+    while (!__atomic_load_n(&stopping_s, __ATOMIC_ACQUIRE)) {
+        Drain();
+        struct timespec interval = { 0, kDrainInterval };
+        nanosleep(&interval, NULL);
+    }
+    Drain();
+    return NULL;
+}
+
+}  // namespace
+
+bool Start(int hz) {
+    if (running_s || hz <= 0) {
+        return false;
+    }
+    stopping_s = false;
+    sampled_s = pthread_self();
+    if (pthread_create(&drainer_s, NULL, RunDrainer, NULL) != 0) {
+        return false;
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = HandleSignal;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGPROF, &action, NULL);
+
+    struct itimerval timer;
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = hz > 1000000 ? 1 : 1000000 / hz;
+    timer.it_value = timer.it_interval;
+    setitimer(ITIMER_PROF, &timer, NULL);
+    running_s = true;
+    return true;
+}
+
+void Stop() {
+    if (!running_s) {
+        return;
+    }
+    struct itimerval timer;
+    memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_PROF, &timer, NULL);
+    // A late SIGPROF would otherwise terminate the process.
+    signal(SIGPROF, SIG_IGN);
+    sample_pending = 0;
+
+    __atomic_store_n(&stopping_s, true, __ATOMIC_RELEASE);
+    pthread_join(drainer_s, NULL);
+    running_s = false;
+}
+
+void Record(RawObject *const *names, size_t count) {
+    sample_pending = 0;
+
+    // Deeper stacks keep their innermost frames.
+    uint32_t ids[kMaxDepth + 1];
+    size_t depth = 0;
+    size_t first = 0;
+    if (count > kMaxDepth) {
+        first = count - kMaxDepth;
+        ids[depth++] = TextId("...");
+    }
+    for (size_t i = first; i < count; ++i) {
+        ids[depth++] = NameId(names[i]);
+    }
+
+    size_t head = head_s;
+    size_t tail = __atomic_load_n(&tail_s, __ATOMIC_ACQUIRE);
+    if (kRingSize - (head - tail) < depth + 1) {
+        ++dropped_s;
+        return;
+    }
+    ring_s[head & kRingMask] = depth;
+    for (size_t i = 0; i < depth; ++i) {
+        ring_s[(head + 1 + i) & kRingMask] = ids[i];
+    }
+    __atomic_store_n(&head_s, head + depth + 1, __ATOMIC_RELEASE);
+}
+
+void Dump(FILE *stream) {
+    std::map<std::vector<uint32_t>, uint64_t>::const_iterator it;
+    for (it = counts_s.begin(); it != counts_s.end(); ++it) {
+        const std::vector<uint32_t> &stack = it->first;
+        for (size_t i = 0; i < stack.size(); ++i) {
+            fprintf(stream, "%s%s", i ? ";" : "", names_s[stack[i]].c_str());
+        }
+        fprintf(stream, " %llu\n", (unsigned long long)it->second);
+    }
+    // Samples that didn't fit in the ring buffer.
+    if (dropped_s) {
+        fprintf(stream, "[dropped] %llu\n", (unsigned long long)dropped_s);
+    }
+}
+
+}  // namespace vm_profile
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
@@ -0,0 +1,53 @@
+#ifndef VM_PROFILE_HPP
+#define VM_PROFILE_HPP
+#include <csignal>
+#include <cstdio>
+#include "objectmodel.hpp"
+
+namespace sanya {
+
+/**
+ * @brief A sampling profiler of Scheme procedures.
+ *
+ * SIGPROF only sets sample_pending, the interpreter checks it on calls
+ * and backward branches, where its frames are consistent, and records
+ * the names of the procedures on the stack. The samples go through a
+ * lock-free ring buffer to a thread that counts them, and Dump writes
+ * the counts as folded stacks, one "outer;...;inner count" per line,
+ * which is what flamegraph.pl reads.
+ *
+ * Only the thread that called Start, and so its isolate, is sampled:
+ * SIGPROF is sent on to it when another thread gets it.
+ *
+ * When the profiler is not running, the cost is a load and a branch per
+ * call.
+ */
+namespace vm_profile {
+
+extern __thread volatile sig_atomic_t sample_pending;
+
+/** @brief The innermost frames that are kept of deeper stacks. */
+const size_t kMaxDepth = 256;
+
+/** @brief Start sampling every 1/hz seconds of CPU time. */
+bool Start(int hz);
+
+/** @brief Stop sampling, the samples so far are kept for Dump. */
+void Stop();
+
+/**
+ * @brief Record one sample, the names of the procedures from the
+ * outermost one. Doesn't allocate on the heap.
+ */
+void Record(RawObject *const *names, size_t count);
+
+/** @brief Write the folded stacks, after Stop. */
+void Dump(FILE *stream);
+
+}  // namespace vm_profile
+
+}  // namespace sanya
+
+// vim: set ts=4 sw=4 sts=4:
+
+#endif /* VM_PROFILE_HPP */